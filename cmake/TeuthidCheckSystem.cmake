@@ -0,0 +1,30 @@
+include(CheckCXXSourceCompiles)
+
+# memory-mapped files (POSIX)
+check_cxx_source_compiles("
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+  int main() {
+    struct stat st_;
+    int fd_ = open(\"/\", O_RDONLY);
+    void *p_ = mmap(nullptr, 1, PROT_READ, MAP_PRIVATE, fd_, 0);
+    munmap(p_, 1);
+    return fstat(fd_, &st_) + close(fd_);
+  }" TEUTHID_HAVE_MMAP)
+
+# CPU features at run time (x86 CPUID and XGETBV)
+check_cxx_source_compiles("
+  #include <cpuid.h>
+  int main() {
+    unsigned a_, b_, c_, d_;
+    __asm__(\"xgetbv\" : \"=a\"(a_), \"=d\"(d_) : \"c\"(0));
+    return __get_cpuid_count(7, 0, &a_, &b_, &c_, &d_);
+  }" TEUTHID_HAVE_CPUID)
+
+# functions compiled for other instruction sets than the rest of the library
+check_cxx_source_compiles("
+  __attribute__((target(\"avx2,fma\"))) int f_(int x_) { return x_; }
+  __attribute__((target(\"avx512f,avx512dq\"))) int g_(int x_) { return x_; }
+  int main() { return f_(0) + g_(0); }" TEUTHID_HAVE_FUNCTION_TARGETS)
@@ -1,5 +1,6 @@
 
 include(CheckTypeSize)
+include(CheckCXXSourceCompiles)
 
 # integer types
 check_type_size("int8_t" int8_t LANGUAGE CXX)
@@ -81,11 +82,22 @@ elseif ("${double_t}" STREQUAL "10")
   set(float80_native "double")
 endif()
 
-if ("${long_double_t}" STREQUAL "8")
+# sizeof(long double) includes padding (x86-64 stores the 80-bit extended
+# format in 16 bytes), so long double is classified by its mantissa digits
+macro(check_long_double_digits digits_ result_)
+  check_cxx_source_compiles("
+    #include <limits>
+    static_assert(std::numeric_limits<long double>::digits == ${digits_}, \"\");
+    int main() { return 0; }" ${result_})
+endmacro()
+check_long_double_digits(53 long_double_is_float64_)
+check_long_double_digits(64 long_double_is_float80_)
+check_long_double_digits(113 long_double_is_float128_)
+if (long_double_is_float64_)
   set(float64_native "long double")
-elseif ("${long_double_t}" STREQUAL "10")
+elseif (long_double_is_float80_)
   set(float80_native "long double")
-elseif ("${long_double_t}" STREQUAL "16")
+elseif (long_double_is_float128_)
   set(float128_native "long double")
 endif()
 
@@ -97,10 +109,32 @@ if ("${float80_native}" STREQUAL "")
   endif()
 endif()
 
+# __float128 is used only together with libquadmath, which provides
+# the math functions and string conversions for this type
+set(TEUTHID_HAVE_QUADMATH OFF)
+set(QUADMATH_LIBRARIES "")
 if ("${float128_native}" STREQUAL "")
   check_type_size("__float128" __float128_t LANGUAGE CXX)
   if ("${__float128_t}" STREQUAL "16")
-    set(float128_native "__float128")
+    find_library(QUADMATH_LIBRARY NAMES quadmath libquadmath
+      HINTS ${CMAKE_CXX_IMPLICIT_LINK_DIRECTORIES})
+    if (NOT QUADMATH_LIBRARY)
+      set(QUADMATH_LIBRARY quadmath)
+    endif()
+    set(CMAKE_REQUIRED_LIBRARIES ${QUADMATH_LIBRARY})
+    check_cxx_source_compiles("
+      #include <quadmath.h>
+      int main() {
+        char buf_[64];
+        __float128 x_ = sqrtq(strtoflt128(\"2\", nullptr));
+        return quadmath_snprintf(buf_, sizeof(buf_), \"%.36Qg\", x_) < 0;
+      }" quadmath_works_)
+    unset(CMAKE_REQUIRED_LIBRARIES)
+    if (quadmath_works_)
+      set(TEUTHID_HAVE_QUADMATH ON)
+      set(QUADMATH_LIBRARIES ${QUADMATH_LIBRARY})
+      set(float128_native "__float128")
+    endif()
   endif()
 endif()
 
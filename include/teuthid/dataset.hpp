@@ -0,0 +1,171 @@
+/*
+  This file is part of the Teuthid project.
+  Copyright (c) 2016-2017 Mariusz Przygodzki (mariusz.przygodzki@gmail.com)
+
+  The Teuthid is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or (at your
+  option) any later version.
+
+  The Teuthid is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+  FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+  for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with the Teuthid; see the file LICENSE.LGPLv3.  If not, see
+  <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef TEUTHID_DATASET_HPP
+#define TEUTHID_DATASET_HPP
+
+#include <chrono>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <teuthid/floatmp_vector.hpp>
+#include <teuthid/mapped_file.hpp>
+#include <teuthid/system.hpp>
+
+namespace teuthid {
+
+struct dataset_format {
+  char delimiter = ',';
+  bool header = false;
+  unsigned threads = 0; // all the cores
+};
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+template <typename T> struct dataset_column { typedef std::vector<T> type; };
+template <std::size_t P, typename R> struct dataset_column<floatmp<P, R>> {
+  typedef floatmp_vector<P, R> type;
+};
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+class dataset_base {
+public:
+  dataset_base(const dataset_base &) = delete;
+  dataset_base &operator=(const dataset_base &) = delete;
+
+  std::size_t rows() const noexcept { return rows_; }
+  std::size_t columns() const noexcept { return columns_; }
+  const std::vector<std::string> &names() const noexcept { return names_; }
+  std::size_t bytes() const noexcept { return file_.size(); }
+  double seconds() const noexcept { return seconds_; }
+  double megabytes_per_second() const noexcept {
+    return (seconds_ > 0) ? (file_.size() / 1e6 / seconds_) : 0;
+  }
+
+protected:
+  dataset_base(const std::string &path, const dataset_format &format);
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+  // parses the lines of a chunk; the first line is the given row
+  typedef std::function<void(const char *first, const char *last,
+                             std::size_t row)>
+      chunk_parser_;
+  void parse_(const chunk_parser_ &parse);
+
+  // the next non-empty line (without "\r\n") or false at the end
+  static bool next_line_(const char *&p, const char *last,
+                         const char *&line_first, const char *&line_last) {
+    while (p < last) {
+      const char *__eol =
+          static_cast<const char *>(std::memchr(p, '\n', last - p));
+      if (!__eol)
+        __eol = last;
+      line_first = p;
+      line_last = __eol;
+      p = __eol + 1;
+      if ((line_last > line_first) && (line_last[-1] == '\r'))
+        --line_last;
+      if (line_last > line_first)
+        return true;
+    }
+    return false;
+  }
+  // the field at p without the surrounding spaces; p is moved past the
+  // delimiter, which is reported by the result, or to last
+  bool next_field_(const char *&p, const char *last, const char *&field_first,
+                   const char *&field_last) const noexcept;
+  [[noreturn]] static void invalid_value_(std::size_t row,
+                                          std::size_t column);
+
+  char delimiter_;
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+private:
+  std::chrono::steady_clock::time_point start_;
+  mapped_file file_;
+  unsigned threads_;
+  std::size_t rows_;
+  std::size_t columns_;
+  std::vector<std::string> names_;
+  std::vector<const char *> chunks_; // the bounds of line-aligned chunks
+  std::vector<std::size_t> chunk_rows_;
+  double seconds_;
+
+  void split_(const char *first, const char *last);
+  void run_(const std::function<void(std::size_t)> &task);
+}; // class dataset_base
+
+template <typename T> class dataset : public dataset_base {
+  // the rows are parsed in parallel, and std::vector<bool> packs the values
+  // of neighbouring rows into the same word
+  static_assert(!std::is_same<T, bool>::value,
+                "dataset<bool> is not supported; use dataset<uint8_t>");
+
+public:
+  typedef T value_type;
+  typedef typename dataset_column<T>::type column_type;
+
+  explicit dataset(const std::string &path,
+                   const dataset_format &format = dataset_format());
+
+  const column_type &column(std::size_t j) const { return data_.at(j); }
+  const column_type &operator[](std::size_t j) const noexcept {
+    return data_[j];
+  }
+
+private:
+  std::vector<column_type> data_;
+
+  static void set_(std::vector<T> &c, std::size_t i, const T &x) { c[i] = x; }
+  template <std::size_t P, typename R>
+  static void set_(floatmp_vector<P, R> &c, std::size_t i, const T &x) {
+    c.set(i, x);
+  }
+}; // class dataset
+
+template <typename T>
+dataset<T>::dataset(const std::string &path, const dataset_format &format)
+    : dataset_base(path, format),
+      data_(columns(), column_type(rows())) {
+  // the workers round as the calling thread
+  floatmp_round_t __rounding = floatmp_base::rounding_mode();
+  parse_([this, __rounding](const char *first, const char *last,
+                            std::size_t row) {
+    floatmp_base::rounding_scope __scope(__rounding);
+    const char *__line_first, *__line_last, *__field_first, *__field_last;
+    T __x;
+    for (; next_line_(first, last, __line_first, __line_last); ++row)
+      for (std::size_t __j = 0; __j < columns(); ++__j) {
+        bool __more = next_field_(__line_first, __line_last, __field_first,
+                                  __field_last);
+        system::from_chars_result __r =
+            system::from_chars(__field_first, __field_last, __x);
+        if ((__r.ec != std::errc()) || (__r.ptr != __field_last) ||
+            (__more != (__j + 1 < columns())))
+          invalid_value_(row, __j);
+        set_(data_[__j], row, __x);
+      }
+  });
+}
+
+} // namespace teuthid
+
+#endif // TEUTHID_DATASET_HPP
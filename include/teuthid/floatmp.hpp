@@ -23,17 +23,25 @@
 #include <algorithm>
 #include <atomic>
 #include <cassert>
+#include <climits>
 #include <cmath>
 #include <limits>
 
 #include <mpfr.h>
 #include <teuthid/config.hpp>
+#include <teuthid/floatmp_arena.hpp>
+#ifdef TEUTHID_HAVE_QUADMATH
+#include <quadmath.h>
+#endif
 
 // forward declarations:
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
 namespace teuthid {
 class system;
-template <std::size_t Precision> class floatmp;
+template <std::size_t Precision, typename Policy> class floatmp;
+template <typename E> class floatmp_expr;
+template <typename T, typename Enable = void> struct floatmp_expr_scalar_traits;
+template <std::size_t Terms> class floatmp_expansion;
 }
 #endif // DOXYGEN_SHOULD_SKIP_THIS
 
@@ -48,6 +56,14 @@ enum class floatmp_round_t : int {
   round_to_nearest_away_from_zero = MPFR_RNDNA
 };
 
+enum class floatmp_comparison_t : int { exact = 0, ulps = 1, decimals = 2 };
+
+enum class floatmp_check_t : int {
+  checked = 0,
+  unchecked = 1,
+  propagate_nan = 2
+};
+
 #define TEUTHID_ASSERT_FLOATMP_PRECISION(PRECISION)                            \
   assert(PRECISION >= floatmp_base::min_precision());                          \
   assert(PRECISION <= floatmp_base::max_precision());
@@ -58,36 +74,101 @@ enum class floatmp_round_t : int {
   static_assert((PRECISION <= floatmp_base::max_precision()),                  \
                 "Too high floatmp precision.");
 
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+// the number of limbs of a significand with the given precision
+constexpr std::size_t floatmp_limbs(std::size_t precision) noexcept {
+  return (precision + GMP_NUMB_BITS - 1) / GMP_NUMB_BITS;
+}
+
+// limbs of floatmp<P, R> kept inside the object (MPFR custom interface), so
+// that values up to TEUTHID_FLOATMP_MAX_INLINE_PRECISION bits need no heap
+template <std::size_t Precision,
+          bool Inline = (Precision <= TEUTHID_FLOATMP_MAX_INLINE_PRECISION)>
+class floatmp_storage {
+protected:
+  mp_limb_t *limbs_() noexcept { return limbs_data_; }
+
+private:
+  mp_limb_t limbs_data_[floatmp_limbs(Precision)];
+};
+template <std::size_t Precision> class floatmp_storage<Precision, false> {
+protected:
+  mp_limb_t *limbs_() noexcept { return nullptr; }
+};
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+class floatmp_scratch_pool {
+public:
+  class lease {
+  public:
+    explicit lease(std::size_t precision)
+        : value_(floatmp_scratch_pool::acquire_(precision)) {}
+    lease(const lease &) = delete;
+    lease &operator=(const lease &) = delete;
+    ~lease() { floatmp_scratch_pool::release_(value_); }
+    operator mpfr_ptr() noexcept { return value_; }
+    mpfr_srcptr c_mpfr() const noexcept { return value_; }
+
+  private:
+    mpfr_ptr value_;
+  };
+
+  floatmp_scratch_pool() = delete;
+  static std::size_t size() noexcept;
+  static void clear() noexcept;
+
+private:
+  static mpfr_ptr acquire_(std::size_t precision);
+  static void release_(mpfr_ptr x) noexcept;
+}; // class floatmp_scratch_pool
+
 class floatmp_base {
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
   friend class system;
-  template <std::size_t Precision> friend class floatmp;
+  template <std::size_t Precision, typename Policy> friend class floatmp;
+  template <typename E> friend class floatmp_expr;
+  template <std::size_t Terms> friend class floatmp_expansion;
+  template <typename T, typename Enable>
+  friend struct floatmp_expr_scalar_traits;
+
+  // the comparison mode and tolerance are set together
+  struct comparison_rule_ {
+    floatmp_comparison_t mode;
+    std::size_t tolerance;
+  };
 #endif // DOXYGEN_SHOULD_SKIP_THIS
 
 public:
-  explicit floatmp_base(std::size_t precision) {
+  explicit floatmp_base(std::size_t precision, mp_limb_t *limbs = nullptr) {
     TEUTHID_ASSERT_FLOATMP_PRECISION(precision);
-    mpfr_init2(value_, precision);
+    init_(precision, limbs);
     mpfr_set_zero(value_, 1);
   }
-  floatmp_base(std::size_t precision, const floatmp_base &x) {
+  floatmp_base(std::size_t precision, const floatmp_base &x,
+               mp_limb_t *limbs = nullptr, mpfr_rnd_t rnd = mpfr_rnd_()) {
     TEUTHID_ASSERT_FLOATMP_PRECISION(precision);
-    mpfr_init2(value_, precision);
-    mpfr_set(value_, x.c_mpfr(), mpfr_rnd_());
+    init_(precision, limbs);
+    mpfr_set(value_, x.c_mpfr(), rnd);
   }
-  template <typename T> floatmp_base(std::size_t precision, const T &x) {
+  template <typename T>
+  floatmp_base(std::size_t precision, const T &x, mp_limb_t *limbs = nullptr,
+               mpfr_rnd_t rnd = mpfr_rnd_()) {
     TETHID_CHECK_TYPE_SPECIALIZATION(T);
   }
-  virtual ~floatmp_base() { mpfr_clear(value_); }
+  virtual ~floatmp_base() {
+    if (!inline_limbs_ && !moved_from_())
+      mpfr_clear(value_);
+  }
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
   floatmp_base &operator=(const floatmp_base &) = delete;
   floatmp_base &operator=(floatmp_base &&) = delete;
 
 #define __TEUTHID_FLOATMP_CTOR_SPEC(TYPE, FUN)                                 \
-  floatmp_base(std::size_t precision, const TYPE &x) {                         \
+  floatmp_base(std::size_t precision, const TYPE &x,                           \
+               mp_limb_t *limbs = nullptr, mpfr_rnd_t rnd = mpfr_rnd_()) {     \
     TEUTHID_ASSERT_FLOATMP_PRECISION(precision);                               \
-    mpfr_init2(value_, precision);                                             \
-    FUN(value_, x, mpfr_rnd_());                                               \
+    init_(precision, limbs);                                                   \
+    FUN(value_, x, rnd);                                                       \
   }
   __TEUTHID_FLOATMP_CTOR_SPEC(int8_t, mpfr_set_sj)
   __TEUTHID_FLOATMP_CTOR_SPEC(int16_t, mpfr_set_sj)
@@ -101,7 +182,17 @@ public:
   __TEUTHID_FLOATMP_CTOR_SPEC(double, mpfr_set_d)
   __TEUTHID_FLOATMP_CTOR_SPEC(long double, mpfr_set_ld)
   __TEUTHID_FLOATMP_CTOR_SPEC(mpfr_t, mpfr_set)
+#ifdef TEUTHID_HAVE_QUADMATH
+  __TEUTHID_FLOATMP_CTOR_SPEC(__float128, float128_to_mpfr_)
+#endif
 #undef __TEUTHID_FLOATMP_CTOR_SPEC
+  template <std::size_t N>
+  floatmp_base(std::size_t precision, const floatmp_expansion<N> &x,
+               mp_limb_t *limbs = nullptr, mpfr_rnd_t rnd = mpfr_rnd_()) {
+    TEUTHID_ASSERT_FLOATMP_PRECISION(precision);
+    init_(precision, limbs);
+    x.get_(value_, rnd);
+  }
 #endif // DOXYGEN_SHOULD_SKIP_THIS
 
   explicit operator float() const { return mpfr_get_flt(value_, mpfr_rnd_()); }
@@ -109,14 +200,19 @@ public:
   explicit operator long double() const {
     return mpfr_get_ld(value_, mpfr_rnd_());
   }
+#ifdef TEUTHID_HAVE_QUADMATH
+  explicit operator __float128() const {
+    return mpfr_to_float128_(value_, mpfr_rnd_());
+  }
+#endif
 
   const mpfr_t &c_mpfr() const noexcept { return value_; }
   bool is_finite() const { return (mpfr_number_p(value_) != 0); }
   bool is_infinite() const { return (mpfr_inf_p(value_) != 0); }
   bool is_nan() const { return (mpfr_nan_p(value_) != 0); }
-  bool is_zero() const { return equal_to(zero_); }
-  bool is_negative() const { return less_than(zero_); }
-  bool is_positive() const { return !is_zero() && !is_negative(); }
+  bool is_zero() const { return (mpfr_zero_p(value_) != 0); }
+  bool is_negative() const { return (mpfr_sgn(value_) < 0); }
+  bool is_positive() const { return (mpfr_sgn(value_) > 0); }
   bool is_integer() const;
 
   static constexpr std::size_t max_precision() noexcept {
@@ -126,129 +222,397 @@ public:
     return std::max<std::size_t>(TEUTHID_FLOATMP_MIN_PRECISION, MPFR_PREC_MIN);
   }
   static floatmp_round_t rounding_mode() noexcept {
-    return static_cast<floatmp_round_t>(round_mode_.load());
+    return static_cast<floatmp_round_t>(round_mode_);
   }
   static floatmp_round_t rounding_mode(floatmp_round_t mode) noexcept {
-    return static_cast<floatmp_round_t>(
-        round_mode_.exchange(static_cast<int>(mode)));
+    floatmp_round_t __prev = static_cast<floatmp_round_t>(round_mode_);
+    round_mode_ = static_cast<mpfr_rnd_t>(mode);
+    return __prev;
   }
+  static floatmp_comparison_t comparison_mode() noexcept {
+    return comparison_.mode;
+  }
+  static floatmp_comparison_t
+  comparison_mode(floatmp_comparison_t mode,
+                  std::size_t tolerance = 0) noexcept {
+    floatmp_comparison_t __prev = comparison_.mode;
+    comparison_ = {mode, tolerance};
+    return __prev;
+  }
+  static std::size_t comparison_tolerance() noexcept {
+    return comparison_.tolerance;
+  }
+
+  class rounding_scope {
+  public:
+    explicit rounding_scope(floatmp_round_t mode) noexcept
+        : previous_(rounding_mode(mode)) {}
+    rounding_scope(const rounding_scope &) = delete;
+    rounding_scope &operator=(const rounding_scope &) = delete;
+    ~rounding_scope() { rounding_mode(previous_); }
+    floatmp_round_t previous() const noexcept { return previous_; }
+
+  private:
+    floatmp_round_t previous_;
+  }; // class rounding_scope
+
+  class comparison_scope {
+  public:
+    explicit comparison_scope(floatmp_comparison_t mode,
+                              std::size_t tolerance = 0) noexcept
+        : previous_(comparison_) {
+      comparison_mode(mode, tolerance);
+    }
+    comparison_scope(const comparison_scope &) = delete;
+    comparison_scope &operator=(const comparison_scope &) = delete;
+    ~comparison_scope() { comparison_ = previous_; }
+    floatmp_comparison_t previous() const noexcept { return previous_.mode; }
+    std::size_t previous_tolerance() const noexcept {
+      return previous_.tolerance;
+    }
+
+  private:
+    comparison_rule_ previous_;
+  }; // class comparison_scope
 
 private:
-  floatmp_base() { mpfr_init2(value_, mpfr_get_default_prec()); }
+  floatmp_base() { init_(mpfr_get_default_prec(), nullptr); }
   floatmp_base(const floatmp_base &x) {
-    mpfr_init2(value_, mpfr_get_prec(x.c_mpfr()));
+    init_(mpfr_get_prec(x.c_mpfr()), nullptr);
     mpfr_set(value_, x.c_mpfr(), mpfr_rnd_());
   }
-  floatmp_base(floatmp_base &&x) {
-    mpfr_init2(value_, mpfr_get_prec(x.c_mpfr()));
-    mpfr_swap(value_, x.value_);
+  floatmp_base(floatmp_base &&x) noexcept
+      : floatmp_base(std::move(x), nullptr) {}
+  floatmp_base(floatmp_base &&x, mp_limb_t *limbs) noexcept {
+    if (limbs || x.inline_limbs_) {
+      init_(mpfr_get_prec(x.value_), limbs);
+      mpfr_set(value_, x.value_, MPFR_RNDN); // exact
+    } else { // takes over the limbs of x
+      inline_limbs_ = false;
+      value_[0] = x.value_[0];
+      x.value_->_mpfr_d = nullptr;
+    }
   }
 
-  template <typename T> void assign(const T &x) {
+  void init_(std::size_t precision, mp_limb_t *limbs) {
+    inline_limbs_ = (limbs != nullptr);
+    if (inline_limbs_) {
+      mpfr_custom_init(limbs, precision);
+      mpfr_custom_init_set(value_, MPFR_ZERO_KIND, 0, precision, limbs);
+    } else
+      mpfr_init2(value_, precision);
+  }
+  // a moved-from value has no limbs until it is assigned to again
+  bool moved_from_() const noexcept { return (value_->_mpfr_d == nullptr); }
+  void reinit_() {
+    if (moved_from_())
+      mpfr_init2(value_, mpfr_get_prec(value_));
+  }
+  // exchanges the values of the same precision
+  void swap_(floatmp_base &x) noexcept {
+    assert(mpfr_get_prec(value_) == mpfr_get_prec(x.value_));
+    if (inline_limbs_ || x.inline_limbs_) {
+      mp_limb_t *__d = value_->_mpfr_d, *__xd = x.value_->_mpfr_d;
+      std::swap_ranges(__d, __d + floatmp_limbs(mpfr_get_prec(value_)), __xd);
+      mpfr_swap(value_, x.value_);
+      std::swap(value_->_mpfr_d, x.value_->_mpfr_d);
+    } else
+      mpfr_swap(value_, x.value_);
+  }
+
+  template <typename T> void assign(const T &x, mpfr_rnd_t rnd = mpfr_rnd_()) {
     TETHID_CHECK_TYPE_SPECIALIZATION(T);
   }
-  template <typename T> void add(const T &x) {
+  template <typename T> void add(const T &x, mpfr_rnd_t rnd = mpfr_rnd_()) {
     TETHID_CHECK_TYPE_SPECIALIZATION(T);
   }
-  template <typename T> void sub(const T &x) {
+  template <typename T> void sub(const T &x, mpfr_rnd_t rnd = mpfr_rnd_()) {
     TETHID_CHECK_TYPE_SPECIALIZATION(T);
   }
-  template <typename T> void mul(const T &x) {
+  template <typename T> void mul(const T &x, mpfr_rnd_t rnd = mpfr_rnd_()) {
     TETHID_CHECK_TYPE_SPECIALIZATION(T);
   }
-  template <typename T> void div(const T &x) {
+  template <typename T> void div(const T &x, mpfr_rnd_t rnd = mpfr_rnd_()) {
     TETHID_CHECK_TYPE_SPECIALIZATION(T);
   }
-  bool equal_to(const floatmp_base &x) const;
-  bool less_than(const floatmp_base &x) const;
-  void abs(const floatmp_base &x) { mpfr_abs(value_, x.c_mpfr(), mpfr_rnd_()); }
-  void fmod(const floatmp_base &x, const floatmp_base &y);
-  void remainder(const floatmp_base &x, const floatmp_base &y);
+  bool equal_to(const floatmp_base &x) const {
+    if (comparison_.mode == floatmp_comparison_t::exact)
+      return (mpfr_equal_p(value_, x.value_) != 0);
+    return equal_to(x, comparison_mode(), comparison_tolerance());
+  }
+  bool less_than(const floatmp_base &x) const {
+    if (comparison_.mode == floatmp_comparison_t::exact)
+      return (mpfr_less_p(value_, x.value_) != 0);
+    return (mpfr_less_p(value_, x.value_) != 0) &&
+           !equal_to(x, comparison_mode(), comparison_tolerance());
+  }
+  bool equal_to(const floatmp_base &x, floatmp_comparison_t mode,
+                std::size_t tolerance) const;
+
+  // exact comparisons with built-in values (and mpfr_t) without conversions;
+  // cmp_() is meaningful only if neither value is NaN
+  template <typename T> static bool is_nan_(const T &) noexcept {
+    return false;
+  }
+  static bool is_nan_(const float &x) noexcept { return std::isnan(x); }
+  static bool is_nan_(const double &x) noexcept { return std::isnan(x); }
+  static bool is_nan_(const long double &x) noexcept { return std::isnan(x); }
+  static bool is_nan_(const mpfr_t &x) noexcept { return (mpfr_nan_p(x) != 0); }
+  template <std::size_t N>
+  static bool is_nan_(const floatmp_expansion<N> &x) noexcept {
+    return x.is_nan();
+  }
+#ifdef TEUTHID_HAVE_QUADMATH
+  static bool is_nan_(const __float128 &x) noexcept { return (x != x); }
+#endif
+  template <typename T> int cmp_(const T &) const = delete;
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+#define __TEUTHID_FLOATMP_CMP_SPEC(TYPE, FUN)                                  \
+  int cmp_(const TYPE &x) const { return FUN(value_, x); }
+  __TEUTHID_FLOATMP_CMP_SPEC(int8_t, mpfr_cmp_si)
+  __TEUTHID_FLOATMP_CMP_SPEC(int16_t, mpfr_cmp_si)
+  __TEUTHID_FLOATMP_CMP_SPEC(int32_t, mpfr_cmp_si)
+  __TEUTHID_FLOATMP_CMP_SPEC(uint8_t, mpfr_cmp_ui)
+  __TEUTHID_FLOATMP_CMP_SPEC(uint16_t, mpfr_cmp_ui)
+  __TEUTHID_FLOATMP_CMP_SPEC(uint32_t, mpfr_cmp_ui)
+  __TEUTHID_FLOATMP_CMP_SPEC(float, mpfr_cmp_d)
+  __TEUTHID_FLOATMP_CMP_SPEC(double, mpfr_cmp_d)
+  __TEUTHID_FLOATMP_CMP_SPEC(mpfr_t, mpfr_cmp)
+#undef __TEUTHID_FLOATMP_CMP_SPEC
+  int cmp_(const long double &x) const {
+    // mpfr_cmp_ld() allocates its temporary on the heap
+    MPFR_DECL_INIT(__x, std::numeric_limits<long double>::digits);
+    mpfr_set_ld(__x, x, MPFR_RNDN); // exact
+    return mpfr_cmp(value_, __x);
+  }
+#ifdef TEUTHID_HAVE_QUADMATH
+  int cmp_(const __float128 &x) const {
+    MPFR_DECL_INIT(__x, float128_digits_);
+    float128_to_mpfr_(__x, x, MPFR_RNDN); // exact
+    return mpfr_cmp(value_, __x);
+  }
+#endif
+  template <std::size_t N> int cmp_(const floatmp_expansion<N> &x) const {
+    MPFR_DECL_INIT(__x, floatmp_expansion<N>::exact_precision_);
+    x.get_(__x, MPFR_RNDN); // exact
+    return mpfr_cmp(value_, __x);
+  }
+  int cmp_(const int64_t &x) const {
+    if ((x >= LONG_MIN) && (x <= LONG_MAX))
+      return mpfr_cmp_si(value_, static_cast<long>(x));
+    MPFR_DECL_INIT(__x, 64);
+    mpfr_set_sj(__x, x, MPFR_RNDN);
+    return mpfr_cmp(value_, __x);
+  }
+  int cmp_(const uint64_t &x) const {
+    if (x <= ULONG_MAX)
+      return mpfr_cmp_ui(value_, static_cast<unsigned long>(x));
+    MPFR_DECL_INIT(__x, 64);
+    mpfr_set_uj(__x, x, MPFR_RNDN);
+    return mpfr_cmp(value_, __x);
+  }
+#ifdef TEUTHID_HAVE_INT_128
+  int cmp_(const int128_t &x) const {
+    if ((x >= INT64_MIN) && (x <= INT64_MAX))
+      return cmp_(static_cast<int64_t>(x));
+    return mpfr_cmp(value_, int128_value_(x));
+  }
+  int cmp_(const uint128_t &x) const {
+    if (x <= UINT64_MAX)
+      return cmp_(static_cast<uint64_t>(x));
+    return mpfr_cmp(value_, int128_value_(x));
+  }
+#endif // TEUTHID_HAVE_INT_128
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+  template <typename T> bool equal_to_(const T &x) const {
+    return !is_nan() && !is_nan_(x) && (cmp_(x) == 0);
+  }
+  template <typename T> bool less_than_(const T &x) const {
+    return !is_nan() && !is_nan_(x) && (cmp_(x) < 0);
+  }
+  template <typename T> bool greater_than_(const T &x) const {
+    return !is_nan() && !is_nan_(x) && (cmp_(x) > 0);
+  }
+  void abs(const floatmp_base &x, mpfr_rnd_t rnd = mpfr_rnd_()) {
+    mpfr_abs(value_, x.c_mpfr(), rnd);
+  }
+  void fmod(const floatmp_base &x, const floatmp_base &y,
+            mpfr_rnd_t rnd = mpfr_rnd_(),
+            floatmp_check_t check = floatmp_check_t::checked);
+  void remainder(const floatmp_base &x, const floatmp_base &y,
+                 mpfr_rnd_t rnd = mpfr_rnd_(),
+                 floatmp_check_t check = floatmp_check_t::checked);
   void fma(const floatmp_base &x, const floatmp_base &y,
-           const floatmp_base &z) {
-    mpfr_fma(value_, x.c_mpfr(), y.c_mpfr(), z.c_mpfr(), mpfr_rnd_());
-  }
-  void fmax(const floatmp_base &x, const floatmp_base &y);
-  void fmin(const floatmp_base &x, const floatmp_base &y);
-  void fdim(const floatmp_base &x, const floatmp_base &y) {
-    mpfr_dim(value_, x.c_mpfr(), y.c_mpfr(), mpfr_rnd_());
-  }
-  void exp(const floatmp_base &x) { mpfr_exp(value_, x.c_mpfr(), mpfr_rnd_()); }
-  void exp2(const floatmp_base &x) {
-    mpfr_exp2(value_, x.c_mpfr(), mpfr_rnd_());
-  }
-  void expm1(const floatmp_base &x) {
-    mpfr_expm1(value_, x.c_mpfr(), mpfr_rnd_());
-  }
-  void log(const floatmp_base &x);
-  void log10(const floatmp_base &x);
-  void log2(const floatmp_base &x);
-  void log1p(const floatmp_base &x);
-  void pow(const floatmp_base &x, const floatmp_base &y);
-  void sqrt(const floatmp_base &x);
-  void cbrt(const floatmp_base &x) {
-    mpfr_cbrt(value_, x.c_mpfr(), mpfr_rnd_());
-  }
-  void hypot(const floatmp_base &x, const floatmp_base &y) {
-    mpfr_hypot(value_, x.c_mpfr(), y.c_mpfr(), mpfr_rnd_());
-  }
-  void sin(const floatmp_base &x) { mpfr_sin(value_, x.c_mpfr(), mpfr_rnd_()); }
-  void cos(const floatmp_base &x) { mpfr_cos(value_, x.c_mpfr(), mpfr_rnd_()); }
-  void tan(const floatmp_base &x) { mpfr_tan(value_, x.c_mpfr(), mpfr_rnd_()); }
-  void asin(const floatmp_base &x);
-  void acos(const floatmp_base &x);
-  void atan(const floatmp_base &x) {
-    mpfr_atan(value_, x.c_mpfr(), mpfr_rnd_());
-  }
-  void atan2(const floatmp_base &x, const floatmp_base &y) {
-    mpfr_atan2(value_, x.c_mpfr(), y.c_mpfr(), mpfr_rnd_());
-  }
-  void sinh(const floatmp_base &x) {
-    mpfr_sinh(value_, x.c_mpfr(), mpfr_rnd_());
-  }
-  void cosh(const floatmp_base &x) {
-    mpfr_cosh(value_, x.c_mpfr(), mpfr_rnd_());
-  }
-  void tanh(const floatmp_base &x) {
-    mpfr_tanh(value_, x.c_mpfr(), mpfr_rnd_());
-  }
-  void asinh(const floatmp_base &x) {
-    mpfr_asinh(value_, x.c_mpfr(), mpfr_rnd_());
-  }
-  void acosh(const floatmp_base &x);
-  void atanh(const floatmp_base &x);
-  void erf(const floatmp_base &x) { mpfr_erf(value_, x.c_mpfr(), mpfr_rnd_()); }
-  void erfc(const floatmp_base &x) {
-    mpfr_erfc(value_, x.c_mpfr(), mpfr_rnd_());
-  }
-  void tgamma(const floatmp_base &x);
-  void lgamma(const floatmp_base &x);
+           const floatmp_base &z, mpfr_rnd_t rnd = mpfr_rnd_()) {
+    mpfr_fma(value_, x.c_mpfr(), y.c_mpfr(), z.c_mpfr(), rnd);
+  }
+  void fmax(const floatmp_base &x, const floatmp_base &y,
+            mpfr_rnd_t rnd = mpfr_rnd_());
+  void fmin(const floatmp_base &x, const floatmp_base &y,
+            mpfr_rnd_t rnd = mpfr_rnd_());
+  void fdim(const floatmp_base &x, const floatmp_base &y,
+            mpfr_rnd_t rnd = mpfr_rnd_()) {
+    mpfr_dim(value_, x.c_mpfr(), y.c_mpfr(), rnd);
+  }
+  void exp(const floatmp_base &x, mpfr_rnd_t rnd = mpfr_rnd_()) {
+    mpfr_exp(value_, x.c_mpfr(), rnd);
+  }
+  void exp2(const floatmp_base &x, mpfr_rnd_t rnd = mpfr_rnd_()) {
+    mpfr_exp2(value_, x.c_mpfr(), rnd);
+  }
+  void expm1(const floatmp_base &x, mpfr_rnd_t rnd = mpfr_rnd_()) {
+    mpfr_expm1(value_, x.c_mpfr(), rnd);
+  }
+  void log(const floatmp_base &x, mpfr_rnd_t rnd = mpfr_rnd_(),
+           floatmp_check_t check = floatmp_check_t::checked);
+  void log10(const floatmp_base &x, mpfr_rnd_t rnd = mpfr_rnd_(),
+             floatmp_check_t check = floatmp_check_t::checked);
+  void log2(const floatmp_base &x, mpfr_rnd_t rnd = mpfr_rnd_(),
+            floatmp_check_t check = floatmp_check_t::checked);
+  void log1p(const floatmp_base &x, mpfr_rnd_t rnd = mpfr_rnd_(),
+             floatmp_check_t check = floatmp_check_t::checked);
+  void pow(const floatmp_base &x, const floatmp_base &y,
+           mpfr_rnd_t rnd = mpfr_rnd_(),
+           floatmp_check_t check = floatmp_check_t::checked);
+  void sqrt(const floatmp_base &x, mpfr_rnd_t rnd = mpfr_rnd_(),
+            floatmp_check_t check = floatmp_check_t::checked);
+  void cbrt(const floatmp_base &x, mpfr_rnd_t rnd = mpfr_rnd_()) {
+    mpfr_cbrt(value_, x.c_mpfr(), rnd);
+  }
+  void hypot(const floatmp_base &x, const floatmp_base &y,
+             mpfr_rnd_t rnd = mpfr_rnd_()) {
+    mpfr_hypot(value_, x.c_mpfr(), y.c_mpfr(), rnd);
+  }
+  void sin(const floatmp_base &x, mpfr_rnd_t rnd = mpfr_rnd_()) {
+    mpfr_sin(value_, x.c_mpfr(), rnd);
+  }
+  void cos(const floatmp_base &x, mpfr_rnd_t rnd = mpfr_rnd_()) {
+    mpfr_cos(value_, x.c_mpfr(), rnd);
+  }
+  void tan(const floatmp_base &x, mpfr_rnd_t rnd = mpfr_rnd_()) {
+    mpfr_tan(value_, x.c_mpfr(), rnd);
+  }
+  void asin(const floatmp_base &x, mpfr_rnd_t rnd = mpfr_rnd_(),
+            floatmp_check_t check = floatmp_check_t::checked);
+  void acos(const floatmp_base &x, mpfr_rnd_t rnd = mpfr_rnd_(),
+            floatmp_check_t check = floatmp_check_t::checked);
+  void atan(const floatmp_base &x, mpfr_rnd_t rnd = mpfr_rnd_()) {
+    mpfr_atan(value_, x.c_mpfr(), rnd);
+  }
+  void atan2(const floatmp_base &x, const floatmp_base &y,
+             mpfr_rnd_t rnd = mpfr_rnd_()) {
+    mpfr_atan2(value_, x.c_mpfr(), y.c_mpfr(), rnd);
+  }
+  void sinh(const floatmp_base &x, mpfr_rnd_t rnd = mpfr_rnd_()) {
+    mpfr_sinh(value_, x.c_mpfr(), rnd);
+  }
+  void cosh(const floatmp_base &x, mpfr_rnd_t rnd = mpfr_rnd_()) {
+    mpfr_cosh(value_, x.c_mpfr(), rnd);
+  }
+  void tanh(const floatmp_base &x, mpfr_rnd_t rnd = mpfr_rnd_()) {
+    mpfr_tanh(value_, x.c_mpfr(), rnd);
+  }
+  void asinh(const floatmp_base &x, mpfr_rnd_t rnd = mpfr_rnd_()) {
+    mpfr_asinh(value_, x.c_mpfr(), rnd);
+  }
+  void acosh(const floatmp_base &x, mpfr_rnd_t rnd = mpfr_rnd_(),
+             floatmp_check_t check = floatmp_check_t::checked);
+  void atanh(const floatmp_base &x, mpfr_rnd_t rnd = mpfr_rnd_(),
+             floatmp_check_t check = floatmp_check_t::checked);
+  void erf(const floatmp_base &x, mpfr_rnd_t rnd = mpfr_rnd_()) {
+    mpfr_erf(value_, x.c_mpfr(), rnd);
+  }
+  void erfc(const floatmp_base &x, mpfr_rnd_t rnd = mpfr_rnd_()) {
+    mpfr_erfc(value_, x.c_mpfr(), rnd);
+  }
+  void tgamma(const floatmp_base &x, mpfr_rnd_t rnd = mpfr_rnd_(),
+              floatmp_check_t check = floatmp_check_t::checked);
+  void lgamma(const floatmp_base &x, mpfr_rnd_t rnd = mpfr_rnd_(),
+              floatmp_check_t check = floatmp_check_t::checked);
   void ceil(const floatmp_base &x) { mpfr_ceil(value_, x.c_mpfr()); }
   void floor(const floatmp_base &x) { mpfr_floor(value_, x.c_mpfr()); }
   void trunc(const floatmp_base &x) { mpfr_trunc(value_, x.c_mpfr()); }
   void round(const floatmp_base &x) { mpfr_round(value_, x.c_mpfr()); }
-  void nearbyint(const floatmp_base &x) {
-    mpfr_rint(value_, x.c_mpfr(), mpfr_rnd_());
-  }
-  void nextafter(const floatmp_base &x, const floatmp_base &y);
-  void nextabove(const floatmp_base &x);
-  void nextbelow(const floatmp_base &x);
+  void nearbyint(const floatmp_base &x, mpfr_rnd_t rnd = mpfr_rnd_()) {
+    mpfr_rint(value_, x.c_mpfr(), rnd);
+  }
+  void nextafter(const floatmp_base &x, const floatmp_base &y,
+                 mpfr_rnd_t rnd = mpfr_rnd_(),
+                 floatmp_check_t check = floatmp_check_t::checked);
+  void nextabove(const floatmp_base &x, mpfr_rnd_t rnd = mpfr_rnd_(),
+                 floatmp_check_t check = floatmp_check_t::checked);
+  void nextbelow(const floatmp_base &x, mpfr_rnd_t rnd = mpfr_rnd_(),
+                 floatmp_check_t check = floatmp_check_t::checked);
+  // throws std::domain_error or sets NaN, depending on the checking mode
+  void domain_error_(const char *what, floatmp_check_t check);
+#ifdef TEUTHID_HAVE_QUADMATH
+  // binary128 (__float128) has 113 significant bits; the conversion to MPFR
+  // is exact if x has at least that many bits of precision
+  static constexpr mpfr_prec_t float128_digits_ = 113;
+  static void float128_to_mpfr_(mpfr_ptr x, const __float128 &v,
+                                mpfr_rnd_t rnd);
+  static __float128 mpfr_to_float128_(mpfr_srcptr x, mpfr_rnd_t rnd);
+#endif // TEUTHID_HAVE_QUADMATH
 #ifdef TEUTHID_HAVE_INT_128
-  static long double int128_to_ldouble_(const int128_t &x) {
-    return static_cast<long double>(INT64_MAX) *
-               static_cast<long double>(x / INT64_MAX) +
-           static_cast<long double>(x % INT64_MAX);
-  }
-  static long double uint128_to_ldouble_(const uint128_t &x) {
-    return static_cast<long double>(UINT64_MAX) *
-               static_cast<long double>(x / UINT64_MAX) +
-           static_cast<long double>(x % UINT64_MAX);
-  }
+  // the exact value of a 128-bit integer as a read-only MPFR number whose
+  // limbs are kept inside the object (no heap and no rounding)
+  class int128_value_ {
+  public:
+    explicit int128_value_(const uint128_t &v, bool negative = false) {
+      set_(v, negative);
+    }
+    explicit int128_value_(const int128_t &v) {
+      set_((v < 0) ? (~static_cast<uint128_t>(v) + 1)
+                   : static_cast<uint128_t>(v),
+           v < 0);
+    }
+    int128_value_(const int128_value_ &) = delete;
+    int128_value_ &operator=(const int128_value_ &) = delete;
+    operator mpfr_srcptr() const noexcept { return value_; }
+
+  private:
+    mp_limb_t limbs_[floatmp_limbs(128)];
+    mpfr_t value_;
+
+    void set_(uint128_t v, bool negative) {
+      if (v == 0) {
+        mpfr_custom_init_set(value_, MPFR_ZERO_KIND, 0, 128, limbs_);
+        return;
+      }
+#if (GMP_NUMB_BITS == 64) && (GMP_NAIL_BITS == 0)
+      // the significand is v shifted to the most significant bit of the
+      // two limbs
+      uint64_t __high = static_cast<uint64_t>(v >> 64);
+      int __shift =
+          (__high != 0)
+              ? __builtin_clzll(__high)
+              : 64 + __builtin_clzll(static_cast<uint64_t>(v));
+      v <<= __shift;
+      limbs_[0] = static_cast<mp_limb_t>(v);
+      limbs_[1] = static_cast<mp_limb_t>(v >> 64);
+      mpfr_custom_init_set(value_,
+                           negative ? -MPFR_REGULAR_KIND : MPFR_REGULAR_KIND,
+                           128 - __shift, 128, limbs_);
+#else
+      MPFR_DECL_INIT(__low, 64);
+      mpfr_custom_init(limbs_, 128);
+      mpfr_custom_init_set(value_, MPFR_ZERO_KIND, 0, 128, limbs_);
+      mpfr_set_uj(value_, static_cast<uint64_t>(v >> 64), MPFR_RNDN);
+      mpfr_mul_2ui(value_, value_, 64, MPFR_RNDN);
+      mpfr_set_uj(__low, static_cast<uint64_t>(v), MPFR_RNDN);
+      mpfr_add(value_, value_, __low, MPFR_RNDN); // exact
+      if (negative)
+        mpfr_neg(value_, value_, MPFR_RNDN);
+#endif
+    }
+  };
 #endif // TEUTHID_HAVE_INT_128
 
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
 #define __TEUTHID_FLOATMP_ASSIGN_SPEC(TYPE, FUN)                               \
-  void assign(const TYPE &x) { FUN(value_, x, mpfr_rnd_()); }
+  void assign(const TYPE &x, mpfr_rnd_t rnd = mpfr_rnd_()) {                   \
+    FUN(value_, x, rnd);                                                       \
+  }
   __TEUTHID_FLOATMP_ASSIGN_SPEC(int8_t, mpfr_set_sj)
   __TEUTHID_FLOATMP_ASSIGN_SPEC(int16_t, mpfr_set_sj)
   __TEUTHID_FLOATMP_ASSIGN_SPEC(int32_t, mpfr_set_sj)
@@ -261,16 +625,26 @@ private:
   __TEUTHID_FLOATMP_ASSIGN_SPEC(double, mpfr_set_d)
   __TEUTHID_FLOATMP_ASSIGN_SPEC(long double, mpfr_set_ld)
   __TEUTHID_FLOATMP_ASSIGN_SPEC(mpfr_t, mpfr_set)
+#ifdef TEUTHID_HAVE_QUADMATH
+  __TEUTHID_FLOATMP_ASSIGN_SPEC(__float128, float128_to_mpfr_)
+#endif
 #undef __TEUTHID_FLOATMP_ASSIGN_SPEC
 #endif // DOXYGEN_SHOULD_SKIP_THIS
-  template <std::size_t P> void assign(const floatmp<P> &x) {
+  template <std::size_t P, typename R>
+  void assign(const floatmp<P, R> &x, mpfr_rnd_t rnd = mpfr_rnd_()) {
     TEUTHID_CHECK_FLOATMP_PRECISION(P);
-    mpfr_set(value_, x.c_mpfr(), mpfr_rnd_());
+    mpfr_set(value_, x.c_mpfr(), rnd);
+  }
+  template <std::size_t N>
+  void assign(const floatmp_expansion<N> &x, mpfr_rnd_t rnd = mpfr_rnd_()) {
+    x.get_(value_, rnd);
   }
 
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
 #define __TEUTHID_FLOATMP_ARITHMETIC_SPEC(OPER, TYPE, FUN)                     \
-  void OPER(const TYPE &x) { FUN(value_, c_mpfr(), x, mpfr_rnd_()); }
+  void OPER(const TYPE &x, mpfr_rnd_t rnd = mpfr_rnd_()) {                     \
+    FUN(value_, c_mpfr(), x, rnd);                                             \
+  }
   __TEUTHID_FLOATMP_ARITHMETIC_SPEC(add, int8_t, mpfr_add_si)
   __TEUTHID_FLOATMP_ARITHMETIC_SPEC(add, int16_t, mpfr_add_si)
   __TEUTHID_FLOATMP_ARITHMETIC_SPEC(add, int32_t, mpfr_add_si)
@@ -318,731 +692,1844 @@ private:
 #undef __TEUTHID_FLOATMP_ARITHMETIC_SPEC
 
 #define __TEUTHID_FLOATMP_ARITHMETIC_SPEC(OPER, FUN)                           \
-  void OPER(const long double &x) {                                            \
-    mpfr_t __v;                                                                \
-    mpfr_init2(__v, mpfr_get_prec(value_));                                    \
-    mpfr_set_ld(__v, x, mpfr_rnd_());                                          \
-    FUN(value_, c_mpfr(), __v, mpfr_rnd_());                                   \
-    mpfr_clear(__v);                                                           \
+  void OPER(const long double &x, mpfr_rnd_t rnd = mpfr_rnd_()) {              \
+    MPFR_DECL_INIT(__v, std::numeric_limits<long double>::digits);             \
+    mpfr_set_ld(__v, x, MPFR_RNDN); /* exact */                                \
+    FUN(value_, c_mpfr(), __v, rnd);                                           \
   }                                                                            \
-  template <std::size_t P> void OPER(const floatmp<P> &x) {                    \
+  template <std::size_t P, typename R>                                         \
+  void OPER(const floatmp<P, R> &x, mpfr_rnd_t rnd = mpfr_rnd_()) {            \
     TEUTHID_CHECK_FLOATMP_PRECISION(P);                                        \
-    FUN(value_, c_mpfr(), x.c_mpfr(), mpfr_rnd_());                            \
+    FUN(value_, c_mpfr(), x.c_mpfr(), rnd);                                    \
+  }                                                                            \
+  template <std::size_t N>                                                     \
+  void OPER(const floatmp_expansion<N> &x, mpfr_rnd_t rnd = mpfr_rnd_()) {     \
+    MPFR_DECL_INIT(__v, floatmp_expansion<N>::exact_precision_);               \
+    x.get_(__v, MPFR_RNDN); /* exact */                                        \
+    FUN(value_, c_mpfr(), __v, rnd);                                           \
   }
   __TEUTHID_FLOATMP_ARITHMETIC_SPEC(add, mpfr_add)
   __TEUTHID_FLOATMP_ARITHMETIC_SPEC(sub, mpfr_sub)
   __TEUTHID_FLOATMP_ARITHMETIC_SPEC(mul, mpfr_mul)
   __TEUTHID_FLOATMP_ARITHMETIC_SPEC(div, mpfr_div)
 #undef __TEUTHID_FLOATMP_ARITHMETIC_SPEC
-#endif // DOXYGEN_SHOULD_SKIP_THIS
 
-  static mpfr_rnd_t mpfr_rnd_() noexcept {
-    return static_cast<mpfr_rnd_t>(round_mode_.load());
+#ifdef TEUTHID_HAVE_QUADMATH
+#define __TEUTHID_FLOATMP_ARITHMETIC_SPEC(OPER, FUN)                           \
+  void OPER(const __float128 &x, mpfr_rnd_t rnd = mpfr_rnd_()) {              \
+    MPFR_DECL_INIT(__v, float128_digits_);                                     \
+    float128_to_mpfr_(__v, x, MPFR_RNDN); /* exact */                          \
+    FUN(value_, c_mpfr(), __v, rnd);                                           \
   }
+  __TEUTHID_FLOATMP_ARITHMETIC_SPEC(add, mpfr_add)
+  __TEUTHID_FLOATMP_ARITHMETIC_SPEC(sub, mpfr_sub)
+  __TEUTHID_FLOATMP_ARITHMETIC_SPEC(mul, mpfr_mul)
+  __TEUTHID_FLOATMP_ARITHMETIC_SPEC(div, mpfr_div)
+#undef __TEUTHID_FLOATMP_ARITHMETIC_SPEC
+#endif // TEUTHID_HAVE_QUADMATH
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+  static mpfr_rnd_t mpfr_rnd_() noexcept { return round_mode_; }
 
   mpfr_t value_;
-  static std::atomic_int round_mode_;
-  static const floatmp_base zero_;
-  static const floatmp_base minus_one_;
-  static const floatmp_base plus_one_;
+  bool inline_limbs_;
+  static thread_local mpfr_rnd_t round_mode_;
+  static thread_local comparison_rule_ comparison_;
 }; // class floatmp_base
 
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
 #ifdef TEUTHID_HAVE_INT_128
 template <>
-inline floatmp_base::floatmp_base(std::size_t precision, const int128_t &x) {
+inline floatmp_base::floatmp_base(std::size_t precision, const int128_t &x,
+                                  mp_limb_t *limbs, mpfr_rnd_t rnd) {
   TEUTHID_ASSERT_FLOATMP_PRECISION(precision);
-  mpfr_init2(value_, precision);
-  mpfr_set_ld(value_, int128_to_ldouble_(x), mpfr_rnd_());
+  init_(precision, limbs);
+  int128_value_ __x(x);
+  mpfr_set(value_, __x, rnd);
 }
 template <>
-inline floatmp_base::floatmp_base(std::size_t precision, const uint128_t &x) {
+inline floatmp_base::floatmp_base(std::size_t precision, const uint128_t &x,
+                                  mp_limb_t *limbs, mpfr_rnd_t rnd) {
   TEUTHID_ASSERT_FLOATMP_PRECISION(precision);
-  mpfr_init2(value_, precision);
-  mpfr_set_ld(value_, uint128_to_ldouble_(x), mpfr_rnd_());
+  init_(precision, limbs);
+  int128_value_ __x(x);
+  mpfr_set(value_, __x, rnd);
 }
-template <> inline void floatmp_base::assign(const int128_t &x) {
-  mpfr_set_ld(value_, int128_to_ldouble_(x), mpfr_rnd_());
+template <>
+inline void floatmp_base::assign(const int128_t &x, mpfr_rnd_t rnd) {
+  int128_value_ __x(x);
+  mpfr_set(value_, __x, rnd);
 }
-template <> inline void floatmp_base::assign(const uint128_t &x) {
-  mpfr_set_ld(value_, uint128_to_ldouble_(x), mpfr_rnd_());
+template <>
+inline void floatmp_base::assign(const uint128_t &x, mpfr_rnd_t rnd) {
+  int128_value_ __x(x);
+  mpfr_set(value_, __x, rnd);
 }
 
-#define __TEUTHID_FLOATMP_ARITHMETIC_SPEC(OPER)                                \
-  template <> inline void floatmp_base::OPER(const int128_t &x) {              \
-    OPER(int128_to_ldouble_(x));                                               \
+#define __TEUTHID_FLOATMP_ARITHMETIC_SPEC(OPER, FUN)                           \
+  template <>                                                                  \
+  inline void floatmp_base::OPER(const int128_t &x, mpfr_rnd_t rnd) {          \
+    FUN(value_, value_, int128_value_(x), rnd);                                \
   }                                                                            \
-  template <> inline void floatmp_base::OPER(const uint128_t &x) {             \
-    OPER(uint128_to_ldouble_(x));                                              \
-  }
-__TEUTHID_FLOATMP_ARITHMETIC_SPEC(add)
-__TEUTHID_FLOATMP_ARITHMETIC_SPEC(sub)
-__TEUTHID_FLOATMP_ARITHMETIC_SPEC(mul)
-__TEUTHID_FLOATMP_ARITHMETIC_SPEC(div)
+  template <>                                                                  \
+  inline void floatmp_base::OPER(const uint128_t &x, mpfr_rnd_t rnd) {         \
+    FUN(value_, value_, int128_value_(x), rnd);                                \
+  }
+__TEUTHID_FLOATMP_ARITHMETIC_SPEC(add, mpfr_add)
+__TEUTHID_FLOATMP_ARITHMETIC_SPEC(sub, mpfr_sub)
+__TEUTHID_FLOATMP_ARITHMETIC_SPEC(mul, mpfr_mul)
+__TEUTHID_FLOATMP_ARITHMETIC_SPEC(div, mpfr_div)
 #undef __TEUTHID_FLOATMP_ARITHMETIC_SPEC
 #endif // TEUTHID_HAVE_INT_128
 #endif // DOXYGEN_SHOULD_SKIP_THIS
 
 /******************************************************************************/
 
-template <std::size_t Precision> class floatmp : public floatmp_base {
+struct floatmp_dynamic_rounding {
+  static floatmp_round_t mode() noexcept {
+    return floatmp_base::rounding_mode();
+  }
+  // the mode is not known at compile time
+  static constexpr std::float_round_style round_style() noexcept {
+    return std::round_indeterminate;
+  }
+};
+
+template <floatmp_round_t Mode> struct floatmp_fixed_rounding {
+  static constexpr floatmp_round_t mode() noexcept { return Mode; }
+  static constexpr std::float_round_style round_style() noexcept {
+    switch (Mode) {
+    case floatmp_round_t::round_to_nearest:
+      return std::round_to_nearest;
+    case floatmp_round_t::round_toward_zero:
+      return std::round_toward_zero;
+    case floatmp_round_t::round_toward_infinity:
+      return std::round_toward_infinity;
+    case floatmp_round_t::round_toward_neg_infinity:
+      return std::round_toward_neg_infinity;
+    default:
+      return std::round_indeterminate;
+    }
+  }
+};
+
+struct floatmp_checked {
+  static constexpr floatmp_check_t mode() noexcept {
+    return floatmp_check_t::checked;
+  }
+};
+
+struct floatmp_unchecked {
+  static constexpr floatmp_check_t mode() noexcept {
+    return floatmp_check_t::unchecked;
+  }
+};
+
+struct floatmp_propagate_nan {
+  static constexpr floatmp_check_t mode() noexcept {
+    return floatmp_check_t::propagate_nan;
+  }
+};
+
+template <typename Rounding, typename Checking> struct floatmp_policy {
+  typedef Rounding rounding;
+  typedef Checking checking;
+};
+
+template <std::size_t Precision, floatmp_round_t Mode>
+using floatmp_rounded =
+    floatmp<Precision, floatmp_policy<floatmp_fixed_rounding<Mode>>>;
+
+/******************************************************************************/
+
+template <std::size_t Precision, typename Policy>
+class floatmp : private floatmp_storage<Precision>, public floatmp_base {
 public:
-  floatmp() : floatmp_base(Precision) {
+  typedef Policy policy_type;
+
+  floatmp() : floatmp_base(Precision, this->limbs_()) {
+    TEUTHID_CHECK_FLOATMP_PRECISION(Precision);
+  }
+  floatmp(const floatmp &x)
+      : floatmp_base(Precision, static_cast<const floatmp_base &>(x),
+                     this->limbs_(), rnd_()) {}
+  floatmp(floatmp &&x) noexcept
+      : floatmp_base(static_cast<floatmp_base &&>(x), this->limbs_()) {}
+  template <std::size_t P, typename R>
+  floatmp(const floatmp<P, R> &x)
+      : floatmp_base(Precision, static_cast<const floatmp_base &>(x),
+                     this->limbs_(), rnd_()) {
     TEUTHID_CHECK_FLOATMP_PRECISION(Precision);
   }
-  template <std::size_t P>
-  floatmp(const floatmp<P> &x)
-      : floatmp_base(Precision, static_cast<const floatmp_base &>(x)) {
+  template <typename T>
+  floatmp(const T &x) : floatmp_base(Precision, x, this->limbs_(), rnd_()) {
     TEUTHID_CHECK_FLOATMP_PRECISION(Precision);
   }
-  template <typename T> floatmp(const T &x) : floatmp_base(Precision, x) {
+  template <typename E>
+  floatmp(const floatmp_expr<E> &x) : floatmp_base(Precision, this->limbs_()) {
     TEUTHID_CHECK_FLOATMP_PRECISION(Precision);
+    x.evaluate(value_, rnd_());
   }
   virtual ~floatmp() {}
   floatmp &operator=(const floatmp &other) {
+    if (this != &other) {
+      reinit_();
+      mpfr_set(value_, other.c_mpfr(), rnd_());
+    }
+    return *this;
+  }
+  floatmp &operator=(floatmp &&other) noexcept {
     if (this != &other)
-      mpfr_set(value_, other.c_mpfr(), mpfr_rnd_());
+      swap_(other);
     return *this;
   }
-  template <std::size_t P> floatmp &operator=(const floatmp<P> &other) {
-    mpfr_set(value_, other.c_mpfr(), mpfr_rnd_());
+  template <std::size_t P, typename R>
+  floatmp &operator=(const floatmp<P, R> &other) {
+    reinit_();
+    mpfr_set(value_, other.c_mpfr(), rnd_());
     return *this;
   }
   template <typename T> floatmp &operator=(const T &x) {
-    floatmp_base::assign(x);
+    reinit_();
+    floatmp_base::assign(x, rnd_());
+    return *this;
+  }
+  template <typename E> floatmp &operator=(const floatmp_expr<E> &x) {
+    reinit_();
+    x.evaluate(value_, rnd_());
     return *this;
   }
-  template <std::size_t P> operator floatmp<P>() const {
-    return floatmp<P>(*this);
+  template <std::size_t P, typename R> operator floatmp<P, R>() const {
+    return floatmp<P, R>(*this);
   }
+  explicit operator float() const { return mpfr_get_flt(value_, rnd_()); }
+  explicit operator double() const { return mpfr_get_d(value_, rnd_()); }
+  explicit operator long double() const { return mpfr_get_ld(value_, rnd_()); }
+#ifdef TEUTHID_HAVE_QUADMATH
+  explicit operator __float128() const {
+    return floatmp_base::mpfr_to_float128_(value_, rnd_());
+  }
+#endif
   floatmp operator-() const {
-    floatmp<Precision> __v(*this);
-    mpfr_neg(__v.value_, c_mpfr(), mpfr_rnd_());
+    floatmp<Precision, Policy> __v(*this);
+    mpfr_neg(__v.value_, c_mpfr(), rnd_());
     return __v;
   }
   template <typename T> floatmp &operator+=(const T &x) {
-    floatmp_base::add(x);
+    floatmp_base::add(x, rnd_());
     return *this;
   }
   template <typename T> floatmp &operator-=(const T &x) {
-    floatmp_base::sub(x);
+    floatmp_base::sub(x, rnd_());
     return *this;
   }
   template <typename T> floatmp &operator*=(const T &x) {
-    floatmp_base::mul(x);
+    floatmp_base::mul(x, rnd_());
     return *this;
   }
   template <typename T> floatmp &operator/=(const T &x) {
-    floatmp_base::div(x);
+    floatmp_base::div(x, rnd_());
     return *this;
   }
+  template <typename E> floatmp &operator+=(const floatmp_expr<E> &x);
+  template <typename E> floatmp &operator-=(const floatmp_expr<E> &x);
+  template <typename E> floatmp &operator*=(const floatmp_expr<E> &x);
+  template <typename E> floatmp &operator/=(const floatmp_expr<E> &x);
 
   template <typename T> floatmp &assign(const T &x) {
-    floatmp_base::assign(x);
+    reinit_();
+    floatmp_base::assign(x, rnd_());
     return *this;
   }
   template <typename T> bool equal_to(const T &x) const {
+    if (comparison_.mode == floatmp_comparison_t::exact)
+      return floatmp_base::equal_to_(x);
     return floatmp_base::equal_to(
-        static_cast<floatmp_base>(floatmp<Precision>(x)));
+        static_cast<const floatmp_base &>(floatmp<Precision, Policy>(x)));
   }
   template <typename T> bool less_than(const T &x) const {
+    if (comparison_.mode == floatmp_comparison_t::exact)
+      return floatmp_base::less_than_(x);
     return floatmp_base::less_than(
-        static_cast<floatmp_base>(floatmp<Precision>(x)));
+        static_cast<const floatmp_base &>(floatmp<Precision, Policy>(x)));
+  }
+  template <typename T> bool greater_than(const T &x) const {
+    if (comparison_.mode == floatmp_comparison_t::exact)
+      return floatmp_base::greater_than_(x);
+    return static_cast<const floatmp_base &>(floatmp<Precision, Policy>(x))
+        .less_than(*this);
   }
   template <typename T> floatmp &add(const T &x) {
-    floatmp_base::add(x);
+    floatmp_base::add(x, rnd_());
     return *this;
   }
   template <typename T> floatmp &sub(const T &x) {
-    floatmp_base::sub(x);
+    floatmp_base::sub(x, rnd_());
     return *this;
   }
   template <typename T> floatmp &mul(const T &x) {
-    floatmp_base::mul(x);
+    floatmp_base::mul(x, rnd_());
     return *this;
   }
   template <typename T> floatmp &div(const T &x) {
-    floatmp_base::div(x);
+    floatmp_base::div(x, rnd_());
     return *this;
   }
+  template <typename E> floatmp &assign(const floatmp_expr<E> &x) {
+    return (*this = x);
+  }
+  template <typename E> floatmp &add(const floatmp_expr<E> &x) {
+    return (*this += x);
+  }
+  template <typename E> floatmp &sub(const floatmp_expr<E> &x) {
+    return (*this -= x);
+  }
+  template <typename E> floatmp &mul(const floatmp_expr<E> &x) {
+    return (*this *= x);
+  }
+  template <typename E> floatmp &div(const floatmp_expr<E> &x) {
+    return (*this /= x);
+  }
   constexpr std::size_t precision() const noexcept { return Precision; }
-  template <std::size_t P> floatmp &swap(floatmp<P> &x) {
-    floatmp __tmp(x);
+  floatmp &swap(floatmp &x) noexcept {
+    swap_(x);
+    return *this;
+  }
+  template <std::size_t P, typename R> floatmp &swap(floatmp<P, R> &x) {
+    floatmp_scratch_pool::lease __tmp(Precision);
+    mpfr_set(__tmp, x.c_mpfr(), rnd_());
     x.assign(c_mpfr());
-    return assign(__tmp);
+    reinit_();
+    mpfr_set(value_, __tmp, MPFR_RNDN); // exact
+    return *this;
   }
-  template <std::size_t P> floatmp &abs(const floatmp<P> &x) {
-    floatmp_base::abs(static_cast<const floatmp_base &>(x));
+  template <std::size_t P, typename R> floatmp &abs(const floatmp<P, R> &x) {
+    floatmp_base::abs(static_cast<const floatmp_base &>(x), rnd_());
     return *this;
   }
-  template <std::size_t P1, std::size_t P2>
-  floatmp &fmod(const floatmp<P1> &x, const floatmp<P2> &y) {
+  template <std::size_t P1, typename R1, std::size_t P2, typename R2>
+  floatmp &fmod(const floatmp<P1, R1> &x, const floatmp<P2, R2> &y) {
     floatmp_base::fmod(static_cast<const floatmp_base &>(x),
-                       static_cast<const floatmp_base &>(y));
+                       static_cast<const floatmp_base &>(y), rnd_(),
+                       chk_());
     return *this;
   }
-  template <std::size_t P1, std::size_t P2>
-  floatmp &remainder(const floatmp<P1> &x, const floatmp<P2> &y) {
+  template <std::size_t P1, typename R1, std::size_t P2, typename R2>
+  floatmp &remainder(const floatmp<P1, R1> &x, const floatmp<P2, R2> &y) {
     floatmp_base::remainder(static_cast<const floatmp_base &>(x),
-                            static_cast<const floatmp_base &>(y));
+                            static_cast<const floatmp_base &>(y), rnd_(),
+                            chk_());
     return *this;
   }
-  template <std::size_t P1, std::size_t P2, std::size_t P3>
-  floatmp &fma(const floatmp<P1> &x, const floatmp<P2> &y,
-               const floatmp<P3> &z) {
+  template <std::size_t P1, typename R1, std::size_t P2, typename R2,
+            std::size_t P3, typename R3>
+  floatmp &fma(const floatmp<P1, R1> &x, const floatmp<P2, R2> &y,
+               const floatmp<P3, R3> &z) {
     floatmp_base::fma(static_cast<const floatmp_base &>(x),
                       static_cast<const floatmp_base &>(y),
-                      static_cast<const floatmp_base &>(z));
+                      static_cast<const floatmp_base &>(z), rnd_());
     return *this;
   }
-  template <std::size_t P1, std::size_t P2>
-  floatmp &fmax(const floatmp<P1> &x, const floatmp<P2> &y) {
+  template <std::size_t P1, typename R1, std::size_t P2, typename R2>
+  floatmp &fmax(const floatmp<P1, R1> &x, const floatmp<P2, R2> &y) {
     floatmp_base::fmax(static_cast<const floatmp_base &>(x),
-                       static_cast<const floatmp_base &>(y));
+                       static_cast<const floatmp_base &>(y), rnd_());
     return *this;
   }
-  template <std::size_t P1, std::size_t P2>
-  floatmp &fmin(const floatmp<P1> &x, const floatmp<P2> &y) {
+  template <std::size_t P1, typename R1, std::size_t P2, typename R2>
+  floatmp &fmin(const floatmp<P1, R1> &x, const floatmp<P2, R2> &y) {
     floatmp_base::fmin(static_cast<const floatmp_base &>(x),
-                       static_cast<const floatmp_base &>(y));
+                       static_cast<const floatmp_base &>(y), rnd_());
     return *this;
   }
-  template <std::size_t P1, std::size_t P2>
-  floatmp &fdim(const floatmp<P1> &x, const floatmp<P2> &y) {
+  template <std::size_t P1, typename R1, std::size_t P2, typename R2>
+  floatmp &fdim(const floatmp<P1, R1> &x, const floatmp<P2, R2> &y) {
     floatmp_base::fdim(static_cast<const floatmp_base &>(x),
-                       static_cast<const floatmp_base &>(y));
+                       static_cast<const floatmp_base &>(y), rnd_());
     return *this;
   }
-  template <std::size_t P> floatmp &exp(const floatmp<P> &x) {
-    floatmp_base::exp(static_cast<const floatmp_base &>(x));
+  template <std::size_t P, typename R> floatmp &exp(const floatmp<P, R> &x) {
+    floatmp_base::exp(static_cast<const floatmp_base &>(x), rnd_());
     return *this;
   }
-  template <std::size_t P> floatmp &exp2(const floatmp<P> &x) {
-    floatmp_base::exp2(static_cast<const floatmp_base &>(x));
+  template <std::size_t P, typename R> floatmp &exp2(const floatmp<P, R> &x) {
+    floatmp_base::exp2(static_cast<const floatmp_base &>(x), rnd_());
     return *this;
   }
-  template <std::size_t P> floatmp &expm1(const floatmp<P> &x) {
-    floatmp_base::expm1(static_cast<const floatmp_base &>(x));
+  template <std::size_t P, typename R> floatmp &expm1(const floatmp<P, R> &x) {
+    floatmp_base::expm1(static_cast<const floatmp_base &>(x), rnd_());
     return *this;
   }
-  template <std::size_t P> floatmp &log(const floatmp<P> &x) {
-    floatmp_base::log(static_cast<const floatmp_base &>(x));
+  template <std::size_t P, typename R> floatmp &log(const floatmp<P, R> &x) {
+    floatmp_base::log(static_cast<const floatmp_base &>(x), rnd_(), chk_());
     return *this;
   }
-  template <std::size_t P> floatmp &log10(const floatmp<P> &x) {
-    floatmp_base::log10(static_cast<const floatmp_base &>(x));
+  template <std::size_t P, typename R> floatmp &log10(const floatmp<P, R> &x) {
+    floatmp_base::log10(static_cast<const floatmp_base &>(x), rnd_(), chk_());
     return *this;
   }
-  template <std::size_t P> floatmp &log2(const floatmp<P> &x) {
-    floatmp_base::log2(static_cast<const floatmp_base &>(x));
+  template <std::size_t P, typename R> floatmp &log2(const floatmp<P, R> &x) {
+    floatmp_base::log2(static_cast<const floatmp_base &>(x), rnd_(), chk_());
     return *this;
   }
-  template <std::size_t P> floatmp &log1p(const floatmp<P> &x) {
-    floatmp_base::log1p(static_cast<const floatmp_base &>(x));
+  template <std::size_t P, typename R> floatmp &log1p(const floatmp<P, R> &x) {
+    floatmp_base::log1p(static_cast<const floatmp_base &>(x), rnd_(), chk_());
     return *this;
   }
-  template <std::size_t P1, std::size_t P2>
-  floatmp &pow(const floatmp<P1> &x, const floatmp<P2> &y) {
+  template <std::size_t P1, typename R1, std::size_t P2, typename R2>
+  floatmp &pow(const floatmp<P1, R1> &x, const floatmp<P2, R2> &y) {
     floatmp_base::pow(static_cast<const floatmp_base &>(x),
-                      static_cast<const floatmp_base &>(y));
+                      static_cast<const floatmp_base &>(y), rnd_(),
+                      chk_());
     return *this;
   }
-  template <std::size_t P> floatmp &sqrt(const floatmp<P> &x) {
-    floatmp_base::sqrt(static_cast<const floatmp_base &>(x));
+  template <std::size_t P, typename R> floatmp &sqrt(const floatmp<P, R> &x) {
+    floatmp_base::sqrt(static_cast<const floatmp_base &>(x), rnd_(), chk_());
     return *this;
   }
-  template <std::size_t P> floatmp &cbrt(const floatmp<P> &x) {
-    floatmp_base::cbrt(static_cast<const floatmp_base &>(x));
+  template <std::size_t P, typename R> floatmp &cbrt(const floatmp<P, R> &x) {
+    floatmp_base::cbrt(static_cast<const floatmp_base &>(x), rnd_());
     return *this;
   }
-  template <std::size_t P1, std::size_t P2>
-  floatmp &hypot(const floatmp<P1> &x, const floatmp<P2> &y) {
+  template <std::size_t P1, typename R1, std::size_t P2, typename R2>
+  floatmp &hypot(const floatmp<P1, R1> &x, const floatmp<P2, R2> &y) {
     floatmp_base::hypot(static_cast<const floatmp_base &>(x),
-                        static_cast<const floatmp_base &>(y));
+                        static_cast<const floatmp_base &>(y), rnd_());
     return *this;
   }
-  template <std::size_t P> floatmp &sin(const floatmp<P> &x) {
-    floatmp_base::sin(static_cast<const floatmp_base &>(x));
+  template <std::size_t P, typename R> floatmp &sin(const floatmp<P, R> &x) {
+    floatmp_base::sin(static_cast<const floatmp_base &>(x), rnd_());
     return *this;
   }
-  template <std::size_t P> floatmp &cos(const floatmp<P> &x) {
-    floatmp_base::cos(static_cast<const floatmp_base &>(x));
+  template <std::size_t P, typename R> floatmp &cos(const floatmp<P, R> &x) {
+    floatmp_base::cos(static_cast<const floatmp_base &>(x), rnd_());
     return *this;
   }
-  template <std::size_t P> floatmp &tan(const floatmp<P> &x) {
-    floatmp_base::tan(static_cast<const floatmp_base &>(x));
+  template <std::size_t P, typename R> floatmp &tan(const floatmp<P, R> &x) {
+    floatmp_base::tan(static_cast<const floatmp_base &>(x), rnd_());
     return *this;
   }
-  template <std::size_t P> floatmp &asin(const floatmp<P> &x) {
-    floatmp_base::asin(static_cast<const floatmp_base &>(x));
+  template <std::size_t P, typename R> floatmp &asin(const floatmp<P, R> &x) {
+    floatmp_base::asin(static_cast<const floatmp_base &>(x), rnd_(), chk_());
     return *this;
   }
-  template <std::size_t P> floatmp &acos(const floatmp<P> &x) {
-    floatmp_base::acos(static_cast<const floatmp_base &>(x));
+  template <std::size_t P, typename R> floatmp &acos(const floatmp<P, R> &x) {
+    floatmp_base::acos(static_cast<const floatmp_base &>(x), rnd_(), chk_());
     return *this;
   }
-  template <std::size_t P> floatmp &atan(const floatmp<P> &x) {
-    floatmp_base::atan(static_cast<const floatmp_base &>(x));
+  template <std::size_t P, typename R> floatmp &atan(const floatmp<P, R> &x) {
+    floatmp_base::atan(static_cast<const floatmp_base &>(x), rnd_());
     return *this;
   }
-  template <std::size_t P1, std::size_t P2>
-  floatmp &atan2(const floatmp<P1> &x, const floatmp<P2> &y) {
+  template <std::size_t P1, typename R1, std::size_t P2, typename R2>
+  floatmp &atan2(const floatmp<P1, R1> &x, const floatmp<P2, R2> &y) {
     floatmp_base::atan2(static_cast<const floatmp_base &>(x),
-                        static_cast<const floatmp_base &>(y));
+                        static_cast<const floatmp_base &>(y), rnd_());
     return *this;
   }
-  template <std::size_t P> floatmp &sinh(const floatmp<P> &x) {
-    floatmp_base::sinh(static_cast<const floatmp_base &>(x));
+  template <std::size_t P, typename R> floatmp &sinh(const floatmp<P, R> &x) {
+    floatmp_base::sinh(static_cast<const floatmp_base &>(x), rnd_());
     return *this;
   }
-  template <std::size_t P> floatmp &cosh(const floatmp<P> &x) {
-    floatmp_base::cosh(static_cast<const floatmp_base &>(x));
+  template <std::size_t P, typename R> floatmp &cosh(const floatmp<P, R> &x) {
+    floatmp_base::cosh(static_cast<const floatmp_base &>(x), rnd_());
     return *this;
   }
-  template <std::size_t P> floatmp &tanh(const floatmp<P> &x) {
-    floatmp_base::tanh(static_cast<const floatmp_base &>(x));
+  template <std::size_t P, typename R> floatmp &tanh(const floatmp<P, R> &x) {
+    floatmp_base::tanh(static_cast<const floatmp_base &>(x), rnd_());
     return *this;
   }
-  template <std::size_t P> floatmp &asinh(const floatmp<P> &x) {
-    floatmp_base::asinh(static_cast<const floatmp_base &>(x));
+  template <std::size_t P, typename R> floatmp &asinh(const floatmp<P, R> &x) {
+    floatmp_base::asinh(static_cast<const floatmp_base &>(x), rnd_());
     return *this;
   }
-  template <std::size_t P> floatmp &acosh(const floatmp<P> &x) {
-    floatmp_base::acosh(static_cast<const floatmp_base &>(x));
+  template <std::size_t P, typename R> floatmp &acosh(const floatmp<P, R> &x) {
+    floatmp_base::acosh(static_cast<const floatmp_base &>(x), rnd_(), chk_());
     return *this;
   }
-  template <std::size_t P> floatmp &atanh(const floatmp<P> &x) {
-    floatmp_base::atanh(static_cast<const floatmp_base &>(x));
+  template <std::size_t P, typename R> floatmp &atanh(const floatmp<P, R> &x) {
+    floatmp_base::atanh(static_cast<const floatmp_base &>(x), rnd_(), chk_());
     return *this;
   }
-  template <std::size_t P> floatmp &erf(const floatmp<P> &x) {
-    floatmp_base::erf(static_cast<const floatmp_base &>(x));
+  template <std::size_t P, typename R> floatmp &erf(const floatmp<P, R> &x) {
+    floatmp_base::erf(static_cast<const floatmp_base &>(x), rnd_());
     return *this;
   }
-  template <std::size_t P> floatmp &erfc(const floatmp<P> &x) {
-    floatmp_base::erfc(static_cast<const floatmp_base &>(x));
+  template <std::size_t P, typename R> floatmp &erfc(const floatmp<P, R> &x) {
+    floatmp_base::erfc(static_cast<const floatmp_base &>(x), rnd_());
     return *this;
   }
-  template <std::size_t P> floatmp &tgamma(const floatmp<P> &x) {
-    floatmp_base::tgamma(static_cast<const floatmp_base &>(x));
+  template <std::size_t P, typename R> floatmp &tgamma(const floatmp<P, R> &x) {
+    floatmp_base::tgamma(static_cast<const floatmp_base &>(x), rnd_(), chk_());
     return *this;
   }
-  template <std::size_t P> floatmp &lgamma(const floatmp<P> &x) {
-    floatmp_base::lgamma(static_cast<const floatmp_base &>(x));
+  template <std::size_t P, typename R> floatmp &lgamma(const floatmp<P, R> &x) {
+    floatmp_base::lgamma(static_cast<const floatmp_base &>(x), rnd_(), chk_());
     return *this;
   }
-  template <std::size_t P> floatmp &ceil(const floatmp<P> &x) {
+  template <std::size_t P, typename R> floatmp &ceil(const floatmp<P, R> &x) {
     floatmp_base::ceil(static_cast<const floatmp_base &>(x));
     return *this;
   }
-  template <std::size_t P> floatmp &floor(const floatmp<P> &x) {
+  template <std::size_t P, typename R> floatmp &floor(const floatmp<P, R> &x) {
     floatmp_base::floor(static_cast<const floatmp_base &>(x));
     return *this;
   }
-  template <std::size_t P> floatmp &trunc(const floatmp<P> &x) {
+  template <std::size_t P, typename R> floatmp &trunc(const floatmp<P, R> &x) {
     floatmp_base::trunc(static_cast<const floatmp_base &>(x));
     return *this;
   }
-  template <std::size_t P> floatmp &round(const floatmp<P> &x) {
+  template <std::size_t P, typename R> floatmp &round(const floatmp<P, R> &x) {
     floatmp_base::round(static_cast<const floatmp_base &>(x));
     return *this;
   }
-  template <std::size_t P> floatmp &nearbyint(const floatmp<P> &x) {
-    floatmp_base::nearbyint(static_cast<const floatmp_base &>(x));
+  template <std::size_t P, typename R>
+  floatmp &nearbyint(const floatmp<P, R> &x) {
+    floatmp_base::nearbyint(static_cast<const floatmp_base &>(x), rnd_());
     return *this;
   }
-  template <std::size_t P1, std::size_t P2>
-  floatmp &nextafter(const floatmp<P1> &x, const floatmp<P2> &y) {
+  template <std::size_t P1, typename R1, std::size_t P2, typename R2>
+  floatmp &nextafter(const floatmp<P1, R1> &x, const floatmp<P2, R2> &y) {
     floatmp_base::nextafter(static_cast<const floatmp_base &>(x),
-                            static_cast<const floatmp_base &>(y));
+                            static_cast<const floatmp_base &>(y), rnd_(),
+                            chk_());
     return *this;
   }
-  template <std::size_t P> floatmp &nextabove(const floatmp<P> &x) {
-    floatmp_base::nextabove(static_cast<const floatmp_base &>(x));
+  template <std::size_t P, typename R>
+  floatmp &nextabove(const floatmp<P, R> &x) {
+    floatmp_base::nextabove(static_cast<const floatmp_base &>(x), rnd_(),
+                            chk_());
     return *this;
   }
-  template <std::size_t P> floatmp &nextbelow(const floatmp<P> &x) {
-    floatmp_base::nextbelow(static_cast<const floatmp_base &>(x));
+  template <std::size_t P, typename R>
+  floatmp &nextbelow(const floatmp<P, R> &x) {
+    floatmp_base::nextbelow(static_cast<const floatmp_base &>(x), rnd_(),
+                            chk_());
     return *this;
   }
 
+  template <std::size_t P, typename R>
+  bool equal_to(const floatmp<P, R> &x, floatmp_comparison_t mode,
+                std::size_t tolerance) const {
+    return floatmp_base::equal_to(static_cast<const floatmp_base &>(x), mode,
+                                  tolerance);
+  }
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
-  template <std::size_t P> bool equal_to(const floatmp<P> &x) const {
+  template <std::size_t P, typename R>
+  bool equal_to(const floatmp<P, R> &x) const {
     return floatmp_base::equal_to(static_cast<const floatmp_base &>(x));
   }
-  template <std::size_t P> bool less_than(const floatmp<P> &x) const {
+  template <std::size_t P, typename R>
+  bool less_than(const floatmp<P, R> &x) const {
     return floatmp_base::less_than(static_cast<const floatmp_base &>(x));
   }
+  template <std::size_t P, typename R>
+  bool greater_than(const floatmp<P, R> &x) const {
+    return x.less_than(*this);
+  }
 #endif // DOXYGEN_SHOULD_SKIP_THIS
 
-  inline static constexpr floatmp<Precision> zero() {
-    return floatmp<Precision>(floatmp_base::zero_);
-  }
-  inline static constexpr floatmp<Precision> minus_one() {
-    return floatmp<Precision>(floatmp_base::minus_one_);
-  }
-  inline static constexpr floatmp<Precision> plus_one() {
-    return floatmp<Precision>(floatmp_base::plus_one_);
-  }
-  inline static constexpr floatmp<Precision> epsilon() {
-    return floatmp<Precision>().nextabove(plus_one()) - plus_one();
-  }
-  inline static constexpr floatmp<Precision> min() {
-    return floatmp<Precision>().exp2(floatmp<Precision>(mpfr_get_emin() - 1));
-  }
-  inline static constexpr floatmp<Precision> max() {
-    return (plus_one() - epsilon()) *
-           floatmp<Precision>().exp2(floatmp<Precision>(mpfr_get_emax()));
-  }
-  inline static constexpr floatmp<Precision> round_error() {
-    if (rounding_mode() == floatmp_round_t::round_to_nearest)
-      return floatmp<Precision>(0.5);
+  static const floatmp &zero() { return constants_().zero; }
+  static const floatmp &minus_one() { return constants_().minus_one; }
+  static const floatmp &plus_one() { return constants_().plus_one; }
+  static const floatmp &epsilon() { return constants_().epsilon; }
+  static const floatmp &min() { return constants_().min; }
+  static const floatmp &max() { return constants_().max; }
+  static const floatmp &pi() { return constants_().pi; }
+  static const floatmp &ln2() { return constants_().ln2; }
+  static const floatmp &e() { return constants_().e; }
+  inline static constexpr floatmp<Precision, Policy> round_error() {
+    if (Policy::rounding::mode() == floatmp_round_t::round_to_nearest)
+      return floatmp<Precision, Policy>(0.5);
     else
-      return floatmp<Precision>(1.0);
+      return floatmp<Precision, Policy>(1.0);
   }
-  static constexpr floatmp<Precision> infinity() {
-    floatmp<Precision> __x;
+  static constexpr floatmp<Precision, Policy> infinity() {
+    floatmp<Precision, Policy> __x;
     mpfr_set_inf(__x.value_, 1);
     return __x;
   }
-  static constexpr floatmp<Precision> nan() {
-    floatmp<Precision> __x;
+  static constexpr floatmp<Precision, Policy> nan() {
+    floatmp<Precision, Policy> __x;
     mpfr_set_nan(__x.value_);
     return __x;
   }
+
+private:
+  // the rounding mode used by all operations on this type
+  static mpfr_rnd_t rnd_() noexcept {
+    return static_cast<mpfr_rnd_t>(Policy::rounding::mode());
+  }
+  // the validation of arguments of the math functions
+  static constexpr floatmp_check_t chk_() noexcept {
+    return Policy::checking::mode();
+  }
+  // constants of this type, computed once on first use (thread-safe)
+  struct constants_t;
+  static const constants_t &constants_() {
+    floatmp_arena::suspend __suspend; // the constants outlive arena scopes
+    static const constants_t __constants;
+    return __constants;
+  }
 }; // class floatmp
 
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+template <std::size_t Precision, typename Policy>
+struct floatmp<Precision, Policy>::constants_t {
+  constants_t() : minus_one(-1), plus_one(1) {
+    // the constants must not depend on the rounding mode of the thread
+    // which uses them first (if the policy has dynamic rounding)
+    floatmp_base::rounding_scope __scope(floatmp_round_t::round_to_nearest);
+    mpfr_set_ui_2exp(epsilon.value_, 1, 1 - static_cast<mpfr_exp_t>(Precision),
+                     rnd_());
+    mpfr_set_ui_2exp(min.value_, 1, mpfr_get_emin() - 1, rnd_());
+    mpfr_set_inf(max.value_, 1);
+    mpfr_nextbelow(max.value_);
+    mpfr_const_pi(pi.value_, rnd_());
+    mpfr_const_log2(ln2.value_, rnd_());
+    mpfr_exp(e.value_, plus_one.value_, rnd_());
+  }
+  floatmp zero, minus_one, plus_one, epsilon, min, max, pi, ln2, e;
+};
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+/******************************************************************************/
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+// floatmp_scratch<P>: a stack-allocated MPFR register (no heap allocation)
+template <std::size_t Precision> class floatmp_scratch {
+public:
+  floatmp_scratch() {
+    mpfr_custom_init(limbs_, Precision);
+    mpfr_custom_init_set(value_, MPFR_ZERO_KIND, 0, Precision, limbs_);
+  }
+  floatmp_scratch(const floatmp_scratch &) = delete;
+  floatmp_scratch &operator=(const floatmp_scratch &) = delete;
+  operator mpfr_ptr() noexcept { return value_; }
+
+private:
+  mp_limb_t limbs_[floatmp_limbs(Precision)];
+  mpfr_t value_;
+};
+
+// kinds of nodes of the floatmp expression tree
+constexpr int floatmp_expr_mpfr_kind = 0;   // leaf with an MPFR value
+constexpr int floatmp_expr_scalar_kind = 1; // leaf with a built-in value
+constexpr int floatmp_expr_tree_kind = 2;   // inner node
+template <int Kind>
+using floatmp_expr_kind_t = std::integral_constant<int, Kind>;
+
+// arithmetic on MPFR values and built-in scalars
+template <typename T>
+struct floatmp_expr_scalar_traits<
+    T, typename std::enable_if<std::is_integral<T>::value &&
+                               std::is_signed<T>::value>::type> {
+  static constexpr std::size_t precision = 64;
+  static void set(mpfr_ptr r, const T &x, mpfr_rnd_t rnd) {
+    mpfr_set_si(r, x, rnd);
+  }
+  static void add(mpfr_ptr r, mpfr_srcptr x, const T &y, mpfr_rnd_t rnd) {
+    mpfr_add_si(r, x, y, rnd);
+  }
+  static void sub(mpfr_ptr r, mpfr_srcptr x, const T &y, mpfr_rnd_t rnd) {
+    mpfr_sub_si(r, x, y, rnd);
+  }
+  static void sub(mpfr_ptr r, const T &x, mpfr_srcptr y, mpfr_rnd_t rnd) {
+    mpfr_si_sub(r, x, y, rnd);
+  }
+  static void mul(mpfr_ptr r, mpfr_srcptr x, const T &y, mpfr_rnd_t rnd) {
+    mpfr_mul_si(r, x, y, rnd);
+  }
+  static void div(mpfr_ptr r, mpfr_srcptr x, const T &y, mpfr_rnd_t rnd) {
+    mpfr_div_si(r, x, y, rnd);
+  }
+  static void div(mpfr_ptr r, const T &x, mpfr_srcptr y, mpfr_rnd_t rnd) {
+    mpfr_si_div(r, x, y, rnd);
+  }
+};
+
+template <typename T>
+struct floatmp_expr_scalar_traits<
+    T, typename std::enable_if<std::is_integral<T>::value &&
+                               std::is_unsigned<T>::value>::type> {
+  static constexpr std::size_t precision = 64;
+  static void set(mpfr_ptr r, const T &x, mpfr_rnd_t rnd) {
+    mpfr_set_ui(r, x, rnd);
+  }
+  static void add(mpfr_ptr r, mpfr_srcptr x, const T &y, mpfr_rnd_t rnd) {
+    mpfr_add_ui(r, x, y, rnd);
+  }
+  static void sub(mpfr_ptr r, mpfr_srcptr x, const T &y, mpfr_rnd_t rnd) {
+    mpfr_sub_ui(r, x, y, rnd);
+  }
+  static void sub(mpfr_ptr r, const T &x, mpfr_srcptr y, mpfr_rnd_t rnd) {
+    mpfr_ui_sub(r, x, y, rnd);
+  }
+  static void mul(mpfr_ptr r, mpfr_srcptr x, const T &y, mpfr_rnd_t rnd) {
+    mpfr_mul_ui(r, x, y, rnd);
+  }
+  static void div(mpfr_ptr r, mpfr_srcptr x, const T &y, mpfr_rnd_t rnd) {
+    mpfr_div_ui(r, x, y, rnd);
+  }
+  static void div(mpfr_ptr r, const T &x, mpfr_srcptr y, mpfr_rnd_t rnd) {
+    mpfr_ui_div(r, x, y, rnd);
+  }
+};
+
+template <typename T>
+struct floatmp_expr_scalar_traits<
+    T, typename std::enable_if<std::is_same<T, float>::value ||
+                               std::is_same<T, double>::value>::type> {
+  static constexpr std::size_t precision = 53;
+  static void set(mpfr_ptr r, const T &x, mpfr_rnd_t rnd) {
+    mpfr_set_d(r, x, rnd);
+  }
+  static void add(mpfr_ptr r, mpfr_srcptr x, const T &y, mpfr_rnd_t rnd) {
+    mpfr_add_d(r, x, y, rnd);
+  }
+  static void sub(mpfr_ptr r, mpfr_srcptr x, const T &y, mpfr_rnd_t rnd) {
+    mpfr_sub_d(r, x, y, rnd);
+  }
+  static void sub(mpfr_ptr r, const T &x, mpfr_srcptr y, mpfr_rnd_t rnd) {
+    mpfr_d_sub(r, x, y, rnd);
+  }
+  static void mul(mpfr_ptr r, mpfr_srcptr x, const T &y, mpfr_rnd_t rnd) {
+    mpfr_mul_d(r, x, y, rnd);
+  }
+  static void div(mpfr_ptr r, mpfr_srcptr x, const T &y, mpfr_rnd_t rnd) {
+    mpfr_div_d(r, x, y, rnd);
+  }
+  static void div(mpfr_ptr r, const T &x, mpfr_srcptr y, mpfr_rnd_t rnd) {
+    mpfr_d_div(r, x, y, rnd);
+  }
+};
+
+// scalars without direct MPFR support are converted (exactly) to an MPFR
+// register allocated on the stack
+#define __TEUTHID_FLOATMP_EXPR_SCALAR_SPEC(TYPE, PREC, SET)                    \
+  template <> struct floatmp_expr_scalar_traits<TYPE> {                        \
+    static constexpr std::size_t precision = PREC;                             \
+    static void set(mpfr_ptr r, const TYPE &x, mpfr_rnd_t rnd) {               \
+      SET(r, x, rnd);                                                          \
+    }                                                                          \
+    static void add(mpfr_ptr r, mpfr_srcptr x, const TYPE &y,                  \
+                    mpfr_rnd_t rnd) {                                          \
+      floatmp_scratch<PREC> __y;                                               \
+      SET(__y, y, rnd);                                                        \
+      mpfr_add(r, x, __y, rnd);                                                \
+    }                                                                          \
+    static void sub(mpfr_ptr r, mpfr_srcptr x, const TYPE &y,                  \
+                    mpfr_rnd_t rnd) {                                          \
+      floatmp_scratch<PREC> __y;                                               \
+      SET(__y, y, rnd);                                                        \
+      mpfr_sub(r, x, __y, rnd);                                                \
+    }                                                                          \
+    static void sub(mpfr_ptr r, const TYPE &x, mpfr_srcptr y,                  \
+                    mpfr_rnd_t rnd) {                                          \
+      floatmp_scratch<PREC> __x;                                               \
+      SET(__x, x, rnd);                                                        \
+      mpfr_sub(r, __x, y, rnd);                                                \
+    }                                                                          \
+    static void mul(mpfr_ptr r, mpfr_srcptr x, const TYPE &y,                  \
+                    mpfr_rnd_t rnd) {                                          \
+      floatmp_scratch<PREC> __y;                                               \
+      SET(__y, y, rnd);                                                        \
+      mpfr_mul(r, x, __y, rnd);                                                \
+    }                                                                          \
+    static void div(mpfr_ptr r, mpfr_srcptr x, const TYPE &y,                  \
+                    mpfr_rnd_t rnd) {                                          \
+      floatmp_scratch<PREC> __y;                                               \
+      SET(__y, y, rnd);                                                        \
+      mpfr_div(r, x, __y, rnd);                                                \
+    }                                                                          \
+    static void div(mpfr_ptr r, const TYPE &x, mpfr_srcptr y,                  \
+                    mpfr_rnd_t rnd) {                                          \
+      floatmp_scratch<PREC> __x;                                               \
+      SET(__x, x, rnd);                                                        \
+      mpfr_div(r, __x, y, rnd);                                                \
+    }                                                                          \
+  };
+#define __TEUTHID_FLOATMP_EXPR_SET_LDOUBLE(R, X, RND) mpfr_set_ld(R, X, RND)
+__TEUTHID_FLOATMP_EXPR_SCALAR_SPEC(long double,
+                                   std::numeric_limits<long double>::digits,
+                                   __TEUTHID_FLOATMP_EXPR_SET_LDOUBLE)
+#ifdef TEUTHID_HAVE_INT_128
+// mpfr_set() may be a macro keeping only a pointer to its source, so the
+// view has to outlive the whole statement
+#define __TEUTHID_FLOATMP_EXPR_SET_INT128(R, X, RND)                           \
+  do {                                                                         \
+    floatmp_base::int128_value_ __v(X);                                        \
+    mpfr_set(R, __v, RND);                                                     \
+  } while (0)
+__TEUTHID_FLOATMP_EXPR_SCALAR_SPEC(int128_t, 128,
+                                   __TEUTHID_FLOATMP_EXPR_SET_INT128)
+__TEUTHID_FLOATMP_EXPR_SCALAR_SPEC(uint128_t, 128,
+                                   __TEUTHID_FLOATMP_EXPR_SET_INT128)
+#undef __TEUTHID_FLOATMP_EXPR_SET_INT128
+#endif // TEUTHID_HAVE_INT_128
+#ifdef TEUTHID_HAVE_QUADMATH
+__TEUTHID_FLOATMP_EXPR_SCALAR_SPEC(__float128, 113,
+                                   floatmp_base::float128_to_mpfr_)
+#endif // TEUTHID_HAVE_QUADMATH
+#undef __TEUTHID_FLOATMP_EXPR_SET_LDOUBLE
+#undef __TEUTHID_FLOATMP_EXPR_SCALAR_SPEC
+
+// operations of the expression tree
+#define __TEUTHID_FLOATMP_EXPR_OP_SPEC(NAME, FUN)                              \
+  struct floatmp_expr_##NAME {                                                 \
+    static void apply(mpfr_ptr r, mpfr_srcptr x, mpfr_srcptr y,                \
+                      mpfr_rnd_t rnd) {                                        \
+      FUN(r, x, y, rnd);                                                       \
+    }                                                                          \
+    template <typename T>                                                      \
+    static void apply(mpfr_ptr r, mpfr_srcptr x, const T &y, mpfr_rnd_t rnd) { \
+      floatmp_expr_scalar_traits<T>::NAME(r, x, y, rnd);                       \
+    }                                                                          \
+    template <typename T>                                                      \
+    static void apply(mpfr_ptr r, const T &x, mpfr_srcptr y, mpfr_rnd_t rnd) { \
+      __TEUTHID_FLOATMP_EXPR_OP_REVERSED_##NAME(r, x, y, rnd);                 \
+    }                                                                          \
+  };
+#define __TEUTHID_FLOATMP_EXPR_OP_REVERSED_add(R, X, Y, RND)                   \
+  floatmp_expr_scalar_traits<T>::add(R, Y, X, RND)
+#define __TEUTHID_FLOATMP_EXPR_OP_REVERSED_sub(R, X, Y, RND)                   \
+  floatmp_expr_scalar_traits<T>::sub(R, X, Y, RND)
+#define __TEUTHID_FLOATMP_EXPR_OP_REVERSED_mul(R, X, Y, RND)                   \
+  floatmp_expr_scalar_traits<T>::mul(R, Y, X, RND)
+#define __TEUTHID_FLOATMP_EXPR_OP_REVERSED_div(R, X, Y, RND)                   \
+  floatmp_expr_scalar_traits<T>::div(R, X, Y, RND)
+__TEUTHID_FLOATMP_EXPR_OP_SPEC(add, mpfr_add)
+__TEUTHID_FLOATMP_EXPR_OP_SPEC(sub, mpfr_sub)
+__TEUTHID_FLOATMP_EXPR_OP_SPEC(mul, mpfr_mul)
+__TEUTHID_FLOATMP_EXPR_OP_SPEC(div, mpfr_div)
+#undef __TEUTHID_FLOATMP_EXPR_OP_REVERSED_add
+#undef __TEUTHID_FLOATMP_EXPR_OP_REVERSED_sub
+#undef __TEUTHID_FLOATMP_EXPR_OP_REVERSED_mul
+#undef __TEUTHID_FLOATMP_EXPR_OP_REVERSED_div
+#undef __TEUTHID_FLOATMP_EXPR_OP_SPEC
+
+// leaf: a reference to floatmp<P, R>
+template <std::size_t P, typename R> class floatmp_expr_ref {
+public:
+  static constexpr std::size_t precision = P;
+  static constexpr int kind = floatmp_expr_mpfr_kind;
+  static constexpr bool single_pass = true;
+  explicit floatmp_expr_ref(const floatmp<P, R> &x) : x_(x) {}
+  mpfr_srcptr operand() const noexcept { return x_.c_mpfr(); }
+  bool aliases(mpfr_srcptr x) const noexcept { return (x == x_.c_mpfr()); }
+  void eval(mpfr_ptr r, mpfr_rnd_t rnd) const {
+    mpfr_set(r, x_.c_mpfr(), rnd);
+  }
+
+private:
+  const floatmp<P, R> &x_;
+};
+
+// leaf: a reference to mpfr_t
+class floatmp_expr_mpfr {
+public:
+  static constexpr std::size_t precision = 0;
+  static constexpr int kind = floatmp_expr_mpfr_kind;
+  static constexpr bool single_pass = true;
+  explicit floatmp_expr_mpfr(mpfr_srcptr x) : x_(x) {}
+  mpfr_srcptr operand() const noexcept { return x_; }
+  bool aliases(mpfr_srcptr x) const noexcept { return (x == x_); }
+  void eval(mpfr_ptr r, mpfr_rnd_t rnd) const { mpfr_set(r, x_, rnd); }
+
+private:
+  mpfr_srcptr x_;
+};
+
+// leaf: a built-in scalar (stored by value)
+template <typename T> class floatmp_expr_scalar {
+public:
+  static constexpr std::size_t precision = 0;
+  static constexpr int kind = floatmp_expr_scalar_kind;
+  static constexpr bool single_pass = true;
+  explicit floatmp_expr_scalar(const T &x) : x_(x) {}
+  const T &operand() const noexcept { return x_; }
+  bool aliases(mpfr_srcptr) const noexcept { return false; }
+  void eval(mpfr_ptr r, mpfr_rnd_t rnd) const {
+    floatmp_expr_scalar_traits<T>::set(r, x_, rnd);
+  }
+
+private:
+  T x_;
+};
+
+// inner node: -x
+template <typename E> class floatmp_expr_negate {
+public:
+  static constexpr std::size_t precision = E::precision;
+  static constexpr int kind = floatmp_expr_tree_kind;
+  static constexpr bool single_pass = (E::kind == floatmp_expr_mpfr_kind);
+  explicit floatmp_expr_negate(const E &x) : x_(x) {}
+  bool aliases(mpfr_srcptr x) const noexcept { return x_.aliases(x); }
+  void eval(mpfr_ptr r, mpfr_rnd_t rnd) const {
+    eval_(r, rnd, floatmp_expr_kind_t<E::kind>());
+  }
+
+private:
+  E x_;
+  void eval_(mpfr_ptr r, mpfr_rnd_t rnd,
+             floatmp_expr_kind_t<floatmp_expr_mpfr_kind>) const {
+    mpfr_neg(r, x_.operand(), rnd);
+  }
+  template <typename K> void eval_(mpfr_ptr r, mpfr_rnd_t rnd, K) const {
+    x_.eval(r, rnd);
+    mpfr_neg(r, r, rnd);
+  }
+};
+
+// patterns recognized by floatmp_expr_binary
+constexpr int floatmp_expr_generic = 0;
+constexpr int floatmp_expr_fma = 1;  // x * y + z
+constexpr int floatmp_expr_fma_ = 2; // z + x * y
+constexpr int floatmp_expr_fms = 3;  // x * y - z
+constexpr int floatmp_expr_fms_ = 4; // z - x * y
+constexpr int floatmp_expr_fmma = 5; // x * y + u * v
+constexpr int floatmp_expr_fmms = 6; // x * y - u * v
+
+template <typename Op, typename L, typename R> class floatmp_expr_binary;
+
+template <typename E> struct floatmp_expr_is_product : std::false_type {};
+template <typename L, typename R>
+struct floatmp_expr_is_product<floatmp_expr_binary<floatmp_expr_mul, L, R>>
+    : std::integral_constant<bool, (L::kind == floatmp_expr_mpfr_kind) &&
+                                       (R::kind == floatmp_expr_mpfr_kind)> {};
+
+template <typename Op, typename L, typename R>
+constexpr int floatmp_expr_pattern() {
+#if MPFR_VERSION_MAJOR >= 4
+  if (floatmp_expr_is_product<L>::value && floatmp_expr_is_product<R>::value)
+    return std::is_same<Op, floatmp_expr_add>::value
+               ? floatmp_expr_fmma
+               : (std::is_same<Op, floatmp_expr_sub>::value
+                      ? floatmp_expr_fmms
+                      : floatmp_expr_generic);
+#endif
+  if (std::is_same<Op, floatmp_expr_add>::value) {
+    if (floatmp_expr_is_product<L>::value)
+      return floatmp_expr_fma;
+    if (floatmp_expr_is_product<R>::value)
+      return floatmp_expr_fma_;
+  } else if (std::is_same<Op, floatmp_expr_sub>::value) {
+    if (floatmp_expr_is_product<L>::value)
+      return floatmp_expr_fms;
+    if (floatmp_expr_is_product<R>::value)
+      return floatmp_expr_fms_;
+  }
+  return floatmp_expr_generic;
+}
+
+// inner node: x op y
+template <typename Op, typename L, typename R> class floatmp_expr_binary {
+public:
+  static constexpr std::size_t precision =
+      (L::precision > R::precision) ? L::precision : R::precision;
+  static constexpr int kind = floatmp_expr_tree_kind;
+  static constexpr int pattern = floatmp_expr_pattern<Op, L, R>();
+  static constexpr bool single_pass =
+      ((L::kind != floatmp_expr_tree_kind) &&
+       (R::kind != floatmp_expr_tree_kind)) ||
+      ((pattern == floatmp_expr_fmma) || (pattern == floatmp_expr_fmms)) ||
+      (((pattern == floatmp_expr_fma) || (pattern == floatmp_expr_fms)) &&
+       (R::kind == floatmp_expr_mpfr_kind)) ||
+      (((pattern == floatmp_expr_fma_) || (pattern == floatmp_expr_fms_)) &&
+       (L::kind == floatmp_expr_mpfr_kind));
+  floatmp_expr_binary(const L &x, const R &y) : x_(x), y_(y) {}
+  const L &lhs() const noexcept { return x_; }
+  const R &rhs() const noexcept { return y_; }
+  bool aliases(mpfr_srcptr x) const noexcept {
+    return x_.aliases(x) || y_.aliases(x);
+  }
+  void eval(mpfr_ptr r, mpfr_rnd_t rnd) const {
+    eval_(r, rnd, floatmp_expr_kind_t<pattern>());
+  }
+
+private:
+  L x_;
+  R y_;
+
+  static mpfr_rnd_t opposite_(mpfr_rnd_t rnd) noexcept {
+    return (rnd == MPFR_RNDU) ? MPFR_RNDD
+                              : ((rnd == MPFR_RNDD) ? MPFR_RNDU : rnd);
+  }
+  void eval_(mpfr_ptr r, mpfr_rnd_t rnd,
+             floatmp_expr_kind_t<floatmp_expr_generic>) const {
+    eval_(r, rnd, floatmp_expr_kind_t<L::kind>(),
+          floatmp_expr_kind_t<R::kind>());
+  }
+  void eval_(mpfr_ptr r, mpfr_rnd_t rnd,
+             floatmp_expr_kind_t<floatmp_expr_fma>) const {
+    with_mpfr_(r, y_, rnd, floatmp_expr_kind_t<R::kind>(), [&](mpfr_srcptr z) {
+      mpfr_fma(r, x_.lhs().operand(), x_.rhs().operand(), z, rnd);
+    });
+  }
+  void eval_(mpfr_ptr r, mpfr_rnd_t rnd,
+             floatmp_expr_kind_t<floatmp_expr_fma_>) const {
+    with_mpfr_(r, x_, rnd, floatmp_expr_kind_t<L::kind>(), [&](mpfr_srcptr z) {
+      mpfr_fma(r, y_.lhs().operand(), y_.rhs().operand(), z, rnd);
+    });
+  }
+  void eval_(mpfr_ptr r, mpfr_rnd_t rnd,
+             floatmp_expr_kind_t<floatmp_expr_fms>) const {
+    with_mpfr_(r, y_, rnd, floatmp_expr_kind_t<R::kind>(), [&](mpfr_srcptr z) {
+      mpfr_fms(r, x_.lhs().operand(), x_.rhs().operand(), z, rnd);
+    });
+  }
+  void eval_(mpfr_ptr r, mpfr_rnd_t rnd,
+             floatmp_expr_kind_t<floatmp_expr_fms_>) const {
+    // z - x * y = -(x * y - z); the opposite rounding keeps the direction
+    with_mpfr_(r, x_, rnd, floatmp_expr_kind_t<L::kind>(), [&](mpfr_srcptr z) {
+      mpfr_fms(r, y_.lhs().operand(), y_.rhs().operand(), z, opposite_(rnd));
+    });
+    mpfr_neg(r, r, rnd);
+  }
+#if MPFR_VERSION_MAJOR >= 4
+  void eval_(mpfr_ptr r, mpfr_rnd_t rnd,
+             floatmp_expr_kind_t<floatmp_expr_fmma>) const {
+    mpfr_fmma(r, x_.lhs().operand(), x_.rhs().operand(), y_.lhs().operand(),
+              y_.rhs().operand(), rnd);
+  }
+  void eval_(mpfr_ptr r, mpfr_rnd_t rnd,
+             floatmp_expr_kind_t<floatmp_expr_fmms>) const {
+    mpfr_fmms(r, x_.lhs().operand(), x_.rhs().operand(), y_.lhs().operand(),
+              y_.rhs().operand(), rnd);
+  }
+#endif // MPFR_VERSION_MAJOR
+
+  // the operand z of fma/fms as an MPFR value
+  template <typename E, typename F>
+  static void with_mpfr_(mpfr_ptr, const E &z, mpfr_rnd_t,
+                         floatmp_expr_kind_t<floatmp_expr_mpfr_kind>, F fun) {
+    fun(z.operand());
+  }
+  template <typename E, typename F>
+  static void with_mpfr_(mpfr_ptr, const E &z, mpfr_rnd_t rnd,
+                         floatmp_expr_kind_t<floatmp_expr_scalar_kind>,
+                         F fun) {
+    typedef typename std::decay<decltype(z.operand())>::type __type;
+    floatmp_scratch<floatmp_expr_scalar_traits<__type>::precision> __z;
+    z.eval(__z, rnd);
+    fun(__z);
+  }
+  template <typename E, typename F>
+  static void with_mpfr_(mpfr_ptr r, const E &z, mpfr_rnd_t rnd,
+                         floatmp_expr_kind_t<floatmp_expr_tree_kind>, F fun) {
+    z.eval(r, rnd);
+    fun(r);
+  }
+
+  // generic evaluation
+  template <typename KL, typename KR>
+  void eval_(mpfr_ptr r, mpfr_rnd_t rnd, KL, KR) const {
+    Op::apply(r, x_.operand(), y_.operand(), rnd);
+  }
+  template <typename KR>
+  void eval_(mpfr_ptr r, mpfr_rnd_t rnd,
+             floatmp_expr_kind_t<floatmp_expr_tree_kind>, KR) const {
+    x_.eval(r, rnd);
+    Op::apply(r, static_cast<mpfr_srcptr>(r), y_.operand(), rnd);
+  }
+  template <typename KL>
+  void eval_(mpfr_ptr r, mpfr_rnd_t rnd, KL,
+             floatmp_expr_kind_t<floatmp_expr_tree_kind>) const {
+    y_.eval(r, rnd);
+    Op::apply(r, x_.operand(), static_cast<mpfr_srcptr>(r), rnd);
+  }
+  void eval_(mpfr_ptr r, mpfr_rnd_t rnd,
+             floatmp_expr_kind_t<floatmp_expr_tree_kind>,
+             floatmp_expr_kind_t<floatmp_expr_tree_kind>) const {
+    floatmp_scratch<precision> __y;
+    x_.eval(r, rnd);
+    y_.eval(__y, rnd);
+    Op::apply(r, static_cast<mpfr_srcptr>(r), static_cast<mpfr_srcptr>(__y),
+              rnd);
+  }
+};
+
+// the node of the expression tree that represents a given operand
+template <typename T> struct floatmp_expr_node {
+  typedef floatmp_expr_scalar<T> type;
+  static type make(const T &x) { return type(x); }
+};
+template <std::size_t P, typename R> struct floatmp_expr_node<floatmp<P, R>> {
+  typedef floatmp_expr_ref<P, R> type;
+  static type make(const floatmp<P, R> &x) { return type(x); }
+};
+template <typename E> struct floatmp_expr_node<floatmp_expr<E>> {
+  typedef E type;
+  static const type &make(const floatmp_expr<E> &x) { return x.expr(); }
+};
+template <> struct floatmp_expr_node<mpfr_t> {
+  typedef floatmp_expr_mpfr type;
+  static type make(const mpfr_t &x) { return type(x); }
+};
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+template <typename E> class floatmp_expr {
+public:
+  explicit floatmp_expr(const E &x) : expr_(x) {}
+  static constexpr std::size_t precision() noexcept { return E::precision; }
+  floatmp<E::precision> eval() const { return floatmp<E::precision>(*this); }
+  void evaluate(mpfr_t &x) const { evaluate(x, floatmp_base::mpfr_rnd_()); }
+  void evaluate(mpfr_t &x, mpfr_rnd_t rnd) const;
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+  const E &expr() const noexcept { return expr_; }
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+private:
+  E expr_;
+}; // class floatmp_expr
+
+template <typename E>
+void floatmp_expr<E>::evaluate(mpfr_t &x, mpfr_rnd_t rnd) const {
+  if (E::single_pass || ((static_cast<std::size_t>(mpfr_get_prec(x)) >=
+                          E::precision) &&
+                         !expr_.aliases(x)))
+    expr_.eval(x, rnd);
+  else {
+    // the result of an expression that reads x (or an expression evaluated
+    // with a lower precision) goes through an intermediate register
+    floatmp_scratch<E::precision> __x;
+    expr_.eval(__x, rnd);
+    mpfr_set(x, __x, rnd);
+  }
+}
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+template <std::size_t Precision, typename Policy>
+template <typename E>
+floatmp<Precision, Policy> &
+floatmp<Precision, Policy>::operator+=(const floatmp_expr<E> &x) {
+  typedef floatmp_expr_binary<floatmp_expr_add,
+                              floatmp_expr_ref<Precision, Policy>, E>
+      __expr;
+  floatmp_expr<__expr>(
+      __expr(floatmp_expr_ref<Precision, Policy>(*this), x.expr()))
+      .evaluate(value_, rnd_());
+  return *this;
+}
+template <std::size_t Precision, typename Policy>
+template <typename E>
+floatmp<Precision, Policy> &
+floatmp<Precision, Policy>::operator-=(const floatmp_expr<E> &x) {
+  typedef floatmp_expr_binary<floatmp_expr_sub,
+                              floatmp_expr_ref<Precision, Policy>, E>
+      __expr;
+  floatmp_expr<__expr>(
+      __expr(floatmp_expr_ref<Precision, Policy>(*this), x.expr()))
+      .evaluate(value_, rnd_());
+  return *this;
+}
+template <std::size_t Precision, typename Policy>
+template <typename E>
+floatmp<Precision, Policy> &
+floatmp<Precision, Policy>::operator*=(const floatmp_expr<E> &x) {
+  typedef floatmp_expr_binary<floatmp_expr_mul,
+                              floatmp_expr_ref<Precision, Policy>, E>
+      __expr;
+  floatmp_expr<__expr>(
+      __expr(floatmp_expr_ref<Precision, Policy>(*this), x.expr()))
+      .evaluate(value_, rnd_());
+  return *this;
+}
+template <std::size_t Precision, typename Policy>
+template <typename E>
+floatmp<Precision, Policy> &
+floatmp<Precision, Policy>::operator/=(const floatmp_expr<E> &x) {
+  typedef floatmp_expr_binary<floatmp_expr_div,
+                              floatmp_expr_ref<Precision, Policy>, E>
+      __expr;
+  floatmp_expr<__expr>(
+      __expr(floatmp_expr_ref<Precision, Policy>(*this), x.expr()))
+      .evaluate(value_, rnd_());
+  return *this;
+}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
 /******************************************************************************/
 
 // operator==
-template <std::size_t P1, std::size_t P2>
-inline bool operator==(const floatmp<P1> &lhs, const floatmp<P2> &rhs) {
+template <std::size_t P1, typename R1, std::size_t P2, typename R2>
+inline bool operator==(const floatmp<P1, R1> &lhs, const floatmp<P2, R2> &rhs) {
   return lhs.equal_to(rhs);
 }
-template <typename T, std::size_t P>
-inline bool operator==(const floatmp<P> &lhs, const T &rhs) {
+template <typename T, std::size_t P, typename R>
+inline bool operator==(const floatmp<P, R> &lhs, const T &rhs) {
   return lhs.equal_to(rhs);
 }
-template <typename T, std::size_t P>
-inline bool operator==(const T &lhs, const floatmp<P> &rhs) {
+template <typename T, std::size_t P, typename R>
+inline bool operator==(const T &lhs, const floatmp<P, R> &rhs) {
   return rhs.equal_to(lhs);
 }
 
 // operator !=
-template <std::size_t P1, std::size_t P2>
-inline bool operator!=(const floatmp<P1> &lhs, const floatmp<P2> &rhs) {
+template <std::size_t P1, typename R1, std::size_t P2, typename R2>
+inline bool operator!=(const floatmp<P1, R1> &lhs, const floatmp<P2, R2> &rhs) {
   return !(lhs == rhs);
 }
-template <typename T, std::size_t P>
-inline bool operator!=(const floatmp<P> &lhs, const T &rhs) {
+template <typename T, std::size_t P, typename R>
+inline bool operator!=(const floatmp<P, R> &lhs, const T &rhs) {
   return !(lhs == rhs);
 }
-template <typename T, std::size_t P>
-inline bool operator!=(const T &lhs, const floatmp<P> &rhs) {
+template <typename T, std::size_t P, typename R>
+inline bool operator!=(const T &lhs, const floatmp<P, R> &rhs) {
   return !(lhs == rhs);
 }
 
 // operator <
-template <std::size_t P1, std::size_t P2>
-inline bool operator<(const floatmp<P1> &lhs, const floatmp<P2> &rhs) {
+template <std::size_t P1, typename R1, std::size_t P2, typename R2>
+inline bool operator<(const floatmp<P1, R1> &lhs, const floatmp<P2, R2> &rhs) {
   return lhs.less_than(rhs);
 }
-template <typename T, std::size_t P>
-inline bool operator<(const floatmp<P> &lhs, const T &rhs) {
+template <typename T, std::size_t P, typename R>
+inline bool operator<(const floatmp<P, R> &lhs, const T &rhs) {
   return lhs.less_than(rhs);
 }
-template <typename T, std::size_t P>
-inline bool operator<(const T &lhs, const floatmp<P> &rhs) {
-  return floatmp<P>(lhs).less_than(rhs);
+template <typename T, std::size_t P, typename R>
+inline bool operator<(const T &lhs, const floatmp<P, R> &rhs) {
+  return rhs.greater_than(lhs);
 }
 
 // operator >
-template <std::size_t P1, std::size_t P2>
-inline bool operator>(const floatmp<P1> &lhs, const floatmp<P2> &rhs) {
+template <std::size_t P1, typename R1, std::size_t P2, typename R2>
+inline bool operator>(const floatmp<P1, R1> &lhs, const floatmp<P2, R2> &rhs) {
   return rhs < lhs;
 }
-template <typename T, std::size_t P>
-inline bool operator>(const floatmp<P> &lhs, const T &rhs) {
+template <typename T, std::size_t P, typename R>
+inline bool operator>(const floatmp<P, R> &lhs, const T &rhs) {
   return rhs < lhs;
 }
-template <typename T, std::size_t P>
-inline bool operator>(const T &lhs, const floatmp<P> &rhs) {
+template <typename T, std::size_t P, typename R>
+inline bool operator>(const T &lhs, const floatmp<P, R> &rhs) {
   return rhs.less_than(lhs);
 }
 
 // operator <=
-template <std::size_t P1, std::size_t P2>
-inline bool operator<=(const floatmp<P1> &lhs, const floatmp<P2> &rhs) {
+template <std::size_t P1, typename R1, std::size_t P2, typename R2>
+inline bool operator<=(const floatmp<P1, R1> &lhs, const floatmp<P2, R2> &rhs) {
   return !(lhs > rhs);
 }
-template <typename T, std::size_t P>
-inline bool operator<=(const floatmp<P> &lhs, const T &rhs) {
+template <typename T, std::size_t P, typename R>
+inline bool operator<=(const floatmp<P, R> &lhs, const T &rhs) {
   return !(lhs > rhs);
 }
-template <typename T, std::size_t P>
-inline bool operator<=(const T &lhs, const floatmp<P> &rhs) {
+template <typename T, std::size_t P, typename R>
+inline bool operator<=(const T &lhs, const floatmp<P, R> &rhs) {
   return !(lhs > rhs);
 }
 
 // operator >=
-template <std::size_t P1, std::size_t P2>
-inline bool operator>=(const floatmp<P1> &lhs, const floatmp<P2> &rhs) {
+template <std::size_t P1, typename R1, std::size_t P2, typename R2>
+inline bool operator>=(const floatmp<P1, R1> &lhs, const floatmp<P2, R2> &rhs) {
   return !(lhs < rhs);
 }
-template <typename T, std::size_t P>
-inline bool operator>=(const floatmp<P> &lhs, const T &rhs) {
+template <typename T, std::size_t P, typename R>
+inline bool operator>=(const floatmp<P, R> &lhs, const T &rhs) {
   return !(lhs < rhs);
 }
-template <typename T, std::size_t P>
-inline bool operator>=(const T &lhs, const floatmp<P> &rhs) {
+template <typename T, std::size_t P, typename R>
+inline bool operator>=(const T &lhs, const floatmp<P, R> &rhs) {
   return !(lhs < rhs);
 }
 
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
-#define __TEUTHID_FLOATMP_ARITHMETIC_SPEC(OPER, FUN)                           \
-  template <std::size_t P1, std::size_t P2>                                    \
-  inline auto OPER(const floatmp<P1> &lhs, const floatmp<P2> &rhs) {           \
-    return floatmp<std::max(P1, P2)>(lhs).FUN(rhs);                            \
+template <typename Op, typename L, typename R>
+inline floatmp_expr<floatmp_expr_binary<Op, typename floatmp_expr_node<L>::type,
+                                        typename floatmp_expr_node<R>::type>>
+make_floatmp_expr(const L &lhs, const R &rhs) {
+  typedef floatmp_expr_binary<Op, typename floatmp_expr_node<L>::type,
+                              typename floatmp_expr_node<R>::type>
+      __expr;
+  return floatmp_expr<__expr>(__expr(floatmp_expr_node<L>::make(lhs),
+                                     floatmp_expr_node<R>::make(rhs)));
+}
+
+// arithmetic operators build expressions evaluated on assignment
+#define __TEUTHID_FLOATMP_ARITHMETIC_SPEC(OPER, OP)                            \
+  template <std::size_t P1, typename R1, std::size_t P2, typename R2>          \
+  inline auto OPER(const floatmp<P1, R1> &lhs, const floatmp<P2, R2> &rhs) {   \
+    return make_floatmp_expr<OP>(lhs, rhs);                                    \
+  }                                                                            \
+  template <std::size_t P, typename R, typename E>                             \
+  inline auto OPER(const floatmp<P, R> &lhs, const floatmp_expr<E> &rhs) {     \
+    return make_floatmp_expr<OP>(lhs, rhs);                                    \
   }                                                                            \
-  template <typename T, std::size_t P>                                         \
-  inline auto OPER(const floatmp<P> &lhs, const T &rhs) {                      \
-    return floatmp<P>(lhs).FUN(rhs);                                           \
+  template <typename E, std::size_t P, typename R>                             \
+  inline auto OPER(const floatmp_expr<E> &lhs, const floatmp<P, R> &rhs) {     \
+    return make_floatmp_expr<OP>(lhs, rhs);                                    \
   }                                                                            \
-  template <typename T, std::size_t P>                                         \
-  inline auto OPER(const T &lhs, const floatmp<P> &rhs) {                      \
-    return floatmp<P>(lhs).FUN(rhs);                                           \
-  }
-__TEUTHID_FLOATMP_ARITHMETIC_SPEC(operator+, add)
-__TEUTHID_FLOATMP_ARITHMETIC_SPEC(operator-, sub)
-__TEUTHID_FLOATMP_ARITHMETIC_SPEC(operator*, mul)
-__TEUTHID_FLOATMP_ARITHMETIC_SPEC(operator/, div)
+  template <typename E1, typename E2>                                          \
+  inline auto OPER(const floatmp_expr<E1> &lhs, const floatmp_expr<E2> &rhs) { \
+    return make_floatmp_expr<OP>(lhs, rhs);                                    \
+  }                                                                            \
+  template <typename T, std::size_t P, typename R>                             \
+  inline auto OPER(const floatmp<P, R> &lhs, const T &rhs) {                   \
+    return make_floatmp_expr<OP>(lhs, rhs);                                    \
+  }                                                                            \
+  template <typename T, std::size_t P, typename R>                             \
+  inline auto OPER(const T &lhs, const floatmp<P, R> &rhs) {                   \
+    return make_floatmp_expr<OP>(lhs, rhs);                                    \
+  }                                                                            \
+  template <typename T, typename E>                                            \
+  inline auto OPER(const floatmp_expr<E> &lhs, const T &rhs) {                 \
+    return make_floatmp_expr<OP>(lhs, rhs);                                    \
+  }                                                                            \
+  template <typename T, typename E>                                            \
+  inline auto OPER(const T &lhs, const floatmp_expr<E> &rhs) {                 \
+    return make_floatmp_expr<OP>(lhs, rhs);                                    \
+  }
+__TEUTHID_FLOATMP_ARITHMETIC_SPEC(operator+, floatmp_expr_add)
+__TEUTHID_FLOATMP_ARITHMETIC_SPEC(operator-, floatmp_expr_sub)
+__TEUTHID_FLOATMP_ARITHMETIC_SPEC(operator*, floatmp_expr_mul)
+__TEUTHID_FLOATMP_ARITHMETIC_SPEC(operator/, floatmp_expr_div)
 #undef __TEUTHID_FLOATMP_ARITHMETIC_SPEC
+
+// comparisons of expressions evaluate them at their own precision
+#define __TEUTHID_FLOATMP_EXPR_COMPARISON_SPEC(OPER)                           \
+  template <std::size_t P, typename R, typename E>                             \
+  inline bool OPER(const floatmp<P, R> &lhs, const floatmp_expr<E> &rhs) {     \
+    return OPER(lhs, rhs.eval());                                              \
+  }                                                                            \
+  template <typename E, std::size_t P, typename R>                             \
+  inline bool OPER(const floatmp_expr<E> &lhs, const floatmp<P, R> &rhs) {     \
+    return OPER(lhs.eval(), rhs);                                              \
+  }                                                                            \
+  template <typename E1, typename E2>                                          \
+  inline bool OPER(const floatmp_expr<E1> &lhs, const floatmp_expr<E2> &rhs) { \
+    return OPER(lhs.eval(), rhs.eval());                                       \
+  }                                                                            \
+  template <typename T, typename E>                                            \
+  inline bool OPER(const floatmp_expr<E> &lhs, const T &rhs) {                 \
+    return OPER(lhs.eval(), rhs);                                              \
+  }                                                                            \
+  template <typename T, typename E>                                            \
+  inline bool OPER(const T &lhs, const floatmp_expr<E> &rhs) {                 \
+    return OPER(lhs, rhs.eval());                                              \
+  }
+__TEUTHID_FLOATMP_EXPR_COMPARISON_SPEC(operator==)
+__TEUTHID_FLOATMP_EXPR_COMPARISON_SPEC(operator!=)
+__TEUTHID_FLOATMP_EXPR_COMPARISON_SPEC(operator<)
+__TEUTHID_FLOATMP_EXPR_COMPARISON_SPEC(operator>)
+__TEUTHID_FLOATMP_EXPR_COMPARISON_SPEC(operator<=)
+__TEUTHID_FLOATMP_EXPR_COMPARISON_SPEC(operator>=)
+#undef __TEUTHID_FLOATMP_EXPR_COMPARISON_SPEC
+
+template <typename E> inline auto operator-(const floatmp_expr<E> &x) {
+  return floatmp_expr<floatmp_expr_negate<E>>(
+      floatmp_expr_negate<E>(x.expr()));
+}
 #endif // DOXYGEN_SHOULD_SKIP_THIS
 } // namespace teuthid
 
 /******************************************************************************/
 
 namespace std {
-template <size_t P1, size_t P2>
-inline void swap(teuthid::floatmp<P1> &x, teuthid::floatmp<P2> &y) {
+template <size_t P1, typename R1, size_t P2, typename R2>
+inline void swap(teuthid::floatmp<P1, R1> &x, teuthid::floatmp<P2, R2> &y) {
   x.swap(y);
 }
-template <size_t P> inline auto abs(const teuthid::floatmp<P> &x) {
-  return teuthid::floatmp<P>().abs(x);
-}
-template <size_t P> inline auto fabs(const teuthid::floatmp<P> &x) {
-  return teuthid::floatmp<P>().abs(x);
-}
-template <size_t P1, size_t P2>
-inline auto fmod(const teuthid::floatmp<P1> &x, const teuthid::floatmp<P2> &y) {
-  return teuthid::floatmp<std::max(P1, P2)>().fmod(x, y);
-}
-template <size_t P1, size_t P2>
-inline auto remainder(const teuthid::floatmp<P1> &x,
-                      const teuthid::floatmp<P2> &y) {
-  return teuthid::floatmp<std::max(P1, P2)>().remainder(x, y);
-}
-template <size_t P1, size_t P2, size_t P3>
-inline auto fma(const teuthid::floatmp<P1> &x, const teuthid::floatmp<P2> &y,
-                const teuthid::floatmp<P3> &z) {
-  return teuthid::floatmp<std::max(std::max(P1, P2), P3)>().fma(x, y, z);
-}
-template <size_t P1, size_t P2>
-inline auto fmax(const teuthid::floatmp<P1> &x, const teuthid::floatmp<P2> &y) {
-  return teuthid::floatmp<std::max(P1, P2)>().fmax(x, y);
-}
-template <size_t P1, size_t P2>
-inline auto fmin(const teuthid::floatmp<P1> &x, const teuthid::floatmp<P2> &y) {
-  return teuthid::floatmp<std::max(P1, P2)>().fmin(x, y);
-}
-template <size_t P1, size_t P2>
-inline auto fdim(const teuthid::floatmp<P1> &x, const teuthid::floatmp<P2> &y) {
-  return teuthid::floatmp<std::max(P1, P2)>().fdim(x, y);
-}
-template <size_t P> inline auto exp(const teuthid::floatmp<P> &x) {
-  return teuthid::floatmp<P>().exp(x);
-}
-template <size_t P> inline auto exp2(const teuthid::floatmp<P> &x) {
-  return teuthid::floatmp<P>().exp2(x);
-}
-template <size_t P> inline auto expm1(const teuthid::floatmp<P> &x) {
-  return teuthid::floatmp<P>().expm1(x);
-}
-template <size_t P> inline auto log(const teuthid::floatmp<P> &x) {
-  return teuthid::floatmp<P>().log(x);
-}
-template <size_t P> inline auto log10(const teuthid::floatmp<P> &x) {
-  return teuthid::floatmp<P>().log10(x);
-}
-template <size_t P> inline auto log2(const teuthid::floatmp<P> &x) {
-  return teuthid::floatmp<P>().log2(x);
-}
-template <size_t P> inline auto log1p(const teuthid::floatmp<P> &x) {
-  return teuthid::floatmp<P>().log1p(x);
-}
-template <size_t P1, std::size_t P2>
-inline auto pow(const teuthid::floatmp<P1> &x, const teuthid::floatmp<P2> &y) {
-  return teuthid::floatmp<std::max(P1, P2)>().pow(x, y);
-}
-template <size_t P> inline auto sqrt(const teuthid::floatmp<P> &x) {
-  return teuthid::floatmp<P>().sqrt(x);
-}
-template <size_t P> inline auto cbrt(const teuthid::floatmp<P> &x) {
-  return teuthid::floatmp<P>().cbrt(x);
-}
-template <size_t P1, size_t P2>
-inline auto hypot(const teuthid::floatmp<P1> &x,
-                  const teuthid::floatmp<P2> &y) {
-  return teuthid::floatmp<std::max(P1, P2)>().hypot(x, y);
-}
-template <size_t P> inline auto sin(const teuthid::floatmp<P> &x) {
-  return teuthid::floatmp<P>().sin(x);
-}
-template <size_t P> inline auto cos(const teuthid::floatmp<P> &x) {
-  return teuthid::floatmp<P>().cos(x);
-}
-template <size_t P> inline auto tan(const teuthid::floatmp<P> &x) {
-  return teuthid::floatmp<P>().tan(x);
-}
-template <size_t P> inline auto asin(const teuthid::floatmp<P> &x) {
-  return teuthid::floatmp<P>().asin(x);
-}
-template <size_t P> inline auto acos(const teuthid::floatmp<P> &x) {
-  return teuthid::floatmp<P>().acos(x);
-}
-template <size_t P> inline auto atan(const teuthid::floatmp<P> &x) {
-  return teuthid::floatmp<P>().atan(x);
-}
-template <size_t P1, size_t P2>
-inline auto atan2(const teuthid::floatmp<P1> &x,
-                  const teuthid::floatmp<P2> &y) {
-  return teuthid::floatmp<std::max(P1, P2)>().atan2(x, y);
-}
-template <size_t P> inline auto sinh(const teuthid::floatmp<P> &x) {
-  return teuthid::floatmp<P>().sinh(x);
-}
-template <size_t P> inline auto cosh(const teuthid::floatmp<P> &x) {
-  return teuthid::floatmp<P>().cosh(x);
-}
-template <size_t P> inline auto tanh(const teuthid::floatmp<P> &x) {
-  return teuthid::floatmp<P>().tanh(x);
-}
-template <size_t P> inline auto asinh(const teuthid::floatmp<P> &x) {
-  return teuthid::floatmp<P>().asinh(x);
-}
-template <size_t P> inline auto acosh(const teuthid::floatmp<P> &x) {
-  return teuthid::floatmp<P>().acosh(x);
-}
-template <size_t P> inline auto atanh(const teuthid::floatmp<P> &x) {
-  return teuthid::floatmp<P>().atanh(x);
-}
-template <size_t P> inline auto erf(const teuthid::floatmp<P> &x) {
-  return teuthid::floatmp<P>().erf(x);
-}
-template <size_t P> inline auto erfc(const teuthid::floatmp<P> &x) {
-  return teuthid::floatmp<P>().erfc(x);
-}
-template <size_t P> inline auto tgamma(const teuthid::floatmp<P> &x) {
-  return teuthid::floatmp<P>().tgamma(x);
-}
-template <size_t P> inline auto lgamma(const teuthid::floatmp<P> &x) {
-  return teuthid::floatmp<P>().lgamma(x);
-}
-template <size_t P> inline auto ceil(const teuthid::floatmp<P> &x) {
-  return teuthid::floatmp<P>().ceil(x);
-}
-template <size_t P> inline auto floor(const teuthid::floatmp<P> &x) {
-  return teuthid::floatmp<P>().floor(x);
-}
-template <size_t P> inline auto trunc(const teuthid::floatmp<P> &x) {
-  return teuthid::floatmp<P>().trunc(x);
-}
-template <size_t P> inline auto round(const teuthid::floatmp<P> &x) {
-  return teuthid::floatmp<P>().round(x);
-}
-template <size_t P> inline long lround(const teuthid::floatmp<P> &x) {
-  return mpfr_get_si(x.c_mpfr(), static_cast<mpfr_rnd_t>(
-                                     teuthid::floatmp_base::rounding_mode()));
-}
-template <size_t P> inline long long llround(const teuthid::floatmp<P> &x) {
-  return mpfr_get_sj(x.c_mpfr(), static_cast<mpfr_rnd_t>(
-                                     teuthid::floatmp_base::rounding_mode()));
-}
-template <size_t P> inline auto nearbyint(const teuthid::floatmp<P> &x) {
-  return teuthid::floatmp<P>().nearbyint(x);
-}
-template <size_t P> inline auto rint(const teuthid::floatmp<P> &x) {
-  return teuthid::floatmp<P>().nearbyint(x);
-}
-template <size_t P1, size_t P2>
-inline auto nextafter(const teuthid::floatmp<P1> &x,
-                      const teuthid::floatmp<P2> &y) {
-  return teuthid::floatmp<std::max(P1, P2)>().nextafter(x, y);
-}
-template <size_t P>
-inline auto nexttoward(const teuthid::floatmp<P> &x, long double y) {
-  return teuthid::floatmp<P>().nextafter(x, teuthid::floatmp<P>(y));
+template <size_t P, typename R>
+inline void swap(teuthid::floatmp<P, R> &x,
+                 teuthid::floatmp<P, R> &y) noexcept {
+  x.swap(y);
 }
-template <size_t P> inline bool isfinite(const teuthid::floatmp<P> &x) {
+template <size_t P, typename R>
+inline auto abs(const teuthid::floatmp<P, R> &x) {
+  teuthid::floatmp<P, R> __r;
+  __r.abs(x);
+  return __r;
+}
+template <size_t P, typename R>
+inline auto fabs(const teuthid::floatmp<P, R> &x) {
+  teuthid::floatmp<P, R> __r;
+  __r.abs(x);
+  return __r;
+}
+template <size_t P1, typename R1, size_t P2, typename R2>
+inline auto fmod(const teuthid::floatmp<P1, R1> &x,
+                 const teuthid::floatmp<P2, R2> &y) {
+  teuthid::floatmp<std::max(P1, P2), R1> __r;
+  __r.fmod(x, y);
+  return __r;
+}
+template <size_t P1, typename R1, size_t P2, typename R2>
+inline auto remainder(const teuthid::floatmp<P1, R1> &x,
+                      const teuthid::floatmp<P2, R2> &y) {
+  teuthid::floatmp<std::max(P1, P2), R1> __r;
+  __r.remainder(x, y);
+  return __r;
+}
+template <size_t P1, typename R1, size_t P2, typename R2, size_t P3,
+          typename R3>
+inline auto fma(const teuthid::floatmp<P1, R1> &x,
+                const teuthid::floatmp<P2, R2> &y,
+                const teuthid::floatmp<P3, R3> &z) {
+  teuthid::floatmp<std::max(std::max(P1, P2), P3), R1> __r;
+  __r.fma(x, y, z);
+  return __r;
+}
+template <size_t P1, typename R1, size_t P2, typename R2>
+inline auto fmax(const teuthid::floatmp<P1, R1> &x,
+                 const teuthid::floatmp<P2, R2> &y) {
+  teuthid::floatmp<std::max(P1, P2), R1> __r;
+  __r.fmax(x, y);
+  return __r;
+}
+template <size_t P1, typename R1, size_t P2, typename R2>
+inline auto fmin(const teuthid::floatmp<P1, R1> &x,
+                 const teuthid::floatmp<P2, R2> &y) {
+  teuthid::floatmp<std::max(P1, P2), R1> __r;
+  __r.fmin(x, y);
+  return __r;
+}
+template <size_t P1, typename R1, size_t P2, typename R2>
+inline auto fdim(const teuthid::floatmp<P1, R1> &x,
+                 const teuthid::floatmp<P2, R2> &y) {
+  teuthid::floatmp<std::max(P1, P2), R1> __r;
+  __r.fdim(x, y);
+  return __r;
+}
+template <size_t P, typename R>
+inline auto exp(const teuthid::floatmp<P, R> &x) {
+  teuthid::floatmp<P, R> __r;
+  __r.exp(x);
+  return __r;
+}
+template <size_t P, typename R>
+inline auto exp2(const teuthid::floatmp<P, R> &x) {
+  teuthid::floatmp<P, R> __r;
+  __r.exp2(x);
+  return __r;
+}
+template <size_t P, typename R>
+inline auto expm1(const teuthid::floatmp<P, R> &x) {
+  teuthid::floatmp<P, R> __r;
+  __r.expm1(x);
+  return __r;
+}
+template <size_t P, typename R>
+inline auto log(const teuthid::floatmp<P, R> &x) {
+  teuthid::floatmp<P, R> __r;
+  __r.log(x);
+  return __r;
+}
+template <size_t P, typename R>
+inline auto log10(const teuthid::floatmp<P, R> &x) {
+  teuthid::floatmp<P, R> __r;
+  __r.log10(x);
+  return __r;
+}
+template <size_t P, typename R>
+inline auto log2(const teuthid::floatmp<P, R> &x) {
+  teuthid::floatmp<P, R> __r;
+  __r.log2(x);
+  return __r;
+}
+template <size_t P, typename R>
+inline auto log1p(const teuthid::floatmp<P, R> &x) {
+  teuthid::floatmp<P, R> __r;
+  __r.log1p(x);
+  return __r;
+}
+template <size_t P1, typename R1, std::size_t P2, typename R2>
+inline auto pow(const teuthid::floatmp<P1, R1> &x,
+                const teuthid::floatmp<P2, R2> &y) {
+  teuthid::floatmp<std::max(P1, P2), R1> __r;
+  __r.pow(x, y);
+  return __r;
+}
+template <size_t P, typename R>
+inline auto sqrt(const teuthid::floatmp<P, R> &x) {
+  teuthid::floatmp<P, R> __r;
+  __r.sqrt(x);
+  return __r;
+}
+template <size_t P, typename R>
+inline auto cbrt(const teuthid::floatmp<P, R> &x) {
+  teuthid::floatmp<P, R> __r;
+  __r.cbrt(x);
+  return __r;
+}
+template <size_t P1, typename R1, size_t P2, typename R2>
+inline auto hypot(const teuthid::floatmp<P1, R1> &x,
+                  const teuthid::floatmp<P2, R2> &y) {
+  teuthid::floatmp<std::max(P1, P2), R1> __r;
+  __r.hypot(x, y);
+  return __r;
+}
+template <size_t P, typename R>
+inline auto sin(const teuthid::floatmp<P, R> &x) {
+  teuthid::floatmp<P, R> __r;
+  __r.sin(x);
+  return __r;
+}
+template <size_t P, typename R>
+inline auto cos(const teuthid::floatmp<P, R> &x) {
+  teuthid::floatmp<P, R> __r;
+  __r.cos(x);
+  return __r;
+}
+template <size_t P, typename R>
+inline auto tan(const teuthid::floatmp<P, R> &x) {
+  teuthid::floatmp<P, R> __r;
+  __r.tan(x);
+  return __r;
+}
+template <size_t P, typename R>
+inline auto asin(const teuthid::floatmp<P, R> &x) {
+  teuthid::floatmp<P, R> __r;
+  __r.asin(x);
+  return __r;
+}
+template <size_t P, typename R>
+inline auto acos(const teuthid::floatmp<P, R> &x) {
+  teuthid::floatmp<P, R> __r;
+  __r.acos(x);
+  return __r;
+}
+template <size_t P, typename R>
+inline auto atan(const teuthid::floatmp<P, R> &x) {
+  teuthid::floatmp<P, R> __r;
+  __r.atan(x);
+  return __r;
+}
+template <size_t P1, typename R1, size_t P2, typename R2>
+inline auto atan2(const teuthid::floatmp<P1, R1> &x,
+                  const teuthid::floatmp<P2, R2> &y) {
+  teuthid::floatmp<std::max(P1, P2), R1> __r;
+  __r.atan2(x, y);
+  return __r;
+}
+template <size_t P, typename R>
+inline auto sinh(const teuthid::floatmp<P, R> &x) {
+  teuthid::floatmp<P, R> __r;
+  __r.sinh(x);
+  return __r;
+}
+template <size_t P, typename R>
+inline auto cosh(const teuthid::floatmp<P, R> &x) {
+  teuthid::floatmp<P, R> __r;
+  __r.cosh(x);
+  return __r;
+}
+template <size_t P, typename R>
+inline auto tanh(const teuthid::floatmp<P, R> &x) {
+  teuthid::floatmp<P, R> __r;
+  __r.tanh(x);
+  return __r;
+}
+template <size_t P, typename R>
+inline auto asinh(const teuthid::floatmp<P, R> &x) {
+  teuthid::floatmp<P, R> __r;
+  __r.asinh(x);
+  return __r;
+}
+template <size_t P, typename R>
+inline auto acosh(const teuthid::floatmp<P, R> &x) {
+  teuthid::floatmp<P, R> __r;
+  __r.acosh(x);
+  return __r;
+}
+template <size_t P, typename R>
+inline auto atanh(const teuthid::floatmp<P, R> &x) {
+  teuthid::floatmp<P, R> __r;
+  __r.atanh(x);
+  return __r;
+}
+template <size_t P, typename R>
+inline auto erf(const teuthid::floatmp<P, R> &x) {
+  teuthid::floatmp<P, R> __r;
+  __r.erf(x);
+  return __r;
+}
+template <size_t P, typename R>
+inline auto erfc(const teuthid::floatmp<P, R> &x) {
+  teuthid::floatmp<P, R> __r;
+  __r.erfc(x);
+  return __r;
+}
+template <size_t P, typename R>
+inline auto tgamma(const teuthid::floatmp<P, R> &x) {
+  teuthid::floatmp<P, R> __r;
+  __r.tgamma(x);
+  return __r;
+}
+template <size_t P, typename R>
+inline auto lgamma(const teuthid::floatmp<P, R> &x) {
+  teuthid::floatmp<P, R> __r;
+  __r.lgamma(x);
+  return __r;
+}
+template <size_t P, typename R>
+inline auto ceil(const teuthid::floatmp<P, R> &x) {
+  teuthid::floatmp<P, R> __r;
+  __r.ceil(x);
+  return __r;
+}
+template <size_t P, typename R>
+inline auto floor(const teuthid::floatmp<P, R> &x) {
+  teuthid::floatmp<P, R> __r;
+  __r.floor(x);
+  return __r;
+}
+template <size_t P, typename R>
+inline auto trunc(const teuthid::floatmp<P, R> &x) {
+  teuthid::floatmp<P, R> __r;
+  __r.trunc(x);
+  return __r;
+}
+template <size_t P, typename R>
+inline auto round(const teuthid::floatmp<P, R> &x) {
+  teuthid::floatmp<P, R> __r;
+  __r.round(x);
+  return __r;
+}
+// halfway cases are rounded away from zero, whatever the rounding mode
+template <size_t P, typename R>
+inline long lround(const teuthid::floatmp<P, R> &x) {
+  MPFR_DECL_INIT(__r, P);
+  mpfr_round(__r, x.c_mpfr());
+  return mpfr_get_si(__r, MPFR_RNDN);
+}
+template <size_t P, typename R>
+inline long long llround(const teuthid::floatmp<P, R> &x) {
+  MPFR_DECL_INIT(__r, P);
+  mpfr_round(__r, x.c_mpfr());
+  return mpfr_get_sj(__r, MPFR_RNDN);
+}
+template <size_t P, typename R>
+inline auto nearbyint(const teuthid::floatmp<P, R> &x) {
+  teuthid::floatmp<P, R> __r;
+  __r.nearbyint(x);
+  return __r;
+}
+template <size_t P, typename R>
+inline auto rint(const teuthid::floatmp<P, R> &x) {
+  teuthid::floatmp<P, R> __r;
+  __r.nearbyint(x);
+  return __r;
+}
+template <size_t P1, typename R1, size_t P2, typename R2>
+inline auto nextafter(const teuthid::floatmp<P1, R1> &x,
+                      const teuthid::floatmp<P2, R2> &y) {
+  teuthid::floatmp<std::max(P1, P2), R1> __r;
+  __r.nextafter(x, y);
+  return __r;
+}
+template <size_t P, typename R>
+inline auto nexttoward(const teuthid::floatmp<P, R> &x, long double y) {
+  teuthid::floatmp<P, R> __r;
+  __r.nextafter(x, teuthid::floatmp<P, R>(y));
+  return __r;
+}
+template <size_t P, typename R>
+inline bool isfinite(const teuthid::floatmp<P, R> &x) {
   return x.is_finite();
 }
-template <size_t P> inline bool isinf(const teuthid::floatmp<P> &x) {
+template <size_t P, typename R>
+inline bool isinf(const teuthid::floatmp<P, R> &x) {
   return x.is_infinite();
 }
-template <size_t P> inline bool isnan(const teuthid::floatmp<P> &x) {
+template <size_t P, typename R>
+inline bool isnan(const teuthid::floatmp<P, R> &x) {
   return x.is_nan();
 }
-template <size_t P> inline bool isnormal(const teuthid::floatmp<P> &x) {
+template <size_t P, typename R>
+inline bool isnormal(const teuthid::floatmp<P, R> &x) {
   return x.is_finite() && !x.is_zero();
 }
-template <size_t P> inline bool signbit(const teuthid::floatmp<P> &x) {
+template <size_t P, typename R>
+inline bool signbit(const teuthid::floatmp<P, R> &x) {
   return x.is_negative();
 }
-template <size_t P1, size_t P2>
-inline bool isgreater(const teuthid::floatmp<P1> &x,
-                      const teuthid::floatmp<P2> &y) {
+template <size_t P1, typename R1, size_t P2, typename R2>
+inline bool isgreater(const teuthid::floatmp<P1, R1> &x,
+                      const teuthid::floatmp<P2, R2> &y) {
   return x > y;
 }
-template <size_t P1, size_t P2>
-inline bool isgreaterequal(const teuthid::floatmp<P1> &x,
-                           const teuthid::floatmp<P2> &y) {
+template <size_t P1, typename R1, size_t P2, typename R2>
+inline bool isgreaterequal(const teuthid::floatmp<P1, R1> &x,
+                           const teuthid::floatmp<P2, R2> &y) {
   return x >= y;
 }
-template <size_t P1, size_t P2>
-inline bool isless(const teuthid::floatmp<P1> &x,
-                   const teuthid::floatmp<P2> &y) {
+template <size_t P1, typename R1, size_t P2, typename R2>
+inline bool isless(const teuthid::floatmp<P1, R1> &x,
+                   const teuthid::floatmp<P2, R2> &y) {
   return x < y;
 }
-template <size_t P1, size_t P2>
-inline bool islessequal(const teuthid::floatmp<P1> &x,
-                        const teuthid::floatmp<P2> &y) {
+template <size_t P1, typename R1, size_t P2, typename R2>
+inline bool islessequal(const teuthid::floatmp<P1, R1> &x,
+                        const teuthid::floatmp<P2, R2> &y) {
   return x <= y;
 }
-template <size_t P1, size_t P2>
-inline bool islessgreater(const teuthid::floatmp<P1> &x,
-                          const teuthid::floatmp<P2> &y) {
+template <size_t P1, typename R1, size_t P2, typename R2>
+inline bool islessgreater(const teuthid::floatmp<P1, R1> &x,
+                          const teuthid::floatmp<P2, R2> &y) {
   return (x < y) || (y < x);
 }
-template <size_t P1, size_t P2>
-inline bool isunordered(const teuthid::floatmp<P1> &x,
-                        const teuthid::floatmp<P2> &y) {
+template <size_t P1, typename R1, size_t P2, typename R2>
+inline bool isunordered(const teuthid::floatmp<P1, R1> &x,
+                        const teuthid::floatmp<P2, R2> &y) {
   return x.is_nan() || y.is_nan();
 }
 
-template <> template <size_t P> class numeric_limits<teuthid::floatmp<P>> {
-private:
-  static constexpr float_round_style round_style_() noexcept;
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+// math functions of expressions
+#define __TEUTHID_FLOATMP_EXPR_STD_SPEC(FUN)                                   \
+  template <typename E> inline auto FUN(const teuthid::floatmp_expr<E> &x) {   \
+    return std::FUN(x.eval());                                                 \
+  }
+__TEUTHID_FLOATMP_EXPR_STD_SPEC(abs)
+__TEUTHID_FLOATMP_EXPR_STD_SPEC(fabs)
+__TEUTHID_FLOATMP_EXPR_STD_SPEC(exp)
+__TEUTHID_FLOATMP_EXPR_STD_SPEC(exp2)
+__TEUTHID_FLOATMP_EXPR_STD_SPEC(expm1)
+__TEUTHID_FLOATMP_EXPR_STD_SPEC(log)
+__TEUTHID_FLOATMP_EXPR_STD_SPEC(log10)
+__TEUTHID_FLOATMP_EXPR_STD_SPEC(log2)
+__TEUTHID_FLOATMP_EXPR_STD_SPEC(log1p)
+__TEUTHID_FLOATMP_EXPR_STD_SPEC(sqrt)
+__TEUTHID_FLOATMP_EXPR_STD_SPEC(cbrt)
+__TEUTHID_FLOATMP_EXPR_STD_SPEC(sin)
+__TEUTHID_FLOATMP_EXPR_STD_SPEC(cos)
+__TEUTHID_FLOATMP_EXPR_STD_SPEC(tan)
+__TEUTHID_FLOATMP_EXPR_STD_SPEC(asin)
+__TEUTHID_FLOATMP_EXPR_STD_SPEC(acos)
+__TEUTHID_FLOATMP_EXPR_STD_SPEC(atan)
+__TEUTHID_FLOATMP_EXPR_STD_SPEC(sinh)
+__TEUTHID_FLOATMP_EXPR_STD_SPEC(cosh)
+__TEUTHID_FLOATMP_EXPR_STD_SPEC(tanh)
+__TEUTHID_FLOATMP_EXPR_STD_SPEC(asinh)
+__TEUTHID_FLOATMP_EXPR_STD_SPEC(acosh)
+__TEUTHID_FLOATMP_EXPR_STD_SPEC(atanh)
+__TEUTHID_FLOATMP_EXPR_STD_SPEC(erf)
+__TEUTHID_FLOATMP_EXPR_STD_SPEC(erfc)
+__TEUTHID_FLOATMP_EXPR_STD_SPEC(tgamma)
+__TEUTHID_FLOATMP_EXPR_STD_SPEC(lgamma)
+__TEUTHID_FLOATMP_EXPR_STD_SPEC(ceil)
+__TEUTHID_FLOATMP_EXPR_STD_SPEC(floor)
+__TEUTHID_FLOATMP_EXPR_STD_SPEC(trunc)
+__TEUTHID_FLOATMP_EXPR_STD_SPEC(round)
+__TEUTHID_FLOATMP_EXPR_STD_SPEC(lround)
+__TEUTHID_FLOATMP_EXPR_STD_SPEC(llround)
+__TEUTHID_FLOATMP_EXPR_STD_SPEC(nearbyint)
+__TEUTHID_FLOATMP_EXPR_STD_SPEC(rint)
+__TEUTHID_FLOATMP_EXPR_STD_SPEC(isfinite)
+__TEUTHID_FLOATMP_EXPR_STD_SPEC(isinf)
+__TEUTHID_FLOATMP_EXPR_STD_SPEC(isnan)
+__TEUTHID_FLOATMP_EXPR_STD_SPEC(isnormal)
+__TEUTHID_FLOATMP_EXPR_STD_SPEC(signbit)
+#undef __TEUTHID_FLOATMP_EXPR_STD_SPEC
+
+#define __TEUTHID_FLOATMP_EXPR_STD_SPEC(FUN)                                   \
+  template <typename E, size_t P, typename R>                                  \
+  inline auto FUN(const teuthid::floatmp_expr<E> &x,                           \
+                  const teuthid::floatmp<P, R> &y) {                           \
+    return std::FUN(x.eval(), y);                                              \
+  }                                                                            \
+  template <size_t P, typename R, typename E>                                  \
+  inline auto FUN(const teuthid::floatmp<P, R> &x,                             \
+                  const teuthid::floatmp_expr<E> &y) {                         \
+    return std::FUN(x, y.eval());                                              \
+  }                                                                            \
+  template <typename E1, typename E2>                                          \
+  inline auto FUN(const teuthid::floatmp_expr<E1> &x,                          \
+                  const teuthid::floatmp_expr<E2> &y) {                        \
+    return std::FUN(x.eval(), y.eval());                                       \
+  }
+__TEUTHID_FLOATMP_EXPR_STD_SPEC(fmod)
+__TEUTHID_FLOATMP_EXPR_STD_SPEC(remainder)
+__TEUTHID_FLOATMP_EXPR_STD_SPEC(fmax)
+__TEUTHID_FLOATMP_EXPR_STD_SPEC(fmin)
+__TEUTHID_FLOATMP_EXPR_STD_SPEC(fdim)
+__TEUTHID_FLOATMP_EXPR_STD_SPEC(pow)
+__TEUTHID_FLOATMP_EXPR_STD_SPEC(hypot)
+__TEUTHID_FLOATMP_EXPR_STD_SPEC(atan2)
+__TEUTHID_FLOATMP_EXPR_STD_SPEC(nextafter)
+#undef __TEUTHID_FLOATMP_EXPR_STD_SPEC
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+#ifdef TEUTHID_HAVE_QUADMATH
+// math functions of __float128 (libquadmath)
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+#define __TEUTHID_FLOAT128_STD_SPEC1(FUN, TYPE)                                \
+  inline TYPE FUN(__float128 x) { return FUN##q(x); }
+#define __TEUTHID_FLOAT128_STD_SPEC2(FUN)                                      \
+  inline __float128 FUN(__float128 x, __float128 y) { return FUN##q(x, y); }
+#if defined(__STRICT_ANSI__) || !defined(_GLIBCXX_USE_FLOAT128)
+inline __float128 abs(__float128 x) { return fabsq(x); }
+#endif
+__TEUTHID_FLOAT128_STD_SPEC1(fabs, __float128)
+__TEUTHID_FLOAT128_STD_SPEC2(fmod)
+__TEUTHID_FLOAT128_STD_SPEC2(remainder)
+inline __float128 fma(__float128 x, __float128 y, __float128 z) {
+  return fmaq(x, y, z);
+}
+__TEUTHID_FLOAT128_STD_SPEC2(fmax)
+__TEUTHID_FLOAT128_STD_SPEC2(fmin)
+__TEUTHID_FLOAT128_STD_SPEC2(fdim)
+__TEUTHID_FLOAT128_STD_SPEC1(exp, __float128)
+__TEUTHID_FLOAT128_STD_SPEC1(exp2, __float128)
+__TEUTHID_FLOAT128_STD_SPEC1(expm1, __float128)
+__TEUTHID_FLOAT128_STD_SPEC1(log, __float128)
+__TEUTHID_FLOAT128_STD_SPEC1(log10, __float128)
+__TEUTHID_FLOAT128_STD_SPEC1(log2, __float128)
+__TEUTHID_FLOAT128_STD_SPEC1(log1p, __float128)
+__TEUTHID_FLOAT128_STD_SPEC2(pow)
+__TEUTHID_FLOAT128_STD_SPEC1(sqrt, __float128)
+__TEUTHID_FLOAT128_STD_SPEC1(cbrt, __float128)
+__TEUTHID_FLOAT128_STD_SPEC2(hypot)
+__TEUTHID_FLOAT128_STD_SPEC1(sin, __float128)
+__TEUTHID_FLOAT128_STD_SPEC1(cos, __float128)
+__TEUTHID_FLOAT128_STD_SPEC1(tan, __float128)
+__TEUTHID_FLOAT128_STD_SPEC1(asin, __float128)
+__TEUTHID_FLOAT128_STD_SPEC1(acos, __float128)
+__TEUTHID_FLOAT128_STD_SPEC1(atan, __float128)
+__TEUTHID_FLOAT128_STD_SPEC2(atan2)
+__TEUTHID_FLOAT128_STD_SPEC1(sinh, __float128)
+__TEUTHID_FLOAT128_STD_SPEC1(cosh, __float128)
+__TEUTHID_FLOAT128_STD_SPEC1(tanh, __float128)
+__TEUTHID_FLOAT128_STD_SPEC1(asinh, __float128)
+__TEUTHID_FLOAT128_STD_SPEC1(acosh, __float128)
+__TEUTHID_FLOAT128_STD_SPEC1(atanh, __float128)
+__TEUTHID_FLOAT128_STD_SPEC1(erf, __float128)
+__TEUTHID_FLOAT128_STD_SPEC1(erfc, __float128)
+__TEUTHID_FLOAT128_STD_SPEC1(tgamma, __float128)
+__TEUTHID_FLOAT128_STD_SPEC1(lgamma, __float128)
+__TEUTHID_FLOAT128_STD_SPEC1(ceil, __float128)
+__TEUTHID_FLOAT128_STD_SPEC1(floor, __float128)
+__TEUTHID_FLOAT128_STD_SPEC1(trunc, __float128)
+__TEUTHID_FLOAT128_STD_SPEC1(round, __float128)
+__TEUTHID_FLOAT128_STD_SPEC1(lround, long)
+__TEUTHID_FLOAT128_STD_SPEC1(llround, long long)
+__TEUTHID_FLOAT128_STD_SPEC1(nearbyint, __float128)
+__TEUTHID_FLOAT128_STD_SPEC1(rint, __float128)
+__TEUTHID_FLOAT128_STD_SPEC2(nextafter)
+inline __float128 frexp(__float128 x, int *exp) { return frexpq(x, exp); }
+inline __float128 ldexp(__float128 x, int exp) { return ldexpq(x, exp); }
+inline bool isfinite(__float128 x) { return (finiteq(x) != 0); }
+inline bool isinf(__float128 x) { return (isinfq(x) != 0); }
+inline bool isnan(__float128 x) { return (isnanq(x) != 0); }
+inline bool signbit(__float128 x) { return (signbitq(x) != 0); }
+#undef __TEUTHID_FLOAT128_STD_SPEC1
+#undef __TEUTHID_FLOAT128_STD_SPEC2
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+#endif // TEUTHID_HAVE_QUADMATH
 
+template <size_t P, typename R> class numeric_limits<teuthid::floatmp<P, R>> {
 public:
   static constexpr bool is_specialized = true;
-  static constexpr teuthid::floatmp<P> min() noexcept {
-    return teuthid::floatmp<P>::min();
+  static constexpr teuthid::floatmp<P, R> min() noexcept {
+    return teuthid::floatmp<P, R>::min();
   }
-  static constexpr teuthid::floatmp<P> max() noexcept {
-    return teuthid::floatmp<P>::max();
+  static constexpr teuthid::floatmp<P, R> max() noexcept {
+    return teuthid::floatmp<P, R>::max();
   }
-  static constexpr teuthid::floatmp<P> lowest() noexcept {
-    return -(teuthid::floatmp<P>::max());
+  static constexpr teuthid::floatmp<P, R> lowest() noexcept {
+    return -(teuthid::floatmp<P, R>::max());
   }
   static constexpr int digits = P;
   static constexpr int digits10 = floor(log10(2) * P);
@@ -1051,11 +2538,11 @@ public:
   static constexpr bool is_integer = false;
   static constexpr bool is_exact = false;
   static constexpr int radix = 2;
-  static constexpr teuthid::floatmp<P> epsilon() noexcept {
-    return teuthid::floatmp<P>::epsilon();
+  static constexpr teuthid::floatmp<P, R> epsilon() noexcept {
+    return teuthid::floatmp<P, R>::epsilon();
   }
-  static constexpr teuthid::floatmp<P> round_error() noexcept {
-    return teuthid::floatmp<P>::round_error();
+  static constexpr teuthid::floatmp<P, R> round_error() noexcept {
+    return teuthid::floatmp<P, R>::round_error();
   }
   static constexpr int min_exponent = MPFR_EMIN_DEFAULT;
   static constexpr int min_exponent10 = floor(log10(2) * MPFR_EMIN_DEFAULT);
@@ -1066,43 +2553,26 @@ public:
   static constexpr bool has_signaling_NaN = true;
   static constexpr float_denorm_style has_denorm = denorm_absent;
   static constexpr bool has_denorm_loss = false;
-  static constexpr teuthid::floatmp<P> infinity() noexcept {
-    return teuthid::floatmp<P>::infinity();
+  static constexpr teuthid::floatmp<P, R> infinity() noexcept {
+    return teuthid::floatmp<P, R>::infinity();
   }
-  static constexpr teuthid::floatmp<P> quiet_NaN() noexcept {
-    return teuthid::floatmp<P>::nan();
+  static constexpr teuthid::floatmp<P, R> quiet_NaN() noexcept {
+    return teuthid::floatmp<P, R>::nan();
   }
-  static constexpr teuthid::floatmp<P> signaling_NaN() noexcept {
-    return teuthid::floatmp<P>::nan();
+  static constexpr teuthid::floatmp<P, R> signaling_NaN() noexcept {
+    return teuthid::floatmp<P, R>::nan();
   }
-  static constexpr teuthid::floatmp<P> denorm_min() noexcept {
-    return teuthid::floatmp<P>::min();
+  static constexpr teuthid::floatmp<P, R> denorm_min() noexcept {
+    return teuthid::floatmp<P, R>::min();
   }
   static constexpr bool is_iec559 = true;
   static constexpr bool is_bounded = true;
   static constexpr bool is_modulo = false;
   static constexpr bool traps = true;
   static constexpr bool tinyness_before = true;
-  static constexpr float_round_style round_style = round_style_();
-}; // class numeric_limits<teuthid::floatmp<P>>
-
-template <>
-template <size_t P>
-constexpr float_round_style
-numeric_limits<teuthid::floatmp<P>>::round_style_() noexcept {
-  switch (teuthid::floatmp_base::rounding_mode()) {
-  case teuthid::floatmp_round_t::round_to_nearest:
-    return round_to_nearest;
-  case teuthid::floatmp_round_t::round_toward_zero:
-    return round_toward_zero;
-  case teuthid::floatmp_round_t::round_toward_infinity:
-    return round_toward_infinity;
-  case teuthid::floatmp_round_t::round_toward_neg_infinity:
-    return round_toward_neg_infinity;
-  default:
-    return round_indeterminate;
-  }
-}
+  static constexpr float_round_style round_style =
+      R::rounding::round_style();
+}; // class numeric_limits<teuthid::floatmp<P, R>>
 } // namespace std
 
 #endif // TEUTHID_FLOATMP_HPP
\ No newline at end of file
@@ -0,0 +1,147 @@
+/*
+  This file is part of the Teuthid project.
+  Copyright (c) 2016-2017 Mariusz Przygodzki (mariusz.przygodzki@gmail.com)
+
+  The Teuthid is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or (at your
+  option) any later version.
+
+  The Teuthid is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+  FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+  for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with the Teuthid; see the file LICENSE.LGPLv3.  If not, see
+  <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef TEUTHID_FLOATMP_ACCUMULATOR_HPP
+#define TEUTHID_FLOATMP_ACCUMULATOR_HPP
+
+#include <stdexcept>
+#include <type_traits>
+
+#include <mpfr.h>
+#include <teuthid/floatmp.hpp>
+
+namespace teuthid {
+
+template <std::size_t Precision, typename Policy = floatmp_policy<>>
+class floatmp_accumulator {
+  TEUTHID_CHECK_FLOATMP_PRECISION(Precision);
+
+public:
+  typedef floatmp<Precision, Policy> value_type;
+
+  floatmp_accumulator() {
+    mpfr_init2(sum_, initial_precision_);
+    mpfr_set_zero(sum_, 1);
+  }
+  floatmp_accumulator(const floatmp_accumulator &x) {
+    mpfr_init2(sum_, mpfr_get_prec(x.sum_));
+    mpfr_set(sum_, x.sum_, MPFR_RNDN); // exact
+  }
+  floatmp_accumulator(floatmp_accumulator &&x) : floatmp_accumulator() {
+    mpfr_swap(sum_, x.sum_);
+  }
+  ~floatmp_accumulator() { mpfr_clear(sum_); }
+  floatmp_accumulator &operator=(const floatmp_accumulator &x) {
+    if (this != &x) {
+      mpfr_set_prec(sum_, mpfr_get_prec(x.sum_));
+      mpfr_set(sum_, x.sum_, MPFR_RNDN); // exact
+    }
+    return *this;
+  }
+  floatmp_accumulator &operator=(floatmp_accumulator &&x) noexcept {
+    mpfr_swap(sum_, x.sum_);
+    return *this;
+  }
+
+  template <typename T> floatmp_accumulator &accumulate(const T &x) {
+    accumulate_(x, std::is_base_of<floatmp_base, T>());
+    return *this;
+  }
+  floatmp_accumulator &accumulate(const mpfr_t &x) {
+    add_(x);
+    return *this;
+  }
+  template <std::size_t P1, typename R1, std::size_t P2, typename R2>
+  floatmp_accumulator &accumulate_product(const floatmp<P1, R1> &x,
+                                          const floatmp<P2, R2> &y) {
+    MPFR_DECL_INIT(__xy, P1 + P2);
+    mpfr_mul(__xy, x.c_mpfr(), y.c_mpfr(), MPFR_RNDN); // exact
+    add_(__xy);
+    return *this;
+  }
+  template <typename T> floatmp_accumulator &operator+=(const T &x) {
+    return accumulate(x);
+  }
+  template <std::size_t P, typename R>
+  floatmp_accumulator &merge(const floatmp_accumulator<P, R> &x) {
+    add_(x.c_mpfr());
+    return *this;
+  }
+  void clear() {
+    mpfr_set_prec(sum_, initial_precision_);
+    mpfr_set_zero(sum_, 1);
+  }
+
+  // the exact sum (its precision grows as needed)
+  const mpfr_t &c_mpfr() const noexcept { return sum_; }
+  value_type result() const { return value_type(sum_); }
+
+private:
+  static constexpr mpfr_prec_t initial_precision_ = 2 * Precision + 64;
+  mpfr_t sum_;
+
+  void accumulate_(const floatmp_base &x, std::true_type) { add_(x.c_mpfr()); }
+  template <typename T> void accumulate_(const T &x, std::false_type) {
+    typedef floatmp_expr_scalar_traits<T> __traits;
+    MPFR_DECL_INIT(__x, __traits::precision);
+    __traits::set(__x, x, MPFR_RNDN); // exact
+    add_(__x);
+  }
+  // sum_ += x without rounding: the precision of sum_ is extended to cover
+  // all bits of both operands (and a carry)
+  void add_(mpfr_srcptr x);
+}; // class floatmp_accumulator
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+template <std::size_t P, typename R>
+void floatmp_accumulator<P, R>::add_(mpfr_srcptr x) {
+  if (mpfr_zero_p(x))
+    return;
+  if (mpfr_regular_p(x)) {
+    if (mpfr_zero_p(sum_)) {
+      if (mpfr_get_prec(x) > mpfr_get_prec(sum_))
+        mpfr_set_prec(sum_, mpfr_get_prec(x));
+      mpfr_set(sum_, x, MPFR_RNDN); // exact
+      return;
+    }
+    if (mpfr_regular_p(sum_)) {
+      mpfr_exp_t __sum_exp = mpfr_get_exp(sum_), __x_exp = mpfr_get_exp(x);
+      mpfr_exp_t __high = std::max(__sum_exp, __x_exp) + 1;
+      // the lowest nonzero bits (not the precisions) of both operands
+      mpfr_exp_t __low = std::min(__sum_exp - mpfr_min_prec(sum_),
+                                  __x_exp - mpfr_min_prec(x));
+      if (__high - __low > static_cast<mpfr_exp_t>(MPFR_PREC_MAX))
+        throw std::overflow_error("too wide range of floatmp_accumulator");
+      mpfr_prec_t __prec = mpfr_get_prec(sum_);
+      if (__high - __low > __prec) // grows geometrically
+        mpfr_prec_round(
+            sum_,
+            std::min<mpfr_prec_t>(std::max<mpfr_prec_t>(__high - __low,
+                                                        2 * __prec),
+                                  MPFR_PREC_MAX),
+            MPFR_RNDN); // exact
+    }
+  }
+  mpfr_add(sum_, sum_, x, MPFR_RNDN); // exact (or NaN, infinity)
+}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+} // namespace teuthid
+
+#endif // TEUTHID_FLOATMP_ACCUMULATOR_HPP
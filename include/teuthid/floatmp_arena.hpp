@@ -0,0 +1,72 @@
+/*
+  This file is part of the Teuthid project.
+  Copyright (c) 2016-2017 Mariusz Przygodzki (mariusz.przygodzki@gmail.com)
+
+  The Teuthid is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or (at your
+  option) any later version.
+
+  The Teuthid is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+  FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+  for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with the Teuthid; see the file LICENSE.LGPLv3.  If not, see
+  <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef TEUTHID_FLOATMP_ARENA_HPP
+#define TEUTHID_FLOATMP_ARENA_HPP
+
+#include <cstddef>
+
+namespace teuthid {
+
+class floatmp_arena {
+public:
+  class scope {
+  public:
+    scope();
+    scope(const scope &) = delete;
+    scope &operator=(const scope &) = delete;
+    ~scope();
+
+  private:
+    void *block_;
+    std::size_t used_;
+  };
+
+  class suspend {
+  public:
+    suspend() noexcept { ++floatmp_arena::suspended_; }
+    suspend(const suspend &) = delete;
+    suspend &operator=(const suspend &) = delete;
+    ~suspend() { --floatmp_arena::suspended_; }
+  };
+
+  floatmp_arena() = delete;
+  static void install(std::size_t block_size = default_block_size);
+  static void uninstall();
+  static bool is_installed() noexcept;
+  static bool is_active() noexcept;
+  static std::size_t bytes_in_use() noexcept;
+  static std::size_t bytes_reserved() noexcept;
+  static void release();
+
+  static constexpr std::size_t default_block_size = 1 << 20;
+
+private:
+  static thread_local int scopes_;
+  static thread_local int suspended_;
+
+  static void *alloc_(std::size_t size);
+  static void *realloc_(void *ptr, std::size_t old_size,
+                        std::size_t new_size);
+  static void free_(void *ptr, std::size_t size);
+}; // class floatmp_arena
+
+} // namespace teuthid
+
+#endif // TEUTHID_FLOATMP_ARENA_HPP
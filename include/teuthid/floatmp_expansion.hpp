@@ -0,0 +1,609 @@
+/*
+  This file is part of the Teuthid project.
+  Copyright (c) 2016-2017 Mariusz Przygodzki (mariusz.przygodzki@gmail.com)
+
+  The Teuthid is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or (at your
+  option) any later version.
+
+  The Teuthid is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+  FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+  for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with the Teuthid; see the file LICENSE.LGPLv3.  If not, see
+  <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef TEUTHID_FLOATMP_EXPANSION_HPP
+#define TEUTHID_FLOATMP_EXPANSION_HPP
+
+#include <climits>
+#include <cmath>
+#include <limits>
+#include <type_traits>
+
+#include <mpfr.h>
+#include <teuthid/floatmp.hpp>
+
+namespace teuthid {
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+template <typename T> struct floatmp_expansion_integer : std::is_integral<T> {};
+#if defined(TEUTHID_HAVE_INT_128)
+template <> struct floatmp_expansion_integer<int128_t> : std::true_type {};
+template <> struct floatmp_expansion_integer<uint128_t> : std::true_type {};
+typedef uint128_t floatmp_expansion_uintmax_t;
+#else
+typedef uint64_t floatmp_expansion_uintmax_t;
+#endif // TEUTHID_HAVE_INT_128
+// the built-in values converted implicitly and mixed in arithmetic
+template <typename T>
+struct floatmp_expansion_scalar
+    : std::integral_constant<bool, std::is_same<T, float>::value ||
+                                       std::is_same<T, double>::value ||
+                                       std::is_same<T, long double>::value ||
+                                       floatmp_expansion_integer<T>::value> {};
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+template <std::size_t Terms> class floatmp_expansion {
+  static_assert((Terms >= 2), "Too few terms of floatmp_expansion.");
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+  friend class floatmp_base;
+  template <typename T, typename Enable>
+  friend struct floatmp_expr_scalar_traits;
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+public:
+  floatmp_expansion() noexcept { assign_(0.0); }
+  floatmp_expansion(const floatmp_expansion &) = default;
+  template <typename T,
+            std::enable_if_t<floatmp_expansion_scalar<T>::value, int> = 0>
+  floatmp_expansion(const T &x) { assign(x); }
+  template <typename T,
+            std::enable_if_t<!floatmp_expansion_scalar<T>::value, int> = 0>
+  explicit floatmp_expansion(const T &x) { assign(x); }
+  floatmp_expansion &operator=(const floatmp_expansion &) = default;
+  template <typename T> floatmp_expansion &operator=(const T &x) {
+    return assign(x);
+  }
+
+  explicit operator float() const { return static_cast<float>(terms_[0]); }
+  explicit operator double() const { return terms_[0]; }
+  explicit operator long double() const {
+    long double __x = 0;
+    for (std::size_t __i = Terms; __i > 0; --__i)
+      __x += terms_[__i - 1];
+    return __x;
+  }
+
+  static constexpr std::size_t precision() noexcept {
+    return Terms * std::numeric_limits<double>::digits;
+  }
+  static constexpr std::size_t terms() noexcept { return Terms; }
+  const double &operator[](std::size_t i) const noexcept {
+    return terms_[i];
+  }
+  bool is_finite() const { return std::isfinite(terms_[0]); }
+  bool is_infinite() const { return std::isinf(terms_[0]); }
+  bool is_nan() const { return std::isnan(terms_[0]); }
+  bool is_zero() const { return (terms_[0] == 0); }
+  bool is_negative() const { return (terms_[0] < 0); }
+  bool is_positive() const { return (terms_[0] > 0); }
+
+  floatmp_expansion &assign(const floatmp_expansion &x) {
+    return (*this = x);
+  }
+  template <typename T> floatmp_expansion &assign(const T &x) {
+    assign_(x);
+    return *this;
+  }
+  floatmp_expansion &swap(floatmp_expansion &x) noexcept {
+    for (std::size_t __i = 0; __i < Terms; ++__i)
+      std::swap(terms_[__i], x.terms_[__i]);
+    return *this;
+  }
+  floatmp_expansion operator-() const {
+    floatmp_expansion __x;
+    for (std::size_t __i = 0; __i < Terms; ++__i)
+      __x.terms_[__i] = -terms_[__i];
+    return __x;
+  }
+  floatmp_expansion &operator+=(const floatmp_expansion &x) { return add(x); }
+  floatmp_expansion &operator-=(const floatmp_expansion &x) { return sub(x); }
+  floatmp_expansion &operator*=(const floatmp_expansion &x) { return mul(x); }
+  floatmp_expansion &operator/=(const floatmp_expansion &x) { return div(x); }
+
+  floatmp_expansion &add(const floatmp_expansion &x);
+  floatmp_expansion &sub(const floatmp_expansion &x) { return add(-x); }
+  floatmp_expansion &mul(const floatmp_expansion &x);
+  floatmp_expansion &div(const floatmp_expansion &x);
+  bool equal_to(const floatmp_expansion &x) const {
+    for (std::size_t __i = 0; __i < Terms; ++__i)
+      if (!(terms_[__i] == x.terms_[__i]))
+        return false;
+    return true;
+  }
+  bool less_than(const floatmp_expansion &x) const {
+    for (std::size_t __i = 0; __i < Terms; ++__i)
+      if (!(terms_[__i] == x.terms_[__i]))
+        return (terms_[__i] < x.terms_[__i]);
+    return false;
+  }
+  bool greater_than(const floatmp_expansion &x) const {
+    return x.less_than(*this);
+  }
+
+  floatmp_expansion &abs(const floatmp_expansion &x) {
+    return (*this = (x.is_negative() ? -x : x));
+  }
+  floatmp_expansion &sqrt(const floatmp_expansion &x);
+  floatmp_expansion &fma(const floatmp_expansion &x,
+                         const floatmp_expansion &y,
+                         const floatmp_expansion &z) {
+    floatmp_expansion __x(x);
+    return (*this = __x.mul(y).add(z));
+  }
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+#define __TEUTHID_FLOATMP_EXPANSION_MPFR_SPEC(FUN, MPFR_FUN)                   \
+  floatmp_expansion &FUN(const floatmp_expansion &x) {                         \
+    MPFR_DECL_INIT(__x, precision());                                          \
+    x.get_(__x, MPFR_RNDN);                                                    \
+    MPFR_FUN(__x, __x, MPFR_RNDN);                                             \
+    set_(__x);                                                                 \
+    return *this;                                                              \
+  }
+  __TEUTHID_FLOATMP_EXPANSION_MPFR_SPEC(exp, mpfr_exp)
+  __TEUTHID_FLOATMP_EXPANSION_MPFR_SPEC(exp2, mpfr_exp2)
+  __TEUTHID_FLOATMP_EXPANSION_MPFR_SPEC(expm1, mpfr_expm1)
+  __TEUTHID_FLOATMP_EXPANSION_MPFR_SPEC(log, mpfr_log)
+  __TEUTHID_FLOATMP_EXPANSION_MPFR_SPEC(log10, mpfr_log10)
+  __TEUTHID_FLOATMP_EXPANSION_MPFR_SPEC(log2, mpfr_log2)
+  __TEUTHID_FLOATMP_EXPANSION_MPFR_SPEC(log1p, mpfr_log1p)
+  __TEUTHID_FLOATMP_EXPANSION_MPFR_SPEC(cbrt, mpfr_cbrt)
+  __TEUTHID_FLOATMP_EXPANSION_MPFR_SPEC(sin, mpfr_sin)
+  __TEUTHID_FLOATMP_EXPANSION_MPFR_SPEC(cos, mpfr_cos)
+  __TEUTHID_FLOATMP_EXPANSION_MPFR_SPEC(tan, mpfr_tan)
+  __TEUTHID_FLOATMP_EXPANSION_MPFR_SPEC(asin, mpfr_asin)
+  __TEUTHID_FLOATMP_EXPANSION_MPFR_SPEC(acos, mpfr_acos)
+  __TEUTHID_FLOATMP_EXPANSION_MPFR_SPEC(atan, mpfr_atan)
+  __TEUTHID_FLOATMP_EXPANSION_MPFR_SPEC(sinh, mpfr_sinh)
+  __TEUTHID_FLOATMP_EXPANSION_MPFR_SPEC(cosh, mpfr_cosh)
+  __TEUTHID_FLOATMP_EXPANSION_MPFR_SPEC(tanh, mpfr_tanh)
+  __TEUTHID_FLOATMP_EXPANSION_MPFR_SPEC(asinh, mpfr_asinh)
+  __TEUTHID_FLOATMP_EXPANSION_MPFR_SPEC(acosh, mpfr_acosh)
+  __TEUTHID_FLOATMP_EXPANSION_MPFR_SPEC(atanh, mpfr_atanh)
+  __TEUTHID_FLOATMP_EXPANSION_MPFR_SPEC(erf, mpfr_erf)
+  __TEUTHID_FLOATMP_EXPANSION_MPFR_SPEC(erfc, mpfr_erfc)
+  __TEUTHID_FLOATMP_EXPANSION_MPFR_SPEC(tgamma, mpfr_gamma)
+  __TEUTHID_FLOATMP_EXPANSION_MPFR_SPEC(lgamma, mpfr_lngamma)
+#undef __TEUTHID_FLOATMP_EXPANSION_MPFR_SPEC
+#define __TEUTHID_FLOATMP_EXPANSION_MPFR_SPEC(FUN, MPFR_FUN)                   \
+  floatmp_expansion &FUN(const floatmp_expansion &x,                           \
+                         const floatmp_expansion &y) {                         \
+    MPFR_DECL_INIT(__x, precision());                                          \
+    MPFR_DECL_INIT(__y, precision());                                          \
+    x.get_(__x, MPFR_RNDN);                                                    \
+    y.get_(__y, MPFR_RNDN);                                                    \
+    MPFR_FUN(__x, __x, __y, MPFR_RNDN);                                        \
+    set_(__x);                                                                 \
+    return *this;                                                              \
+  }
+  __TEUTHID_FLOATMP_EXPANSION_MPFR_SPEC(pow, mpfr_pow)
+  __TEUTHID_FLOATMP_EXPANSION_MPFR_SPEC(hypot, mpfr_hypot)
+  __TEUTHID_FLOATMP_EXPANSION_MPFR_SPEC(atan2, mpfr_atan2)
+  __TEUTHID_FLOATMP_EXPANSION_MPFR_SPEC(fmod, mpfr_fmod)
+  __TEUTHID_FLOATMP_EXPANSION_MPFR_SPEC(remainder, mpfr_remainder)
+#undef __TEUTHID_FLOATMP_EXPANSION_MPFR_SPEC
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+private:
+  // error-free transformations: a + b = s + e, a * b = p + e
+  static double two_sum_(double a, double b, double &e) {
+    double __s = a + b, __b = __s - a;
+    e = (a - (__s - __b)) + (b - __b);
+    return __s;
+  }
+  static double fast_two_sum_(double a, double b, double &e) { // |a| >= |b|
+    double __s = a + b;
+    e = b - (__s - a);
+    return __s;
+  }
+  // a + b + c = a' + b' + c', |a'| >= |b'| >= |c'|
+  static void three_sum_(double &a, double &b, double &c) {
+    double __e1, __e2, __s = two_sum_(a, b, __e1);
+    a = two_sum_(c, __s, __e2);
+    b = two_sum_(__e1, __e2, c);
+  }
+  static double two_prod_(double a, double b, double &e) {
+    double __p = a * b;
+#ifdef FP_FAST_FMA
+    e = std::fma(a, b, -__p);
+#else // Dekker's product
+    const double __split = 134217729.0; // 2^27 + 1
+    double __t = __split * a, __ah = __t - (__t - a), __al = a - __ah;
+    __t = __split * b;
+    double __bh = __t - (__t - b), __bl = b - __bh;
+    e = ((__ah * __bh - __p) + __ah * __bl + __al * __bh) + __al * __bl;
+#endif // FP_FAST_FMA
+    return __p;
+  }
+  // the terms t[0..N) (ordered by decreasing magnitude) are summed into
+  // Terms non-overlapping terms
+  template <std::size_t N> void renormalize_(double (&t)[N]);
+  // non-finite values are represented by the leading term only
+  bool not_finite_(double x) {
+    if (std::isfinite(x))
+      return false;
+    assign_(x);
+    return true;
+  }
+
+  void assign_(double x) noexcept {
+    terms_[0] = x;
+    for (std::size_t __i = 1; __i < Terms; ++__i)
+      terms_[__i] = 0;
+  }
+  void assign_(float x) noexcept { assign_(static_cast<double>(x)); }
+  void assign_(long double x) {
+    double __t[2];
+    __t[0] = static_cast<double>(x);
+    __t[1] = std::isfinite(__t[0]) ? static_cast<double>(x - __t[0]) : 0;
+    renormalize_(__t);
+  }
+  void assign_(const mpfr_t &x) { set_(x); }
+  template <std::size_t P, typename R> void assign_(const floatmp<P, R> &x) {
+    set_(x.c_mpfr());
+  }
+  template <typename E> void assign_(const floatmp_expr<E> &x) {
+    set_(x.eval().c_mpfr());
+  }
+  template <typename T>
+  std::enable_if_t<floatmp_expansion_integer<T>::value> assign_(const T &x) {
+    // the magnitude is split into exact 32-bit chunks
+    typedef std::conditional_t<(sizeof(T) > sizeof(uint64_t)),
+                               floatmp_expansion_uintmax_t, uint64_t>
+        __uint_t;
+    const std::size_t __chunks = sizeof(__uint_t) * CHAR_BIT / 32;
+    bool __negative = (x < T(0));
+    __uint_t __x = __negative ? (__uint_t(0) - static_cast<__uint_t>(x))
+                              : static_cast<__uint_t>(x);
+    double __t[__chunks];
+    for (std::size_t __i = __chunks; __i > 0; --__i, __x = __x >> 16 >> 16) {
+      double __c = static_cast<double>(static_cast<uint32_t>(__x));
+      __t[__i - 1] = std::ldexp(__negative ? -__c : __c,
+                                static_cast<int>(32 * (__chunks - __i)));
+    }
+    renormalize_(__t);
+  }
+
+  // the bits from the largest to the smallest double, so get_() is exact
+  // at this precision
+  static constexpr mpfr_prec_t exact_precision_ =
+      std::numeric_limits<double>::max_exponent -
+      std::numeric_limits<double>::min_exponent +
+      std::numeric_limits<double>::digits;
+
+  // mpfr_t <-> terms; get_() rounds once, set_() extracts the terms by
+  // repeated rounding to double
+  void get_(mpfr_ptr x, mpfr_rnd_t rnd) const;
+  void set_(mpfr_srcptr x);
+
+  double terms_[Terms];
+}; // class floatmp_expansion
+
+typedef floatmp_expansion<2> floatdd_t;
+typedef floatmp_expansion<4> floatqd_t;
+
+template <std::size_t Precision, typename Enable = void>
+struct floatmp_engine {
+  typedef floatmp<Precision> type;
+};
+template <std::size_t Precision>
+struct floatmp_engine<Precision,
+                      std::enable_if_t<(Precision <= floatdd_t::precision())>> {
+  typedef floatdd_t type;
+};
+template <std::size_t Precision>
+struct floatmp_engine<
+    Precision, std::enable_if_t<(Precision > floatdd_t::precision()) &&
+                                (Precision <= floatqd_t::precision())>> {
+  typedef floatqd_t type;
+};
+template <std::size_t Precision>
+using floatmp_fast = typename floatmp_engine<Precision>::type;
+
+/******************************************************************************/
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+template <std::size_t Terms>
+template <std::size_t N>
+void floatmp_expansion<Terms>::renormalize_(double (&t)[N]) {
+  // VecSum: the running sum goes to t[0] and the exact errors to t[1..N)
+  double __s = t[N - 1];
+  for (std::size_t __i = N - 1; __i > 0; --__i)
+    __s = two_sum_(t[__i - 1], __s, t[__i]);
+  t[0] = __s;
+  if (not_finite_(__s))
+    return;
+  // VecSumErrBranch: the non-zero errors become the next terms
+  double __e = t[0], __r[N];
+  std::size_t __j = 0;
+  for (std::size_t __i = 1; __i < N; ++__i) {
+    __r[__j] = fast_two_sum_(__e, t[__i], __e);
+    bool __nz = (__e != 0);
+    __e = __nz ? __e : __r[__j];
+    __j += __nz;
+  }
+  __r[__j++] = __e;
+  for (std::size_t __i = 0; __i < Terms; ++__i)
+    terms_[__i] = (__i < __j) ? __r[__i] : 0;
+}
+
+template <std::size_t Terms>
+floatmp_expansion<Terms> &
+floatmp_expansion<Terms>::add(const floatmp_expansion &x) {
+  if (not_finite_(terms_[0] + x.terms_[0]))
+    return *this;
+  if (Terms == 2) { // double-double
+    double __e1, __e2;
+    double __s = two_sum_(terms_[0], x.terms_[0], __e1);
+    double __t = two_sum_(terms_[1], x.terms_[1], __e2);
+    __s = fast_two_sum_(__s, __e1 + __t, __e1);
+    terms_[0] = fast_two_sum_(__s, __e1 + __e2, terms_[1]);
+    return *this;
+  }
+  if (Terms == 4) { // quad-double
+    double __t[5], __e[4];
+    for (std::size_t __i = 0; __i < 4; ++__i)
+      __t[__i] = two_sum_(terms_[__i], x.terms_[__i], __e[__i]);
+    __t[1] = two_sum_(__t[1], __e[0], __e[0]);
+    three_sum_(__t[2], __e[0], __e[1]);
+    __t[3] = two_sum_(__t[3], __e[2], __e[2]);
+    __t[3] = two_sum_(__t[3], __e[0], __e[0]);
+    __t[4] = __e[0] + __e[1] + __e[2] + __e[3];
+    renormalize_(__t);
+    return *this;
+  }
+  // merges the terms by decreasing magnitude
+  double __t[2 * Terms];
+  std::size_t __i = 0, __j = 0, __k = 0;
+  while ((__i < Terms) && (__j < Terms))
+    __t[__k++] = (std::fabs(terms_[__i]) >= std::fabs(x.terms_[__j]))
+                     ? terms_[__i++]
+                     : x.terms_[__j++];
+  while (__i < Terms)
+    __t[__k++] = terms_[__i++];
+  while (__j < Terms)
+    __t[__k++] = x.terms_[__j++];
+  renormalize_(__t);
+  return *this;
+}
+
+template <std::size_t Terms>
+floatmp_expansion<Terms> &
+floatmp_expansion<Terms>::mul(const floatmp_expansion &x) {
+  if (not_finite_(terms_[0] * x.terms_[0]))
+    return *this;
+  if (Terms == 2) { // double-double
+    double __e, __p = two_prod_(terms_[0], x.terms_[0], __e);
+    __e += terms_[0] * x.terms_[1] + terms_[1] * x.terms_[0];
+    terms_[0] = fast_two_sum_(__p, __e, terms_[1]);
+    return *this;
+  }
+  if (Terms == 4) { // quad-double, the products of the order 4 are omitted
+    const double *__a = terms_, *__b = x.terms_;
+    double __t[5], __q[6], __s[3], __e[3];
+    __t[0] = two_prod_(__a[0], __b[0], __q[0]);
+    __t[1] = two_prod_(__a[0], __b[1], __q[1]);
+    __t[2] = two_prod_(__a[1], __b[0], __q[2]);
+    __s[0] = two_prod_(__a[0], __b[2], __q[3]);
+    __s[1] = two_prod_(__a[1], __b[1], __q[4]);
+    __s[2] = two_prod_(__a[2], __b[0], __q[5]);
+    three_sum_(__t[1], __t[2], __q[0]);
+    three_sum_(__t[2], __q[1], __q[2]);
+    three_sum_(__s[0], __s[1], __s[2]);
+    // (t2, q1, q2) + (s0, s1, s2)
+    __t[2] = two_sum_(__t[2], __s[0], __e[0]);
+    __t[3] = two_sum_(__q[1], __s[1], __e[1]);
+    __t[4] = __q[2] + __s[2];
+    __t[3] = two_sum_(__t[3], __e[0], __e[0]);
+    __t[4] += __e[0] + __e[1];
+    __t[3] += __a[0] * __b[3] + __a[1] * __b[2] + __a[2] * __b[1] +
+              __a[3] * __b[0] + __q[0] + __q[3] + __q[4] + __q[5];
+    renormalize_(__t);
+    return *this;
+  }
+  // the products of the order k = i + j are followed by the errors of the
+  // products of the order k - 1; the errors of the order Terms - 1 and the
+  // products of higher orders are below the precision
+  double __t[2 * Terms * Terms], __e[Terms * Terms];
+  std::size_t __n = 0, __m = 0, __e0 = 0;
+  for (std::size_t __k = 0; __k <= Terms; ++__k) {
+    std::size_t __m0 = __m;
+    for (std::size_t __i = 0; __i <= __k; ++__i) {
+      std::size_t __j = __k - __i;
+      if ((__i >= Terms) || (__j >= Terms))
+        continue;
+      if (__k + 1 < Terms)
+        __t[__n++] = two_prod_(terms_[__i], x.terms_[__j], __e[__m++]);
+      else
+        __t[__n++] = terms_[__i] * x.terms_[__j];
+    }
+    for (std::size_t __l = __e0; __l < __m0; ++__l)
+      __t[__n++] = __e[__l];
+    __e0 = __m0;
+  }
+  std::fill(__t + __n, __t + 2 * Terms * Terms, 0.0);
+  renormalize_(__t);
+  return *this;
+}
+
+template <std::size_t Terms>
+floatmp_expansion<Terms> &
+floatmp_expansion<Terms>::div(const floatmp_expansion &x) {
+  double __q0 = terms_[0] / x.terms_[0];
+  if (not_finite_(__q0) || is_zero() || x.is_infinite()) {
+    assign_(__q0);
+    return *this;
+  }
+  // long division: each quotient term is taken from the remainder
+  double __q[Terms + 1];
+  floatmp_expansion __r(*this), __p;
+  __q[0] = __q0;
+  for (std::size_t __i = 1; __i <= Terms; ++__i) {
+    __p = x, __p.mul(floatmp_expansion(__q[__i - 1]));
+    __r.sub(__p);
+    __q[__i] = __r.terms_[0] / x.terms_[0];
+  }
+  renormalize_(__q);
+  return *this;
+}
+
+template <std::size_t Terms>
+floatmp_expansion<Terms> &
+floatmp_expansion<Terms>::sqrt(const floatmp_expansion &x) {
+  if (x.is_zero() || !x.is_finite() || x.is_negative()) {
+    assign_(std::sqrt(x.terms_[0]));
+    return *this;
+  }
+  // Newton's iteration y += (x - y^2) / 2y doubles the number of correct bits
+  floatmp_expansion __y(std::sqrt(x.terms_[0])), __d;
+  for (std::size_t __bits = std::numeric_limits<double>::digits;
+       __bits < precision(); __bits *= 2) {
+    __d = __y, __d.mul(__y);
+    __d = floatmp_expansion(x).sub(__d);
+    __d.div(floatmp_expansion(__y).add(__y));
+    __y.add(__d);
+  }
+  return (*this = __y);
+}
+
+template <std::size_t Terms>
+void floatmp_expansion<Terms>::get_(mpfr_ptr x, mpfr_rnd_t rnd) const {
+  if (!is_finite()) {
+    mpfr_set_d(x, terms_[0], rnd);
+    return;
+  }
+  mpfr_t __t[Terms];
+  mpfr_ptr __p[Terms];
+  mp_limb_t __limbs[Terms][floatmp_limbs(std::numeric_limits<double>::digits)];
+  for (std::size_t __i = 0; __i < Terms; ++__i) {
+    mpfr_custom_init(__limbs[__i], std::numeric_limits<double>::digits);
+    mpfr_custom_init_set(__t[__i], MPFR_ZERO_KIND, 0,
+                         std::numeric_limits<double>::digits, __limbs[__i]);
+    mpfr_set_d(__t[__i], terms_[__i], MPFR_RNDN); // exact
+    __p[__i] = __t[__i];
+  }
+  mpfr_sum(x, __p, Terms, rnd);
+}
+
+template <std::size_t Terms>
+void floatmp_expansion<Terms>::set_(mpfr_srcptr x) {
+  if (!mpfr_number_p(x)) {
+    assign_(mpfr_get_d(x, MPFR_RNDN));
+    return;
+  }
+  MPFR_DECL_INIT(__r, precision() + std::numeric_limits<double>::digits);
+  mpfr_set(__r, x, MPFR_RNDN);
+  for (std::size_t __i = 0; __i < Terms; ++__i) {
+    terms_[__i] = mpfr_get_d(__r, MPFR_RNDN);
+    mpfr_sub_d(__r, __r, terms_[__i], MPFR_RNDN); // exact
+  }
+}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+// floatmp_expansion mixed with floatmp is converted exactly, so the result is
+// rounded once to the precision of floatmp
+template <std::size_t N>
+struct floatmp_expr_scalar_traits<floatmp_expansion<N>> {
+  typedef floatmp_expansion<N> __type;
+  static constexpr std::size_t precision = __type::exact_precision_;
+  static void set(mpfr_ptr r, const __type &x, mpfr_rnd_t rnd) {
+    x.get_(r, rnd);
+  }
+#define __TEUTHID_FLOATMP_EXPANSION_SCALAR_SPEC(OPER, FUN)                     \
+  static void OPER(mpfr_ptr r, mpfr_srcptr x, const __type &y,                 \
+                   mpfr_rnd_t rnd) {                                           \
+    MPFR_DECL_INIT(__y, precision);                                            \
+    y.get_(__y, MPFR_RNDN); /* exact */                                        \
+    FUN(r, x, __y, rnd);                                                       \
+  }
+  __TEUTHID_FLOATMP_EXPANSION_SCALAR_SPEC(add, mpfr_add)
+  __TEUTHID_FLOATMP_EXPANSION_SCALAR_SPEC(sub, mpfr_sub)
+  __TEUTHID_FLOATMP_EXPANSION_SCALAR_SPEC(mul, mpfr_mul)
+  __TEUTHID_FLOATMP_EXPANSION_SCALAR_SPEC(div, mpfr_div)
+#undef __TEUTHID_FLOATMP_EXPANSION_SCALAR_SPEC
+#define __TEUTHID_FLOATMP_EXPANSION_SCALAR_SPEC(OPER, FUN)                     \
+  static void OPER(mpfr_ptr r, const __type &x, mpfr_srcptr y,                 \
+                   mpfr_rnd_t rnd) {                                           \
+    MPFR_DECL_INIT(__x, precision);                                            \
+    x.get_(__x, MPFR_RNDN); /* exact */                                        \
+    FUN(r, __x, y, rnd);                                                       \
+  }
+  __TEUTHID_FLOATMP_EXPANSION_SCALAR_SPEC(sub, mpfr_sub)
+  __TEUTHID_FLOATMP_EXPANSION_SCALAR_SPEC(div, mpfr_div)
+#undef __TEUTHID_FLOATMP_EXPANSION_SCALAR_SPEC
+};
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+/******************************************************************************/
+
+#define __TEUTHID_FLOATMP_EXPANSION_ARITHMETIC_SPEC(OPER, FUN)                 \
+  template <std::size_t N>                                                     \
+  inline floatmp_expansion<N> OPER(const floatmp_expansion<N> &lhs,            \
+                                   const floatmp_expansion<N> &rhs) {          \
+    return floatmp_expansion<N>(lhs).FUN(rhs);                                 \
+  }                                                                            \
+  template <std::size_t N, typename T>                                         \
+  inline std::enable_if_t<floatmp_expansion_scalar<T>::value,                  \
+                          floatmp_expansion<N>>                                \
+  OPER(const floatmp_expansion<N> &lhs, const T &rhs) {                        \
+    return floatmp_expansion<N>(lhs).FUN(floatmp_expansion<N>(rhs));           \
+  }                                                                            \
+  template <std::size_t N, typename T>                                         \
+  inline std::enable_if_t<floatmp_expansion_scalar<T>::value,                  \
+                          floatmp_expansion<N>>                                \
+  OPER(const T &lhs, const floatmp_expansion<N> &rhs) {                        \
+    return floatmp_expansion<N>(lhs).FUN(rhs);                                 \
+  }
+__TEUTHID_FLOATMP_EXPANSION_ARITHMETIC_SPEC(operator+, add)
+__TEUTHID_FLOATMP_EXPANSION_ARITHMETIC_SPEC(operator-, sub)
+__TEUTHID_FLOATMP_EXPANSION_ARITHMETIC_SPEC(operator*, mul)
+__TEUTHID_FLOATMP_EXPANSION_ARITHMETIC_SPEC(operator/, div)
+#undef __TEUTHID_FLOATMP_EXPANSION_ARITHMETIC_SPEC
+
+#define __TEUTHID_FLOATMP_EXPANSION_COMPARISON_SPEC(OPER, EXPR)                \
+  template <std::size_t N>                                                     \
+  inline bool OPER(const floatmp_expansion<N> &lhs,                            \
+                   const floatmp_expansion<N> &rhs) {                          \
+    return (EXPR);                                                             \
+  }                                                                            \
+  template <std::size_t N, typename T>                                         \
+  inline std::enable_if_t<floatmp_expansion_scalar<T>::value, bool> OPER(      \
+      const floatmp_expansion<N> &lhs, const T &rhs) {                         \
+    return OPER(lhs, floatmp_expansion<N>(rhs));                               \
+  }                                                                            \
+  template <std::size_t N, typename T>                                         \
+  inline std::enable_if_t<floatmp_expansion_scalar<T>::value, bool> OPER(      \
+      const T &lhs, const floatmp_expansion<N> &rhs) {                         \
+    return OPER(floatmp_expansion<N>(lhs), rhs);                               \
+  }
+__TEUTHID_FLOATMP_EXPANSION_COMPARISON_SPEC(operator==, lhs.equal_to(rhs))
+__TEUTHID_FLOATMP_EXPANSION_COMPARISON_SPEC(operator!=, !lhs.equal_to(rhs))
+__TEUTHID_FLOATMP_EXPANSION_COMPARISON_SPEC(operator<, lhs.less_than(rhs))
+__TEUTHID_FLOATMP_EXPANSION_COMPARISON_SPEC(operator>, lhs.greater_than(rhs))
+__TEUTHID_FLOATMP_EXPANSION_COMPARISON_SPEC(
+    operator<=, !lhs.greater_than(rhs) && !lhs.is_nan() && !rhs.is_nan())
+__TEUTHID_FLOATMP_EXPANSION_COMPARISON_SPEC(
+    operator>=, !lhs.less_than(rhs) && !lhs.is_nan() && !rhs.is_nan())
+#undef __TEUTHID_FLOATMP_EXPANSION_COMPARISON_SPEC
+
+} // namespace teuthid
+
+#endif // TEUTHID_FLOATMP_EXPANSION_HPP
@@ -0,0 +1,218 @@
+/*
+  This file is part of the Teuthid project.
+  Copyright (c) 2016-2017 Mariusz Przygodzki (mariusz.przygodzki@gmail.com)
+
+  The Teuthid is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or (at your
+  option) any later version.
+
+  The Teuthid is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+  FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+  for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with the Teuthid; see the file LICENSE.LGPLv3.  If not, see
+  <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef TEUTHID_FLOATMP_IO_HPP
+#define TEUTHID_FLOATMP_IO_HPP
+
+#include <algorithm>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <mpfr.h>
+#include <teuthid/floatmp.hpp>
+#include <teuthid/floatmp_vector.hpp>
+#include <teuthid/mapped_file.hpp>
+
+namespace teuthid {
+
+class floatmp_io {
+public:
+  floatmp_io() = delete;
+
+  template <std::size_t P, typename R>
+  static void save(std::ostream &os, const floatmp<P, R> &x) {
+    save(os, &x, 1);
+  }
+  template <std::size_t P, typename R>
+  static void save(std::ostream &os, const floatmp<P, R> *x, std::size_t n);
+  template <std::size_t P, typename R>
+  static void save(std::ostream &os, const floatmp_vector<P, R> &x);
+  template <std::size_t P, typename R>
+  static void load(std::istream &is, floatmp<P, R> &x) {
+    load(is, &x, 1);
+  }
+  template <std::size_t P, typename R>
+  static void load(std::istream &is, floatmp<P, R> *x, std::size_t n);
+  template <std::size_t P, typename R>
+  static void load(std::istream &is, floatmp_vector<P, R> &x);
+
+  static constexpr std::size_t header_size = 64;
+  static std::size_t record_size(std::size_t precision) noexcept {
+    return record_head_size_ + floatmp_limbs(precision) * sizeof(mp_limb_t);
+  }
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+  // a record is {int64 exponent, int32 kind, uint32 0, limbs}
+  static constexpr std::size_t record_head_size_ = 16;
+  static void write_header_(std::ostream &os, std::size_t precision,
+                            std::size_t count);
+  static void read_header_(std::istream &is, std::size_t &precision,
+                           std::size_t &count);
+  static void check_header_(const unsigned char *data, std::size_t &precision,
+                            std::size_t &count);
+  static void encode_(unsigned char *record, mpfr_srcptr x);
+  // x becomes a read-only MPFR value sharing the limbs of the record
+  static void decode_(const unsigned char *record, std::size_t precision,
+                      mpfr_ptr x);
+  static void write_(std::ostream &os, const unsigned char *data,
+                     std::size_t size);
+  static void read_(std::istream &is, unsigned char *data, std::size_t size);
+
+private:
+  // the records are written and read in chunks of about this size
+  static constexpr std::size_t chunk_size_ = 1 << 16;
+  static std::size_t chunk_records_(std::size_t precision) noexcept {
+    return std::max<std::size_t>(chunk_size_ / record_size(precision), 1);
+  }
+  template <typename F>
+  static void save_(std::ostream &os, std::size_t precision, std::size_t n,
+                    F value);
+  template <typename F>
+  static void load_(std::istream &is, std::size_t precision, std::size_t n,
+                    F store);
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+}; // class floatmp_io
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+// the read-only memory of a file in the binary format of floatmp_io
+class floatmp_mapping {
+public:
+  explicit floatmp_mapping(const std::string &path);
+
+protected:
+  std::size_t precision_;
+  std::size_t count_;
+  std::size_t record_size_;
+  const unsigned char *records_;
+
+private:
+  mapped_file file_;
+};
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+template <std::size_t Precision, typename Policy = floatmp_policy<>>
+class floatmp_mapped : private floatmp_mapping {
+  TEUTHID_CHECK_FLOATMP_PRECISION(Precision);
+
+public:
+  typedef floatmp<Precision, Policy> value_type;
+
+  explicit floatmp_mapped(const std::string &path) : floatmp_mapping(path) {
+    if (precision_ != Precision)
+      throw std::invalid_argument("invalid precision of floatmp data");
+  }
+
+  static constexpr std::size_t precision() noexcept { return Precision; }
+  std::size_t size() const noexcept { return count_; }
+  bool empty() const noexcept { return (count_ == 0); }
+  void view(std::size_t i, mpfr_ptr x) const {
+    floatmp_io::decode_(records_ + i * record_size_, Precision, x);
+  }
+  value_type get(std::size_t i) const {
+    mpfr_t __v;
+    view(i, __v);
+    return value_type(__v);
+  }
+  value_type operator[](std::size_t i) const { return get(i); }
+  value_type at(std::size_t i) const {
+    if (i >= count_)
+      throw std::out_of_range("invalid index of floatmp_mapped");
+    return get(i);
+  }
+}; // class floatmp_mapped
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+template <typename F>
+void floatmp_io::save_(std::ostream &os, std::size_t precision, std::size_t n,
+                       F value) {
+  std::size_t __size = record_size(precision);
+  std::vector<unsigned char> __chunk(chunk_records_(precision) * __size);
+  write_header_(os, precision, n);
+  for (std::size_t __i = 0; __i < n;) {
+    unsigned char *__r = __chunk.data();
+    for (; (__i < n) && (__r < __chunk.data() + __chunk.size()); ++__i) {
+      value(__i, [__r](mpfr_srcptr x) { floatmp_io::encode_(__r, x); });
+      __r += __size;
+    }
+    write_(os, __chunk.data(), __r - __chunk.data());
+  }
+}
+
+template <typename F>
+void floatmp_io::load_(std::istream &is, std::size_t precision, std::size_t n,
+                       F store) {
+  std::size_t __size = record_size(precision);
+  std::vector<unsigned char> __chunk(chunk_records_(precision) * __size);
+  for (std::size_t __i = 0; __i < n;) {
+    std::size_t __k = std::min(n - __i, chunk_records_(precision));
+    read_(is, __chunk.data(), __k * __size);
+    for (const unsigned char *__r = __chunk.data(); __k > 0;
+         --__k, ++__i, __r += __size) {
+      mpfr_t __v;
+      decode_(__r, precision, __v);
+      store(__i, __v);
+    }
+  }
+}
+
+template <std::size_t P, typename R>
+void floatmp_io::save(std::ostream &os, const floatmp<P, R> *x,
+                      std::size_t n) {
+  save_(os, P, n, [x](std::size_t i, auto encode) { encode(x[i].c_mpfr()); });
+}
+
+template <std::size_t P, typename R>
+void floatmp_io::save(std::ostream &os, const floatmp_vector<P, R> &x) {
+  save_(os, P, x.size(), [&x](std::size_t i, auto encode) {
+    mpfr_t __v;
+    x.view_(i, __v);
+    encode(__v);
+  });
+}
+
+template <std::size_t P, typename R>
+void floatmp_io::load(std::istream &is, floatmp<P, R> *x, std::size_t n) {
+  std::size_t __precision, __count;
+  read_header_(is, __precision, __count);
+  if (__count != n)
+    throw std::invalid_argument("invalid size of floatmp data");
+  load_(is, __precision, n,
+        [x](std::size_t i, const mpfr_t &v) { x[i].assign(v); });
+}
+
+template <std::size_t P, typename R>
+void floatmp_io::load(std::istream &is, floatmp_vector<P, R> &x) {
+  std::size_t __precision, __count;
+  read_header_(is, __precision, __count);
+  x.resize(__count);
+  load_(is, __precision, __count, [&x](std::size_t i, const mpfr_t &v) {
+    mpfr_t __v;
+    x.view_(i, __v);
+    mpfr_set(__v, v, (floatmp_vector<P, R>::rnd_()));
+    x.store_(i, __v);
+  });
+}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+} // namespace teuthid
+
+#endif // TEUTHID_FLOATMP_IO_HPP
@@ -0,0 +1,268 @@
+/*
+  This file is part of the Teuthid project.
+  Copyright (c) 2016-2017 Mariusz Przygodzki (mariusz.przygodzki@gmail.com)
+
+  The Teuthid is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or (at your
+  option) any later version.
+
+  The Teuthid is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+  FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+  for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with the Teuthid; see the file LICENSE.LGPLv3.  If not, see
+  <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef TEUTHID_FLOATMP_VECTOR_HPP
+#define TEUTHID_FLOATMP_VECTOR_HPP
+
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include <mpfr.h>
+#include <teuthid/floatmp.hpp>
+#include <teuthid/floatmp_accumulator.hpp>
+
+namespace teuthid {
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+class floatmp_io;
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+template <std::size_t Precision, typename Policy = floatmp_policy<>>
+class floatmp_vector {
+  TEUTHID_CHECK_FLOATMP_PRECISION(Precision);
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+  friend class floatmp_io;
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+public:
+  typedef floatmp<Precision, Policy> value_type;
+
+  floatmp_vector() noexcept : size_(0), limbs_(nullptr) {}
+  explicit floatmp_vector(std::size_t n) : floatmp_vector() { resize(n); }
+  template <typename T>
+  floatmp_vector(std::size_t n, const T &x) : floatmp_vector(n) {
+    fill(x);
+  }
+  floatmp_vector(const floatmp_vector &x) : floatmp_vector() { assign(x); }
+  floatmp_vector(floatmp_vector &&x) noexcept : floatmp_vector() { swap(x); }
+  floatmp_vector &operator=(const floatmp_vector &x) { return assign(x); }
+  floatmp_vector &operator=(floatmp_vector &&x) noexcept {
+    floatmp_vector __x(std::move(x));
+    return swap(__x);
+  }
+
+  static constexpr std::size_t precision() noexcept { return Precision; }
+  std::size_t size() const noexcept { return size_; }
+  bool empty() const noexcept { return (size_ == 0); }
+  void resize(std::size_t n);
+  floatmp_vector &assign(const floatmp_vector &x);
+  floatmp_vector &swap(floatmp_vector &x) noexcept {
+    std::swap(size_, x.size_);
+    std::swap(slab_, x.slab_);
+    std::swap(limbs_, x.limbs_);
+    heads_.swap(x.heads_);
+    return *this;
+  }
+
+  value_type get(std::size_t i) const {
+    mpfr_t __v;
+    view_(i, __v);
+    return value_type(__v);
+  }
+  value_type operator[](std::size_t i) const { return get(i); }
+  value_type at(std::size_t i) const {
+    check_index_(i);
+    return get(i);
+  }
+  template <typename T> floatmp_vector &set(std::size_t i, const T &x) {
+    value_type __x(x);
+    mpfr_t __v;
+    view_(i, __v);
+    mpfr_set(__v, __x.c_mpfr(), MPFR_RNDN); // exact
+    store_(i, __v);
+    return *this;
+  }
+  template <typename T> floatmp_vector &fill(const T &x) {
+    for (std::size_t __i = 0; __i < size_; ++__i)
+      set(__i, x);
+    return *this;
+  }
+
+  // BLAS level 1
+  value_type dot(const floatmp_vector &y) const;
+  floatmp_vector &axpy(const value_type &a, const floatmp_vector &x);
+  floatmp_vector &scal(const value_type &a);
+  value_type nrm2() const;
+  value_type asum() const;
+  value_type sum() const;
+
+private:
+  // exponents and signs of all elements; the significands are kept in one
+  // aligned slab of limbs (size_ * floatmp_limbs(Precision))
+  struct head_t {
+    mpfr_exp_t exp;
+    int kind; // MPFR_*_KIND multiplied by the sign
+  };
+  static constexpr std::size_t stride_ = floatmp_limbs(Precision);
+  static constexpr std::size_t alignment_ = 64; // cache line
+
+  std::size_t size_;
+  std::unique_ptr<unsigned char[]> slab_;
+  mp_limb_t *limbs_;
+  std::vector<head_t> heads_;
+
+  static mpfr_rnd_t rnd_() noexcept {
+    return static_cast<mpfr_rnd_t>(Policy::rounding::mode());
+  }
+  void check_index_(std::size_t i) const {
+    if (i >= size_)
+      throw std::out_of_range("invalid index of floatmp_vector");
+  }
+  void check_size_(const floatmp_vector &x) const {
+    if (x.size_ != size_)
+      throw std::invalid_argument("different sizes of floatmp_vector");
+  }
+  // a temporary MPFR value sharing the limbs of the i-th element
+  void view_(std::size_t i, mpfr_ptr v) const {
+    mpfr_custom_init_set(v, heads_[i].kind, heads_[i].exp, Precision,
+                         limbs_ + i * stride_);
+  }
+  void store_(std::size_t i, mpfr_srcptr v) {
+    heads_[i].kind = mpfr_custom_get_kind(v);
+    heads_[i].exp = (mpfr_regular_p(v) ? mpfr_custom_get_exp(v) : 0);
+  }
+}; // class floatmp_vector
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+template <std::size_t P, typename R>
+void floatmp_vector<P, R>::resize(std::size_t n) {
+  if (n == size_)
+    return;
+  std::unique_ptr<unsigned char[]> __slab;
+  mp_limb_t *__limbs = nullptr;
+  if (n > 0) {
+    std::size_t __bytes = n * stride_ * sizeof(mp_limb_t);
+    std::size_t __space = __bytes + alignment_;
+    __slab.reset(new unsigned char[__space]);
+    void *__p = __slab.get();
+    __limbs = static_cast<mp_limb_t *>(
+        std::align(alignment_, __bytes, __p, __space));
+    std::memcpy(__limbs, limbs_,
+                std::min(n, size_) * stride_ * sizeof(mp_limb_t));
+  }
+  heads_.resize(n, head_t{0, MPFR_ZERO_KIND});
+  slab_.swap(__slab);
+  limbs_ = __limbs;
+  size_ = n;
+}
+
+template <std::size_t P, typename R>
+floatmp_vector<P, R> &floatmp_vector<P, R>::assign(const floatmp_vector &x) {
+  if (this != &x) {
+    resize(x.size_);
+    if (size_ > 0)
+      std::memcpy(limbs_, x.limbs_, size_ * stride_ * sizeof(mp_limb_t));
+    heads_ = x.heads_;
+  }
+  return *this;
+}
+
+template <std::size_t P, typename R>
+typename floatmp_vector<P, R>::value_type
+floatmp_vector<P, R>::dot(const floatmp_vector &y) const {
+  check_size_(y);
+  floatmp_accumulator<P, R> __acc;
+  MPFR_DECL_INIT(__xy, 2 * P);
+  mpfr_t __x, __y;
+  for (std::size_t __i = 0; __i < size_; ++__i) {
+    view_(__i, __x);
+    y.view_(__i, __y);
+    mpfr_mul(__xy, __x, __y, MPFR_RNDN); // exact
+    __acc.accumulate(__xy);
+  }
+  return __acc.result();
+}
+
+template <std::size_t P, typename R>
+floatmp_vector<P, R> &floatmp_vector<P, R>::axpy(const value_type &a,
+                                                 const floatmp_vector &x) {
+  check_size_(x);
+  mpfr_t __x, __y;
+  for (std::size_t __i = 0; __i < size_; ++__i) {
+    x.view_(__i, __x);
+    view_(__i, __y);
+    mpfr_fma(__y, a.c_mpfr(), __x, __y, rnd_());
+    store_(__i, __y);
+  }
+  return *this;
+}
+
+template <std::size_t P, typename R>
+floatmp_vector<P, R> &floatmp_vector<P, R>::scal(const value_type &a) {
+  mpfr_t __x;
+  for (std::size_t __i = 0; __i < size_; ++__i) {
+    view_(__i, __x);
+    mpfr_mul(__x, __x, a.c_mpfr(), rnd_());
+    store_(__i, __x);
+  }
+  return *this;
+}
+
+template <std::size_t P, typename R>
+typename floatmp_vector<P, R>::value_type floatmp_vector<P, R>::nrm2() const {
+  floatmp_accumulator<P, R> __acc;
+  MPFR_DECL_INIT(__xx, 2 * P);
+  mpfr_t __x;
+  for (std::size_t __i = 0; __i < size_; ++__i) {
+    view_(__i, __x);
+    mpfr_sqr(__xx, __x, MPFR_RNDN); // exact
+    __acc.accumulate(__xx);
+  }
+  MPFR_DECL_INIT(__nrm2, P);
+  mpfr_sqrt(__nrm2, __acc.c_mpfr(), rnd_()); // rounded once
+  return value_type(__nrm2);
+}
+
+template <std::size_t P, typename R>
+typename floatmp_vector<P, R>::value_type floatmp_vector<P, R>::asum() const {
+  floatmp_accumulator<P, R> __acc;
+  mpfr_t __x;
+  for (std::size_t __i = 0; __i < size_; ++__i) {
+    view_(__i, __x);
+    mpfr_setsign(__x, __x, 0, MPFR_RNDN); // |x| shares the limbs
+    __acc.accumulate(__x);
+  }
+  return __acc.result();
+}
+
+template <std::size_t P, typename R>
+typename floatmp_vector<P, R>::value_type floatmp_vector<P, R>::sum() const {
+  floatmp_accumulator<P, R> __acc;
+  mpfr_t __x;
+  for (std::size_t __i = 0; __i < size_; ++__i) {
+    view_(__i, __x);
+    __acc.accumulate(__x);
+  }
+  return __acc.result();
+}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+} // namespace teuthid
+
+namespace std {
+template <size_t P, typename R>
+inline void swap(teuthid::floatmp_vector<P, R> &x,
+                 teuthid::floatmp_vector<P, R> &y) noexcept {
+  x.swap(y);
+}
+} // namespace std
+
+#endif // TEUTHID_FLOATMP_VECTOR_HPP
@@ -0,0 +1,85 @@
+/*
+  This file is part of the Teuthid project.
+  Copyright (c) 2016-2017 Mariusz Przygodzki (mariusz.przygodzki@gmail.com)
+
+  The Teuthid is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or (at your
+  option) any later version.
+
+  The Teuthid is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+  FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+  for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with the Teuthid; see the file LICENSE.LGPLv3.  If not, see
+  <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef TEUTHID_HOST_TOPOLOGY_HPP
+#define TEUTHID_HOST_TOPOLOGY_HPP
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include <teuthid/config.hpp>
+
+namespace teuthid {
+
+enum class cpu_cache_t : int { data = 0, instruction = 1, unified = 2 };
+
+class host_topology {
+public:
+  struct logical_cpu {
+    unsigned id;      // the number of the CPU in the operating system
+    unsigned core;    // the index of its physical core
+    unsigned package; // the physical package (socket)
+    unsigned node;    // the index of its NUMA node in nodes()
+  };
+  struct cache {
+    unsigned level;
+    cpu_cache_t type;
+    std::size_t size;
+    std::size_t line_size;
+    unsigned ways;
+    std::vector<unsigned> cpus; // the CPUs sharing the cache
+  };
+  struct numa_node {
+    unsigned id;
+    std::size_t memory;
+    std::vector<unsigned> cpus;
+  };
+
+  host_topology() : host_topology("/sys/devices/system") {}
+  explicit host_topology(const std::string &root);
+
+  const std::vector<logical_cpu> &cpus() const noexcept { return cpus_; }
+  const std::vector<cache> &caches() const noexcept { return caches_; }
+  const std::vector<numa_node> &nodes() const noexcept { return nodes_; }
+  std::size_t logical_cpus() const noexcept { return cpus_.size(); }
+  std::size_t physical_cores() const noexcept { return cores_; }
+  std::size_t packages() const noexcept { return packages_; }
+  std::size_t threads_per_core() const noexcept {
+    return (cpus_.size() + cores_ - 1) / cores_;
+  }
+  std::size_t cache_size(unsigned level) const noexcept;
+  std::size_t cache_line_size() const noexcept;
+
+private:
+  std::vector<logical_cpu> cpus_;
+  std::vector<cache> caches_;
+  std::vector<numa_node> nodes_;
+  std::size_t cores_;
+  std::size_t packages_;
+
+  void read_cpus_(const std::string &root);
+  void read_caches_(const std::string &root);
+  void read_nodes_(const std::string &root);
+  void assume_flat_();
+}; // class host_topology
+
+} // namespace teuthid
+
+#endif // TEUTHID_HOST_TOPOLOGY_HPP
@@ -0,0 +1,51 @@
+/*
+  This file is part of the Teuthid project.
+  Copyright (c) 2016-2017 Mariusz Przygodzki (mariusz.przygodzki@gmail.com)
+
+  The Teuthid is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or (at your
+  option) any later version.
+
+  The Teuthid is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+  FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+  for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with the Teuthid; see the file LICENSE.LGPLv3.  If not, see
+  <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef TEUTHID_MAPPED_FILE_HPP
+#define TEUTHID_MAPPED_FILE_HPP
+
+#include <cstddef>
+#include <string>
+
+#include <teuthid/config.hpp>
+
+namespace teuthid {
+
+class mapped_file {
+public:
+  explicit mapped_file(const std::string &path);
+  mapped_file(const mapped_file &) = delete;
+  mapped_file &operator=(const mapped_file &) = delete;
+  ~mapped_file() { release_(); }
+
+  const char *data() const noexcept { return static_cast<const char *>(data_); }
+  std::size_t size() const noexcept { return size_; }
+  bool is_mapped() const noexcept { return mapped_; }
+
+private:
+  void *data_;
+  std::size_t size_;
+  bool mapped_;
+
+  void release_() noexcept;
+}; // class mapped_file
+
+} // namespace teuthid
+
+#endif // TEUTHID_MAPPED_FILE_HPP
@@ -23,13 +23,28 @@
 #include <atomic>
 #include <cmath>
 #include <string>
+#include <system_error>
 #include <utility>
 #include <vector>
 
 #include <teuthid/floatmp.hpp>
+#include <teuthid/host_topology.hpp>
 
 namespace teuthid {
 
+enum class cpu_feature_t : int {
+  sse4_2 = 0,
+  avx = 1,
+  avx2 = 2,
+  fma = 3,
+  f16c = 4,
+  avx512f = 5,
+  avx512dq = 6,
+  avx512cd = 7,
+  avx512bw = 8,
+  avx512vl = 9
+};
+
 class system final {
 public:
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
@@ -45,34 +60,107 @@ public:
   static const std::string &version() noexcept { return system::version_; }
   static bool check_version(uint8_t major, uint8_t minor) noexcept;
   static bool has_cl_backend();
-  static bool uses_cl_backend() noexcept { return system::clb_.load(); }
+  static void probe_cl_backend() noexcept;
+  static bool uses_cl_backend() noexcept;
   static bool uses_cl_backend(bool enabled);
+  static bool has_cpu_feature(cpu_feature_t feature) noexcept;
+  static std::string cpu_features();
+  static const host_topology &topology();
 
   template <typename T> static std::string to_string(const T &x) {
     TETHID_CHECK_TYPE_SPECIALIZATION(T);
   }
+  struct to_chars_result {
+    char *ptr;
+    std::errc ec;
+  };
+  template <typename T>
+  static to_chars_result to_chars(char *first, char *last,
+                                  const T &x) = delete;
   static std::size_t split_string(const std::string &s,
                                   std::vector<std::string> &v,
                                   char delim = ' ');
+  struct float_format {
+    std::streamsize precision;
+    bool scientific;
+  };
+  template <typename T>
+  static std::string to_string(const T &x,
+                               const float_format &format) = delete;
   static constexpr std::streamsize default_format_float_precision() noexcept {
     return default_format_float_precision_;
   }
+  static const float_format &float_output() noexcept { return float_format_; }
   static void format_float_output(
       std::streamsize precision = system::default_format_float_precision(),
       bool scientific = false);
   static std::streamsize format_float_precision(std::streamsize precision);
-  static bool format_float_scientific(bool scientific) {
-    return format_float_scientific_.exchange(scientific);
+  static bool format_float_scientific(bool scientific) noexcept {
+    bool __prev = float_format_.scientific;
+    float_format_.scientific = scientific;
+    return __prev;
   }
+
+  class float_format_scope {
+  public:
+    explicit float_format_scope(const float_format &format)
+        : previous_(float_output()) {
+      format_float_output(format.precision, format.scientific);
+    }
+    explicit float_format_scope(std::streamsize precision,
+                                bool scientific = false)
+        : float_format_scope(float_format{precision, scientific}) {}
+    float_format_scope(const float_format_scope &) = delete;
+    float_format_scope &operator=(const float_format_scope &) = delete;
+    ~float_format_scope() {
+      format_float_output(previous_.precision, previous_.scientific);
+    }
+    const float_format &previous() const noexcept { return previous_; }
+
+  private:
+    float_format previous_;
+  }; // class float_format_scope
+
   template <typename T> static T &from_string(const std::string &s, T &x) {
     TETHID_CHECK_TYPE_SPECIALIZATION(T);
   }
+  struct from_chars_result {
+    const char *ptr;
+    std::errc ec;
+  };
+  template <typename T>
+  static from_chars_result from_chars(const char *first, const char *last,
+                                      T &x) = delete;
   template <typename T> static bool equal_to(const T &x, const T &y) {
     return (x == y);
   }
   template <typename T> static bool less_than(const T &x, const T &y) {
     return (x < y);
   }
+  struct float_tolerance {
+    long double absolute;
+    long double relative;
+    uint64_t ulps;
+  };
+  static constexpr float_tolerance default_comparison_tolerance() noexcept {
+    return {default_comparison_absolute_, 0, 0};
+  }
+  static const float_tolerance &comparison_tolerance() noexcept {
+    return comparison_tolerance_;
+  }
+  static float_tolerance comparison_tolerance(const float_tolerance &tolerance);
+  template <typename T>
+  static bool is_close(const T &x, const T &y,
+                       const float_tolerance &tolerance =
+                           comparison_tolerance()) = delete;
+  template <typename T>
+  static bool all_close(const T *x, const T *y, std::size_t n,
+                        const float_tolerance &tolerance =
+                            comparison_tolerance()) = delete;
+  template <typename T>
+  static std::size_t count_equal(const T *x, const T *y, std::size_t n,
+                                 const float_tolerance &tolerance =
+                                     comparison_tolerance()) = delete;
   template <typename E> static constexpr bool test_enumerator(E en) noexcept {
     static_assert(std::is_enum<E>::value, "requires enumeration type");
     return static_cast<typename std::underlying_type<E>::type>(en);
@@ -127,42 +215,104 @@ public:
   static std::string to_string(void *const &x) {
     return system::to_string(reinterpret_cast<uintptr_t>(x));
   }
-  template <std::size_t P> static std::string to_string(const floatmp<P> &x) {
+  template <std::size_t P, typename R>
+  static std::string to_string(const floatmp<P, R> &x) {
     return system::to_string(x.c_mpfr());
   }
-  template <std::size_t P>
-  static floatmp<P> &from_string(const std::string &s, floatmp<P> &x);
-  template <std::size_t P> static bool is_finite(const floatmp<P> &x) {
+  template <std::size_t P, typename R>
+  static std::string to_string(const floatmp<P, R> &x,
+                               const float_format &format) {
+    return system::to_string(x.c_mpfr(), format);
+  }
+  template <typename E>
+  static std::string to_string(const floatmp_expr<E> &x) {
+    return system::to_string(x.eval());
+  }
+  template <typename E>
+  static std::string to_string(const floatmp_expr<E> &x,
+                               const float_format &format) {
+    return system::to_string(x.eval(), format);
+  }
+  template <std::size_t P, typename R>
+  static to_chars_result to_chars(char *first, char *last,
+                                  const floatmp<P, R> &x) {
+    return system::to_chars(first, last, x.c_mpfr());
+  }
+  template <std::size_t P, typename R>
+  static floatmp<P, R> &from_string(const std::string &s, floatmp<P, R> &x);
+  template <std::size_t P, typename R>
+  static from_chars_result from_chars(const char *first, const char *last,
+                                      floatmp<P, R> &x);
+  template <std::size_t P, typename R>
+  static bool is_finite(const floatmp<P, R> &x) {
     return x.is_finite();
   }
-  template <std::size_t P> static bool is_infinite(const floatmp<P> &x) {
+  template <std::size_t P, typename R>
+  static bool is_infinite(const floatmp<P, R> &x) {
     return x.is_infinite();
   }
-  template <std::size_t P> static bool is_nan(const floatmp<P> &x) {
+  template <std::size_t P, typename R>
+  static bool is_nan(const floatmp<P, R> &x) {
     return x.is_nan();
   }
-  template <std::size_t P> static bool is_zero(const floatmp<P> &x) {
-    return x.is_zero();
-  }
-  template <std::size_t P> static bool is_positive(const floatmp<P> &x) {
-    return x.is_positive();
-  }
-  template <std::size_t P> static bool is_negative(const floatmp<P> &x) {
-    return x.is_negative();
-  }
-  template <std::size_t P1, std::size_t P2>
-  static void swap(floatmp<P1> &x, floatmp<P2> &y) {
+  // floatmp values are compared with the tolerance, like the native floats
+  template <std::size_t P, typename R>
+  static bool is_zero(const floatmp<P, R> &x) {
+    MPFR_DECL_INIT(__zero, P);
+    mpfr_set_zero(__zero, 1);
+    return system::is_close(x.c_mpfr(), __zero, comparison_tolerance_);
+  }
+  template <std::size_t P, typename R>
+  static bool is_positive(const floatmp<P, R> &x) {
+    MPFR_DECL_INIT(__zero, P);
+    mpfr_set_zero(__zero, 1);
+    return system::less_than(__zero, x.c_mpfr());
+  }
+  template <std::size_t P, typename R>
+  static bool is_negative(const floatmp<P, R> &x) {
+    MPFR_DECL_INIT(__zero, P);
+    mpfr_set_zero(__zero, 1);
+    return system::less_than(x.c_mpfr(), __zero);
+  }
+  template <std::size_t P, typename R>
+  static bool equal_to(const floatmp<P, R> &x, const floatmp<P, R> &y) {
+    return system::equal_to(x.c_mpfr(), y.c_mpfr());
+  }
+  template <std::size_t P, typename R>
+  static bool less_than(const floatmp<P, R> &x, const floatmp<P, R> &y) {
+    return system::less_than(x.c_mpfr(), y.c_mpfr());
+  }
+  template <std::size_t P, typename R>
+  static bool
+  is_close(const floatmp<P, R> &x, const floatmp<P, R> &y,
+           const float_tolerance &tolerance = comparison_tolerance()) {
+    return system::is_close(x.c_mpfr(), y.c_mpfr(), tolerance);
+  }
+  template <std::size_t P1, typename R1, std::size_t P2, typename R2>
+  static void swap(floatmp<P1, R1> &x, floatmp<P2, R2> &y) {
     x.swap(y);
   }
-  template <std::size_t P>
-  static constexpr bool is_floatmp(const floatmp<P> &x) {
+  template <std::size_t P, typename R>
+  static constexpr bool is_floatmp(const floatmp<P, R> &x) {
+    return true;
+  }
+#ifdef TEUTHID_HAVE_QUADMATH
+  // std::is_floating_point<__float128> is false in strict ISO mode
+  static constexpr bool is_floating_point(const __float128 &x) {
     return true;
   }
-  template <std::size_t P> static floatmp<P> nextabove(const floatmp<P> &x) {
-    return floatmp<P>().nextabove(x);
+#endif // TEUTHID_HAVE_QUADMATH
+  template <std::size_t P, typename R>
+  static floatmp<P, R> nextabove(const floatmp<P, R> &x) {
+    floatmp<P, R> __r;
+    __r.nextabove(x);
+    return __r;
   }
-  template <std::size_t P> static floatmp<P> nextbelow(const floatmp<P> &x) {
-    return floatmp<P>().nextbelow(x);
+  template <std::size_t P, typename R>
+  static floatmp<P, R> nextbelow(const floatmp<P, R> &x) {
+    floatmp<P, R> __r;
+    __r.nextbelow(x);
+    return __r;
   }
 #endif // DOXYGEN_SHOULD_SKIP_THIS
 
@@ -172,11 +322,13 @@ private:
   static std::string version_;
   static std::atomic_bool clb_;
   static constexpr std::streamsize default_format_float_precision_ = 10;
-  static std::atomic<std::streamsize> format_float_precision_;
-  static std::atomic_bool format_float_scientific_;
+  static thread_local float_format float_format_;
+  // values equal when rounded to 10 decimal places
+  static constexpr long double default_comparison_absolute_ = 5e-11L;
+  static thread_local float_tolerance comparison_tolerance_;
 #ifdef TEUTHID_HAVE_INT_128
-  static std::string uint128_to_string_(uint128_t x);
-  static uint128_t string_to_unit128_(const std::string &s);
+  static std::string uint128_to_string_(uint128_t x, bool negative);
+  static uint128_t string_to_unit128_(const std::string &s, uint128_t max);
 #endif
   static std::string validate_string_(const std::string &s);
 }; // class system
@@ -191,9 +343,55 @@ template <> std::string system::to_string(const uint128_t &x);
 template <> std::string system::to_string(const float &x);
 template <> std::string system::to_string(const double &x);
 template <> std::string system::to_string(const long double &x);
+#ifdef TEUTHID_HAVE_QUADMATH
+template <> std::string system::to_string(const __float128 &x);
+#endif // TEUTHID_HAVE_QUADMATH
 template <> std::string system::to_string(const mpfr_t &x);
 template <> std::string system::to_string(const floatmp_base &x);
 template <> std::string system::to_string(const std::vector<std::string> &v);
+template <>
+std::string system::to_string(const float &x, const float_format &format);
+template <>
+std::string system::to_string(const double &x, const float_format &format);
+template <>
+std::string system::to_string(const long double &x,
+                              const float_format &format);
+#ifdef TEUTHID_HAVE_QUADMATH
+template <>
+std::string system::to_string(const __float128 &x, const float_format &format);
+#endif // TEUTHID_HAVE_QUADMATH
+template <>
+std::string system::to_string(const mpfr_t &x, const float_format &format);
+template <>
+std::string system::to_string(const floatmp_base &x,
+                              const float_format &format);
+
+// specializations of system::to_chars<T>()
+#define __TEUTHID_SYSTEM_TO_CHARS(TYPE)                                        \
+  template <>                                                                  \
+  system::to_chars_result system::to_chars(char *first, char *last,            \
+                                           const TYPE &x);
+__TEUTHID_SYSTEM_TO_CHARS(int8_t)
+__TEUTHID_SYSTEM_TO_CHARS(int16_t)
+__TEUTHID_SYSTEM_TO_CHARS(int32_t)
+__TEUTHID_SYSTEM_TO_CHARS(int64_t)
+__TEUTHID_SYSTEM_TO_CHARS(uint8_t)
+__TEUTHID_SYSTEM_TO_CHARS(uint16_t)
+__TEUTHID_SYSTEM_TO_CHARS(uint32_t)
+__TEUTHID_SYSTEM_TO_CHARS(uint64_t)
+#ifdef TEUTHID_HAVE_INT_128
+__TEUTHID_SYSTEM_TO_CHARS(int128_t)
+__TEUTHID_SYSTEM_TO_CHARS(uint128_t)
+#endif // TEUTHID_HAVE_INT_128
+__TEUTHID_SYSTEM_TO_CHARS(float)
+__TEUTHID_SYSTEM_TO_CHARS(double)
+__TEUTHID_SYSTEM_TO_CHARS(long double)
+#ifdef TEUTHID_HAVE_QUADMATH
+__TEUTHID_SYSTEM_TO_CHARS(__float128)
+#endif // TEUTHID_HAVE_QUADMATH
+__TEUTHID_SYSTEM_TO_CHARS(mpfr_t)
+__TEUTHID_SYSTEM_TO_CHARS(floatmp_base)
+#undef __TEUTHID_SYSTEM_TO_CHARS
 
 // specializations of system::from_string<T>()
 // may throw: std::invalid_argument, std::out_of_range
@@ -210,12 +408,16 @@ template <> float &system::from_string(const std::string &s, float &x);
 template <> double &system::from_string(const std::string &s, double &x);
 template <>
 long double &system::from_string(const std::string &s, long double &x);
+#ifdef TEUTHID_HAVE_QUADMATH
+template <>
+__float128 &system::from_string(const std::string &s, __float128 &x);
+#endif // TEUTHID_HAVE_QUADMATH
 template <> mpfr_t &system::from_string(const std::string &s, mpfr_t &x);
 template <>
 floatmp_base &system::from_string(const std::string &s, floatmp_base &x);
-template <std::size_t P>
-floatmp<P> &system::from_string(const std::string &s, floatmp<P> &x) {
-  return dynamic_cast<floatmp<P> &>(
+template <std::size_t P, typename R>
+floatmp<P, R> &system::from_string(const std::string &s, floatmp<P, R> &x) {
+  return dynamic_cast<floatmp<P, R> &>(
       system::from_string(s, static_cast<floatmp_base &>(x)));
 }
 #ifdef TEUTHID_HAVE_INT_128
@@ -223,16 +425,83 @@ template <> int128_t &system::from_string(const std::string &s, int128_t &x);
 template <> uint128_t &system::from_string(const std::string &s, uint128_t &x);
 #endif // TEUTHID_HAVE_INT_128
 
+// specializations of system::from_chars<T>()
+#define __TEUTHID_SYSTEM_FROM_CHARS(TYPE)                                      \
+  template <>                                                                  \
+  system::from_chars_result system::from_chars(const char *first,              \
+                                               const char *last, TYPE &x);
+__TEUTHID_SYSTEM_FROM_CHARS(bool)
+__TEUTHID_SYSTEM_FROM_CHARS(int8_t)
+__TEUTHID_SYSTEM_FROM_CHARS(int16_t)
+__TEUTHID_SYSTEM_FROM_CHARS(int32_t)
+__TEUTHID_SYSTEM_FROM_CHARS(int64_t)
+__TEUTHID_SYSTEM_FROM_CHARS(uint8_t)
+__TEUTHID_SYSTEM_FROM_CHARS(uint16_t)
+__TEUTHID_SYSTEM_FROM_CHARS(uint32_t)
+__TEUTHID_SYSTEM_FROM_CHARS(uint64_t)
+#ifdef TEUTHID_HAVE_INT_128
+__TEUTHID_SYSTEM_FROM_CHARS(int128_t)
+__TEUTHID_SYSTEM_FROM_CHARS(uint128_t)
+#endif // TEUTHID_HAVE_INT_128
+__TEUTHID_SYSTEM_FROM_CHARS(float)
+__TEUTHID_SYSTEM_FROM_CHARS(double)
+__TEUTHID_SYSTEM_FROM_CHARS(long double)
+#ifdef TEUTHID_HAVE_QUADMATH
+__TEUTHID_SYSTEM_FROM_CHARS(__float128)
+#endif // TEUTHID_HAVE_QUADMATH
+__TEUTHID_SYSTEM_FROM_CHARS(mpfr_t)
+__TEUTHID_SYSTEM_FROM_CHARS(floatmp_base)
+#undef __TEUTHID_SYSTEM_FROM_CHARS
+template <std::size_t P, typename R>
+system::from_chars_result system::from_chars(const char *first,
+                                             const char *last,
+                                             floatmp<P, R> &x) {
+  return system::from_chars(first, last, static_cast<floatmp_base &>(x));
+}
+
 // specializations of system::equal_to<T>()
 template <> bool system::equal_to(const float &x, const float &y);
 template <> bool system::equal_to(const double &x, const double &y);
 template <> bool system::equal_to(const long double &x, const long double &y);
+#ifdef TEUTHID_HAVE_QUADMATH
+template <> bool system::equal_to(const __float128 &x, const __float128 &y);
+#endif // TEUTHID_HAVE_QUADMATH
 template <> bool system::equal_to(const mpfr_t &x, const mpfr_t &y);
 
+// specializations of system::is_close<T>(), system::all_close<T>() and
+// system::count_equal<T>()
+#define __TEUTHID_SYSTEM_IS_CLOSE(TYPE)                                        \
+  template <>                                                                  \
+  bool system::is_close(const TYPE &x, const TYPE &y,                          \
+                        const float_tolerance &tolerance);
+#define __TEUTHID_SYSTEM_ALL_CLOSE(TYPE)                                       \
+  template <>                                                                  \
+  bool system::all_close(const TYPE *x, const TYPE *y, std::size_t n,          \
+                         const float_tolerance &tolerance);                    \
+  template <>                                                                  \
+  std::size_t system::count_equal(const TYPE *x, const TYPE *y, std::size_t n, \
+                                  const float_tolerance &tolerance);
+__TEUTHID_SYSTEM_IS_CLOSE(float)
+__TEUTHID_SYSTEM_IS_CLOSE(double)
+__TEUTHID_SYSTEM_IS_CLOSE(long double)
+__TEUTHID_SYSTEM_ALL_CLOSE(float)
+__TEUTHID_SYSTEM_ALL_CLOSE(double)
+__TEUTHID_SYSTEM_ALL_CLOSE(long double)
+#ifdef TEUTHID_HAVE_QUADMATH
+__TEUTHID_SYSTEM_IS_CLOSE(__float128)
+__TEUTHID_SYSTEM_ALL_CLOSE(__float128)
+#endif // TEUTHID_HAVE_QUADMATH
+__TEUTHID_SYSTEM_IS_CLOSE(mpfr_t)
+#undef __TEUTHID_SYSTEM_IS_CLOSE
+#undef __TEUTHID_SYSTEM_ALL_CLOSE
+
 // specializations of system::less_than<T>()
 template <> bool system::less_than(const float &x, const float &y);
 template <> bool system::less_than(const double &x, const double &y);
 template <> bool system::less_than(const long double &x, const long double &y);
+#ifdef TEUTHID_HAVE_QUADMATH
+template <> bool system::less_than(const __float128 &x, const __float128 &y);
+#endif // TEUTHID_HAVE_QUADMATH
 template <> bool system::less_than(const mpfr_t &x, const mpfr_t &y);
 
 // specialization of system::is_finite<T>()
@@ -253,6 +522,9 @@ __TEUTHID_SYSTEM_IS_FINITE(uint64_t)
 __TEUTHID_SYSTEM_IS_FINITE(float)
 __TEUTHID_SYSTEM_IS_FINITE(double)
 __TEUTHID_SYSTEM_IS_FINITE(long double)
+#ifdef TEUTHID_HAVE_QUADMATH
+__TEUTHID_SYSTEM_IS_FINITE(__float128)
+#endif
 #undef __TEUTHID_SYSTEM_IS_FINITE
 template <> inline bool system::is_finite(const mpfr_t &x) {
   return (mpfr_number_p(x) != 0);
@@ -261,11 +533,11 @@ template <> inline bool system::is_finite(const floatmp_base &x) {
   return x.is_finite();
 }
 #ifdef TEUTHID_HAVE_INT_128
-template <> inline bool system::is_finite(const int128_t &x) {
-  return system::is_finite(floatmp_base::int128_to_ldouble_(x));
+template <> inline bool system::is_finite(const int128_t &) {
+  return true;
 }
-template <> inline bool system::is_finite(const uint128_t &x) {
-  return system::is_finite(floatmp_base::uint128_to_ldouble_(x));
+template <> inline bool system::is_finite(const uint128_t &) {
+  return true;
 }
 #endif // TEUTHID_HAVE_INT_128
 
@@ -287,6 +559,9 @@ __TEUTHID_SYSTEM_IS_INFINITE(uint64_t)
 __TEUTHID_SYSTEM_IS_INFINITE(float)
 __TEUTHID_SYSTEM_IS_INFINITE(double)
 __TEUTHID_SYSTEM_IS_INFINITE(long double)
+#ifdef TEUTHID_HAVE_QUADMATH
+__TEUTHID_SYSTEM_IS_INFINITE(__float128)
+#endif
 #undef __TEUTHID_SYSTEM_IS_INFINITE
 template <> inline bool system::is_infinite(const mpfr_t &x) {
   return (mpfr_inf_p(x) != 0);
@@ -295,11 +570,11 @@ template <> inline bool system::is_infinite(const floatmp_base &x) {
   return x.is_infinite();
 }
 #ifdef TEUTHID_HAVE_INT_128
-template <> inline bool system::is_infinite(const int128_t &x) {
-  return system::is_infinite(floatmp_base::int128_to_ldouble_(x));
+template <> inline bool system::is_infinite(const int128_t &) {
+  return false;
 }
-template <> inline bool system::is_infinite(const uint128_t &x) {
-  return system::is_infinite(floatmp_base::uint128_to_ldouble_(x));
+template <> inline bool system::is_infinite(const uint128_t &) {
+  return false;
 }
 #endif // TEUTHID_HAVE_INT_128
 
@@ -321,6 +596,9 @@ __TEUTHID_SYSTEM_IS_NAN(uint64_t)
 __TEUTHID_SYSTEM_IS_NAN(float)
 __TEUTHID_SYSTEM_IS_NAN(double)
 __TEUTHID_SYSTEM_IS_NAN(long double)
+#ifdef TEUTHID_HAVE_QUADMATH
+__TEUTHID_SYSTEM_IS_NAN(__float128)
+#endif
 #undef __TEUTHID_SYSTEM_IS_NAN
 template <> inline bool system::is_nan(const mpfr_t &x) {
   return (mpfr_nan_p(x) != 0);
@@ -329,11 +607,11 @@ template <> inline bool system::is_nan(const floatmp_base &x) {
   return x.is_nan();
 }
 #ifdef TEUTHID_HAVE_INT_128
-template <> inline bool system::is_nan(const int128_t &x) {
-  return system::is_nan(floatmp_base::int128_to_ldouble_(x));
+template <> inline bool system::is_nan(const int128_t &) {
+  return false;
 }
-template <> inline bool system::is_nan(const uint128_t &x) {
-  return system::is_nan(floatmp_base::uint128_to_ldouble_(x));
+template <> inline bool system::is_nan(const uint128_t &) {
+  return false;
 }
 #endif // TEUTHID_HAVE_INT_128
 
@@ -361,6 +639,11 @@ template <> inline bool system::is_zero(const double &x) {
 template <> inline bool system::is_zero(const long double &x) {
   return system::equal_to(x, static_cast<long double>(0));
 }
+#ifdef TEUTHID_HAVE_QUADMATH
+template <> inline bool system::is_zero(const __float128 &x) {
+  return system::equal_to(x, static_cast<__float128>(0));
+}
+#endif // TEUTHID_HAVE_QUADMATH
 template <> inline bool system::is_zero(const mpfr_t &x) {
   return system::equal_to(mpfr_get_ld(x, mpfr_get_default_rounding_mode()),
                           static_cast<long double>(0));
@@ -392,6 +675,11 @@ template <> inline bool system::is_positive(const double &x) {
 template <> inline bool system::is_positive(const long double &x) {
   return system::less_than(static_cast<long double>(0), x);
 }
+#ifdef TEUTHID_HAVE_QUADMATH
+template <> inline bool system::is_positive(const __float128 &x) {
+  return system::less_than(static_cast<__float128>(0), x);
+}
+#endif // TEUTHID_HAVE_QUADMATH
 template <> inline bool system::is_positive(const mpfr_t &x) {
   return system::less_than(static_cast<long double>(0),
                            mpfr_get_ld(x, mpfr_get_default_rounding_mode()));
@@ -423,6 +711,11 @@ template <> inline bool system::is_negative(const double &x) {
 template <> inline bool system::is_negative(const long double &x) {
   return system::less_than(x, static_cast<long double>(0));
 }
+#ifdef TEUTHID_HAVE_QUADMATH
+template <> inline bool system::is_negative(const __float128 &x) {
+  return system::less_than(x, static_cast<__float128>(0));
+}
+#endif // TEUTHID_HAVE_QUADMATH
 template <> inline bool system::is_negative(const mpfr_t &x) {
   return system::less_than(mpfr_get_ld(x, mpfr_get_default_rounding_mode()),
                            static_cast<long double>(0));
@@ -441,6 +734,12 @@ template <> inline double system::nextabove(const double &x) {
 template <> inline long double system::nextabove(const long double &x) {
   return std::nextafter(x, std::numeric_limits<long double>::max());
 }
+#ifdef TEUTHID_HAVE_QUADMATH
+// FLT128_MAX is a Q-suffixed literal which is rejected in strict ISO mode
+template <> inline __float128 system::nextabove(const __float128 &x) {
+  return nextafterq(x, nextafterq(HUGE_VALQ, 0));
+}
+#endif // TEUTHID_HAVE_QUADMATH
 
 // specialization of system::nextbelow<T>()
 template <> inline float system::nextbelow(const float &x) {
@@ -452,6 +751,11 @@ template <> inline double system::nextbelow(const double &x) {
 template <> inline long double system::nextbelow(const long double &x) {
   return std::nextafter(x, std::numeric_limits<long double>::lowest());
 }
+#ifdef TEUTHID_HAVE_QUADMATH
+template <> inline __float128 system::nextbelow(const __float128 &x) {
+  return nextafterq(x, -nextafterq(HUGE_VALQ, 0));
+}
+#endif // TEUTHID_HAVE_QUADMATH
 
 #endif // DOXYGEN_SHOULD_SKIP_THIS
 
@@ -0,0 +1,143 @@
+/*
+  This file is part of the Teuthid project.
+  Copyright (c) 2016-2017 Mariusz Przygodzki (mariusz.przygodzki@gmail.com)
+
+  The Teuthid is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or (at your
+  option) any later version.
+
+  The Teuthid is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+  FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+  for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with the Teuthid; see the file LICENSE.LGPLv3.  If not, see
+  <http://www.gnu.org/licenses/>.
+*/
+
+#include <algorithm>
+#include <exception>
+#include <stdexcept>
+#include <thread>
+
+#include <teuthid/dataset.hpp>
+
+using namespace teuthid;
+
+namespace {
+// the smallest chunk which is worth a thread
+constexpr std::size_t __min_chunk_size = 1 << 20;
+} // namespace
+
+dataset_base::dataset_base(const std::string &path,
+                           const dataset_format &format)
+    : delimiter_(format.delimiter), start_(std::chrono::steady_clock::now()),
+      file_(path), threads_(format.threads), rows_(0), columns_(0),
+      seconds_(0) {
+  if (threads_ == 0)
+    threads_ = std::max(std::thread::hardware_concurrency(), 1u);
+  const char *__p = file_.data(), *__last = __p + file_.size();
+  const char *__line_first, *__line_last, *__field_first, *__field_last;
+  // the names of the columns, or the number of the fields in the first line
+  const char *__q = __p;
+  if (next_line_(__q, __last, __line_first, __line_last)) {
+    bool __more = true;
+    for (; __more; ++columns_) {
+      __more = next_field_(__line_first, __line_last, __field_first,
+                           __field_last);
+      if (format.header)
+        names_.emplace_back(__field_first, __field_last);
+    }
+    if (format.header)
+      __p = __q;
+  }
+  split_(__p, __last);
+  chunk_rows_.assign(chunks_.size() - 1, 0);
+  run_([this](std::size_t k) {
+    const char *__p = chunks_[k], *__first, *__last;
+    std::size_t __rows = 0;
+    while (next_line_(__p, chunks_[k + 1], __first, __last))
+      ++__rows;
+    chunk_rows_[k] = __rows;
+  });
+  for (std::size_t __k = 0; __k < chunk_rows_.size(); ++__k)
+    rows_ += chunk_rows_[__k];
+}
+
+void dataset_base::split_(const char *first, const char *last) {
+  std::size_t __chunks = std::min<std::size_t>(
+      threads_, std::max<std::size_t>((last - first) / __min_chunk_size, 1));
+  std::size_t __size = (last - first) / __chunks;
+  chunks_.assign(1, first);
+  for (std::size_t __k = 1; __k < __chunks; ++__k) {
+    // the chunks end after a new line
+    const char *__p = std::max(first + __k * __size, chunks_.back());
+    const char *__eol =
+        static_cast<const char *>(std::memchr(__p, '\n', last - __p));
+    __p = __eol ? (__eol + 1) : last;
+    if (__p != chunks_.back())
+      chunks_.push_back(__p);
+  }
+  if (chunks_.back() != last)
+    chunks_.push_back(last);
+  if (chunks_.size() == 1)
+    chunks_.push_back(last); // an empty chunk
+}
+
+void dataset_base::run_(const std::function<void(std::size_t)> &task) {
+  std::size_t __n = chunks_.size() - 1;
+  std::vector<std::exception_ptr> __errors(__n);
+  std::vector<std::thread> __threads;
+  auto __run = [&task, &__errors](std::size_t k) {
+    try {
+      task(k);
+    } catch (...) {
+      __errors[k] = std::current_exception();
+    }
+  };
+  for (std::size_t __k = 1; __k < __n; ++__k)
+    __threads.emplace_back(__run, __k);
+  __run(0);
+  for (auto &__th : __threads)
+    __th.join();
+  // the error of the first row
+  for (auto &__error : __errors)
+    if (__error)
+      std::rethrow_exception(__error);
+}
+
+void dataset_base::parse_(const chunk_parser_ &parse) {
+  std::vector<std::size_t> __first_rows(chunk_rows_.size(), 0);
+  for (std::size_t __k = 1; __k < chunk_rows_.size(); ++__k)
+    __first_rows[__k] = __first_rows[__k - 1] + chunk_rows_[__k - 1];
+  run_([this, &parse, &__first_rows](std::size_t k) {
+    parse(chunks_[k], chunks_[k + 1], __first_rows[k]);
+  });
+  seconds_ = std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                           start_)
+                 .count();
+}
+
+bool dataset_base::next_field_(const char *&p, const char *last,
+                               const char *&field_first,
+                               const char *&field_last) const noexcept {
+  const char *__d =
+      static_cast<const char *>(std::memchr(p, delimiter_, last - p));
+  field_first = p;
+  field_last = __d ? __d : last;
+  p = __d ? (__d + 1) : last;
+  while ((field_first < field_last) &&
+         ((*field_first == ' ') || (*field_first == '\t')))
+    ++field_first;
+  while ((field_last > field_first) &&
+         ((field_last[-1] == ' ') || (field_last[-1] == '\t')))
+    --field_last;
+  return (__d != nullptr);
+}
+
+void dataset_base::invalid_value_(std::size_t row, std::size_t column) {
+  throw std::runtime_error("invalid value in row " + std::to_string(row) +
+                           ", column " + std::to_string(column));
+}
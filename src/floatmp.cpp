@@ -18,153 +18,326 @@
 */
 
 #include <stdexcept>
+#include <utility>
+#include <vector>
 
 #include <teuthid/floatmp.hpp>
 #include <teuthid/system.hpp>
 
 using namespace teuthid;
 
-std::atomic_int floatmp_base::round_mode_(mpfr_get_default_rounding_mode());
-const floatmp_base floatmp_base::zero_(floatmp_base::max_precision());
-const floatmp_base floatmp_base::minus_one_(floatmp_base::max_precision(),
-                                            static_cast<long double>(-1));
-const floatmp_base floatmp_base::plus_one_(floatmp_base::max_precision(),
-                                           static_cast<long double>(1));
+thread_local mpfr_rnd_t floatmp_base::round_mode_ = MPFR_RNDN;
+thread_local floatmp_base::comparison_rule_ floatmp_base::comparison_ = {
+    floatmp_comparison_t::exact, 0};
 
-bool floatmp_base::equal_to(const floatmp_base &x) const {
-  return system::equal_to(c_mpfr(), x.c_mpfr());
+namespace {
+// idle scratch registers of one thread, grouped by precision
+class __scratch_registers {
+public:
+  struct bucket_t {
+    mpfr_prec_t precision;
+    std::size_t registers; // idle and leased
+    std::vector<mpfr_ptr> idle;
+  };
+
+  __scratch_registers() = default;
+  __scratch_registers(const __scratch_registers &) = delete;
+  __scratch_registers &operator=(const __scratch_registers &) = delete;
+  ~__scratch_registers() { clear(); }
+  bucket_t &bucket(mpfr_prec_t precision) {
+    for (auto &__b : buckets_)
+      if (__b.precision == precision)
+        return __b;
+    buckets_.push_back(bucket_t{precision, 0, std::vector<mpfr_ptr>()});
+    return buckets_.back();
+  }
+  std::size_t size() const noexcept {
+    std::size_t __size = 0;
+    for (const auto &__b : buckets_)
+      __size += __b.idle.size();
+    return __size;
+  }
+  void clear() noexcept {
+    for (auto &__b : buckets_) {
+      for (mpfr_ptr __x : __b.idle) {
+        mpfr_clear(__x);
+        delete __x;
+      }
+      __b.registers -= __b.idle.size();
+      __b.idle.clear();
+    }
+  }
+
+private:
+  std::vector<bucket_t> buckets_;
+};
+
+thread_local __scratch_registers __scratch_pool;
+} // namespace
+
+std::size_t floatmp_scratch_pool::size() noexcept {
+  return __scratch_pool.size();
 }
 
-bool floatmp_base::less_than(const floatmp_base &x) const {
-  return system::less_than(c_mpfr(), x.c_mpfr());
+void floatmp_scratch_pool::clear() noexcept { __scratch_pool.clear(); }
+
+mpfr_ptr floatmp_scratch_pool::acquire_(std::size_t precision) {
+  TEUTHID_ASSERT_FLOATMP_PRECISION(precision);
+  auto &__b = __scratch_pool.bucket(static_cast<mpfr_prec_t>(precision));
+  mpfr_ptr __x;
+  if (__b.idle.empty()) {
+    // the list of idle registers has room for all registers, so release_()
+    // never allocates
+    __b.idle.reserve(__b.registers + 1);
+    floatmp_arena::suspend __suspend; // the registers outlive arena scopes
+    __x = new __mpfr_struct;
+    mpfr_init2(__x, __b.precision);
+    ++__b.registers;
+  } else {
+    __x = __b.idle.back();
+    __b.idle.pop_back();
+  }
+  mpfr_set_zero(__x, 1);
+  return __x;
 }
 
-bool floatmp_base::is_integer() const {
-  if (is_finite()) {
-    floatmp_base __x(mpfr_get_prec(c_mpfr()));
-    __x.trunc(*this);
-    return equal_to(__x);
+void floatmp_scratch_pool::release_(mpfr_ptr x) noexcept {
+  __scratch_pool.bucket(mpfr_get_prec(x)).idle.push_back(x);
+}
+
+bool floatmp_base::equal_to(const floatmp_base &x, floatmp_comparison_t mode,
+                            std::size_t tolerance) const {
+  if (mpfr_equal_p(value_, x.value_) != 0)
+    return true;
+  if ((mode == floatmp_comparison_t::exact) || !is_finite() || !x.is_finite())
+    return false;
+  // the difference needs only a few bits to be compared with the tolerance
+  MPFR_DECL_INIT(__d, 64);
+  mpfr_sub(__d, value_, x.value_, MPFR_RNDN);
+  mpfr_abs(__d, __d, MPFR_RNDN);
+  if (mode == floatmp_comparison_t::ulps) {
+    // |x - y| <= tolerance * 2^(exp - prec), the ulp of the larger operand
+    mpfr_exp_t __exp =
+        is_zero() ? mpfr_get_exp(x.value_)
+                  : (x.is_zero() ? mpfr_get_exp(value_)
+                                 : std::max(mpfr_get_exp(value_),
+                                            mpfr_get_exp(x.value_)));
+    mpfr_prec_t __prec =
+        std::min(mpfr_get_prec(value_), mpfr_get_prec(x.value_));
+    mpfr_mul_2si(__d, __d, __prec - __exp, MPFR_RNDN);
+    return (mpfr_cmp_ui(__d, tolerance) <= 0);
+  }
+  // |x - y| <= 10^(-tolerance) / 2, i.e. x and y are equal when rounded to
+  // tolerance decimal places
+  MPFR_DECL_INIT(__scale, 64);
+  mpfr_ui_pow_ui(__scale, 10, tolerance, MPFR_RNDN);
+  mpfr_mul(__d, __d, __scale, MPFR_RNDN);
+  return (mpfr_cmp_d(__d, 0.5) <= 0);
+}
+
+bool floatmp_base::is_integer() const { return (mpfr_integer_p(value_) != 0); }
+
+#ifdef TEUTHID_HAVE_QUADMATH
+void floatmp_base::float128_to_mpfr_(mpfr_ptr x, const __float128 &v,
+                                     mpfr_rnd_t rnd) {
+  if (!finiteq(v) || (v == 0)) { // NaN, infinities and signed zeros
+    mpfr_set_d(x, static_cast<double>(v), rnd);
+    return;
   }
-  return false;
+  // v = m * 2^e, 0.5 <= |m| < 1; m is split exactly into three doubles
+  int __e;
+  __float128 __m = frexpq(v, &__e);
+  double __hi = static_cast<double>(__m);
+  __m -= __hi;
+  double __mid = static_cast<double>(__m);
+  double __lo = static_cast<double>(__m - __mid);
+  MPFR_DECL_INIT(__v, 128);
+  mpfr_set_d(__v, __hi, MPFR_RNDN);
+  mpfr_add_d(__v, __v, __mid, MPFR_RNDN); // exact
+  mpfr_add_d(__v, __v, __lo, MPFR_RNDN);  // exact
+  mpfr_mul_2si(x, __v, __e, rnd);
+}
+
+__float128 floatmp_base::mpfr_to_float128_(mpfr_srcptr x, mpfr_rnd_t rnd) {
+  if ((mpfr_number_p(x) == 0) || (mpfr_zero_p(x) != 0))
+    return mpfr_get_d(x, rnd); // NaN, infinities and signed zeros
+  MPFR_DECL_INIT(__v, float128_digits_);
+  mpfr_set(__v, x, rnd);
+  mpfr_exp_t __e = mpfr_get_exp(__v);
+  mpfr_set_exp(__v, 0);
+  // the 113-bit significand is split exactly into three doubles
+  double __hi = mpfr_get_d(__v, MPFR_RNDN);
+  mpfr_sub_d(__v, __v, __hi, MPFR_RNDN);
+  double __mid = mpfr_get_d(__v, MPFR_RNDN);
+  mpfr_sub_d(__v, __v, __mid, MPFR_RNDN);
+  double __lo = mpfr_get_d(__v, MPFR_RNDN);
+  __float128 __m = static_cast<__float128>(__hi) + __mid + __lo;
+  // exponents out of the range of binary128 give infinities or zeros
+  __e = std::max<mpfr_exp_t>(std::min<mpfr_exp_t>(__e, 32768), -32768);
+  return ldexpq(__m, static_cast<int>(__e));
+}
+#endif // TEUTHID_HAVE_QUADMATH
+
+void floatmp_base::domain_error_(const char *what, floatmp_check_t check) {
+  if (check == floatmp_check_t::checked)
+    throw std::domain_error(what);
+  mpfr_set_nan(value_);
 }
 
-void floatmp_base::fmod(const floatmp_base &x, const floatmp_base &y) {
-  if (y.is_zero())
-    throw std::domain_error("invalid divisor of fmod()");
-  mpfr_fmod(value_, x.c_mpfr(), y.c_mpfr(), mpfr_rnd_());
+void floatmp_base::fmod(const floatmp_base &x, const floatmp_base &y,
+                        mpfr_rnd_t rnd, floatmp_check_t check) {
+  if ((check == floatmp_check_t::unchecked) || !y.is_zero())
+    mpfr_fmod(value_, x.c_mpfr(), y.c_mpfr(), rnd);
+  else
+    domain_error_("invalid divisor of fmod()", check);
 }
 
-void floatmp_base::remainder(const floatmp_base &x, const floatmp_base &y) {
-  if (y.is_zero())
-    throw std::domain_error("invalid divisor of remainder()");
-  mpfr_remainder(value_, x.c_mpfr(), y.c_mpfr(), mpfr_rnd_());
+void floatmp_base::remainder(const floatmp_base &x, const floatmp_base &y,
+                             mpfr_rnd_t rnd, floatmp_check_t check) {
+  if ((check == floatmp_check_t::unchecked) || !y.is_zero())
+    mpfr_remainder(value_, x.c_mpfr(), y.c_mpfr(), rnd);
+  else
+    domain_error_("invalid divisor of remainder()", check);
 }
 
-void floatmp_base::fmax(const floatmp_base &x, const floatmp_base &y) {
-  const floatmp_base &__max = (system::less_than(x.value_, y.value_)) ? y : x;
-  mpfr_set(value_, __max.c_mpfr(), mpfr_rnd_());
+void floatmp_base::fmax(const floatmp_base &x, const floatmp_base &y,
+                        mpfr_rnd_t rnd) {
+  mpfr_max(value_, x.c_mpfr(), y.c_mpfr(), rnd);
 }
 
-void floatmp_base::fmin(const floatmp_base &x, const floatmp_base &y) {
-  const floatmp_base &__min = (system::less_than(x.value_, y.value_)) ? x : y;
-  mpfr_set(value_, __min.c_mpfr(), mpfr_rnd_());
+void floatmp_base::fmin(const floatmp_base &x, const floatmp_base &y,
+                        mpfr_rnd_t rnd) {
+  mpfr_min(value_, x.c_mpfr(), y.c_mpfr(), rnd);
 }
 
-void floatmp_base::log(const floatmp_base &x) {
-  if (!x.is_positive())
-    throw std::domain_error("invalid arg of log()");
-  mpfr_log(value_, x.c_mpfr(), mpfr_rnd_());
+void floatmp_base::log(const floatmp_base &x, mpfr_rnd_t rnd,
+                       floatmp_check_t check) {
+  if ((check == floatmp_check_t::unchecked) || x.is_positive())
+    mpfr_log(value_, x.c_mpfr(), rnd);
+  else
+    domain_error_("invalid arg of log()", check);
 }
 
-void floatmp_base::log10(const floatmp_base &x) {
-  if (!x.is_positive())
-    throw std::domain_error("invalid arg of log10()");
-  mpfr_log10(value_, x.c_mpfr(), mpfr_rnd_());
+void floatmp_base::log10(const floatmp_base &x, mpfr_rnd_t rnd,
+                         floatmp_check_t check) {
+  if ((check == floatmp_check_t::unchecked) || x.is_positive())
+    mpfr_log10(value_, x.c_mpfr(), rnd);
+  else
+    domain_error_("invalid arg of log10()", check);
 }
 
-void floatmp_base::log2(const floatmp_base &x) {
-  if (!x.is_positive())
-    throw std::domain_error("invalid arg of log2()");
-  mpfr_log2(value_, x.c_mpfr(), mpfr_rnd_());
+void floatmp_base::log2(const floatmp_base &x, mpfr_rnd_t rnd,
+                        floatmp_check_t check) {
+  if ((check == floatmp_check_t::unchecked) || x.is_positive())
+    mpfr_log2(value_, x.c_mpfr(), rnd);
+  else
+    domain_error_("invalid arg of log2()", check);
 }
 
-void floatmp_base::log1p(const floatmp_base &x) {
-  if (!minus_one_.less_than(x))
-    throw std::domain_error("invalid arg of log1p()");
-  mpfr_log1p(value_, x.c_mpfr(), mpfr_rnd_());
+void floatmp_base::log1p(const floatmp_base &x, mpfr_rnd_t rnd,
+                         floatmp_check_t check) {
+  if ((check == floatmp_check_t::unchecked) ||
+      (mpfr_cmp_si(x.c_mpfr(), -1) > 0))
+    mpfr_log1p(value_, x.c_mpfr(), rnd);
+  else
+    domain_error_("invalid arg of log1p()", check);
 }
 
-void floatmp_base::pow(const floatmp_base &x, const floatmp_base &y) {
-  if (x.is_negative() && !y.is_integer())
-    throw std::domain_error("invalid arg of pow()");
-  if (x.is_zero() && !y.is_positive())
-    throw std::domain_error("invalid arg of pow()");
-  mpfr_pow(value_, x.c_mpfr(), y.c_mpfr(), mpfr_rnd_());
+void floatmp_base::pow(const floatmp_base &x, const floatmp_base &y,
+                       mpfr_rnd_t rnd, floatmp_check_t check) {
+  if ((check == floatmp_check_t::unchecked) ||
+      ((!x.is_negative() || y.is_integer()) &&
+       (!x.is_zero() || y.is_positive())))
+    mpfr_pow(value_, x.c_mpfr(), y.c_mpfr(), rnd);
+  else
+    domain_error_("invalid arg of pow()", check);
 }
 
-void floatmp_base::sqrt(const floatmp_base &x) {
-  if (x.is_negative())
-    throw std::domain_error("invalid arg of sqrt()");
-  mpfr_sqrt(value_, x.c_mpfr(), mpfr_rnd_());
+void floatmp_base::sqrt(const floatmp_base &x, mpfr_rnd_t rnd,
+                        floatmp_check_t check) {
+  if ((check == floatmp_check_t::unchecked) || !x.is_negative())
+    mpfr_sqrt(value_, x.c_mpfr(), rnd);
+  else
+    domain_error_("invalid arg of sqrt()", check);
 }
 
-void floatmp_base::asin(const floatmp_base &x) {
-  if (x.less_than(minus_one_) || plus_one_.less_than(x))
-    throw std::domain_error("invalid arg of asin()");
-  mpfr_asin(value_, x.c_mpfr(), mpfr_rnd_());
+void floatmp_base::asin(const floatmp_base &x, mpfr_rnd_t rnd,
+                        floatmp_check_t check) {
+  if ((check == floatmp_check_t::unchecked) ||
+      ((mpfr_cmp_si(x.c_mpfr(), -1) >= 0) && (mpfr_cmp_ui(x.c_mpfr(), 1) <= 0)))
+    mpfr_asin(value_, x.c_mpfr(), rnd);
+  else
+    domain_error_("invalid arg of asin()", check);
 }
 
-void floatmp_base::acos(const floatmp_base &x) {
-  if (x.less_than(minus_one_) || plus_one_.less_than(x))
-    throw std::domain_error("invalid arg of asin()");
-  mpfr_acos(value_, x.c_mpfr(), mpfr_rnd_());
+void floatmp_base::acos(const floatmp_base &x, mpfr_rnd_t rnd,
+                        floatmp_check_t check) {
+  if ((check == floatmp_check_t::unchecked) ||
+      ((mpfr_cmp_si(x.c_mpfr(), -1) >= 0) && (mpfr_cmp_ui(x.c_mpfr(), 1) <= 0)))
+    mpfr_acos(value_, x.c_mpfr(), rnd);
+  else
+    domain_error_("invalid arg of acos()", check);
 }
 
-void floatmp_base::acosh(const floatmp_base &x) {
-  if (x.less_than(plus_one_))
-    throw std::domain_error("invalid arg of acosh()");
-  mpfr_acosh(value_, x.c_mpfr(), mpfr_rnd_());
+void floatmp_base::acosh(const floatmp_base &x, mpfr_rnd_t rnd,
+                         floatmp_check_t check) {
+  if ((check == floatmp_check_t::unchecked) ||
+      (mpfr_cmp_ui(x.c_mpfr(), 1) >= 0))
+    mpfr_acosh(value_, x.c_mpfr(), rnd);
+  else
+    domain_error_("invalid arg of acosh()", check);
 }
 
-void floatmp_base::atanh(const floatmp_base &x) {
-  if (!(minus_one_.less_than(x) && x.less_than(plus_one_)))
-    throw std::domain_error("invalid arg of atanh()");
-  mpfr_atanh(value_, x.c_mpfr(), mpfr_rnd_());
+void floatmp_base::atanh(const floatmp_base &x, mpfr_rnd_t rnd,
+                         floatmp_check_t check) {
+  if ((check == floatmp_check_t::unchecked) ||
+      ((mpfr_cmp_si(x.c_mpfr(), -1) > 0) && (mpfr_cmp_ui(x.c_mpfr(), 1) < 0)))
+    mpfr_atanh(value_, x.c_mpfr(), rnd);
+  else
+    domain_error_("invalid arg of atanh()", check);
 }
 
-void floatmp_base::tgamma(const floatmp_base &x) {
-  if (x.is_zero())
-    throw std::domain_error("invalid arg of tgamma()");
-  if (x.is_integer() && x.is_negative())
-    throw std::domain_error("invalid arg of tgamma()");
-  mpfr_gamma(value_, x.c_mpfr(), mpfr_rnd_());
+void floatmp_base::tgamma(const floatmp_base &x, mpfr_rnd_t rnd,
+                          floatmp_check_t check) {
+  if ((check == floatmp_check_t::unchecked) ||
+      (!x.is_zero() && (!x.is_integer() || !x.is_negative())))
+    mpfr_gamma(value_, x.c_mpfr(), rnd);
+  else
+    domain_error_("invalid arg of tgamma()", check);
 }
 
-void floatmp_base::lgamma(const floatmp_base &x) {
-  if (x.is_zero())
-    throw std::domain_error("invalid arg of tgamma()");
-  if (x.is_integer() && x.is_negative())
-    throw std::domain_error("invalid arg of tgamma()");
-  mpfr_lngamma(value_, x.c_mpfr(), mpfr_rnd_());
+void floatmp_base::lgamma(const floatmp_base &x, mpfr_rnd_t rnd,
+                          floatmp_check_t check) {
+  if ((check == floatmp_check_t::unchecked) ||
+      (!x.is_zero() && (!x.is_integer() || !x.is_negative())))
+    mpfr_lngamma(value_, x.c_mpfr(), rnd);
+  else
+    domain_error_("invalid arg of lgamma()", check);
 }
 
-void floatmp_base::nextafter(const floatmp_base &x, const floatmp_base &y) {
-  if (!x.is_finite())
-    throw std::domain_error("invalid arg of nextafter()");
-  mpfr_set(value_, x.c_mpfr(), mpfr_rnd_());
-  mpfr_nexttoward(value_, y.c_mpfr());
+void floatmp_base::nextafter(const floatmp_base &x, const floatmp_base &y,
+                             mpfr_rnd_t rnd, floatmp_check_t check) {
+  if ((check == floatmp_check_t::unchecked) || x.is_finite()) {
+    mpfr_set(value_, x.c_mpfr(), rnd);
+    mpfr_nexttoward(value_, y.c_mpfr());
+  } else
+    domain_error_("invalid arg of nextafter()", check);
 }
 
-void floatmp_base::nextabove(const floatmp_base &x) {
-  if (!x.is_finite())
-    throw std::domain_error("invalid arg of nextabove()");
-  mpfr_set(value_, x.c_mpfr(), mpfr_rnd_());
-  mpfr_nextabove(value_);
+void floatmp_base::nextabove(const floatmp_base &x, mpfr_rnd_t rnd,
+                             floatmp_check_t check) {
+  if ((check == floatmp_check_t::unchecked) || x.is_finite()) {
+    mpfr_set(value_, x.c_mpfr(), rnd);
+    mpfr_nextabove(value_);
+  } else
+    domain_error_("invalid arg of nextabove()", check);
 }
 
-void floatmp_base::nextbelow(const floatmp_base &x) {
-  if (!x.is_finite())
-    throw std::domain_error("invalid arg of nextbelow()");
-  mpfr_set(value_, x.c_mpfr(), mpfr_rnd_());
-  mpfr_nextbelow(value_);
+void floatmp_base::nextbelow(const floatmp_base &x, mpfr_rnd_t rnd,
+                             floatmp_check_t check) {
+  if ((check == floatmp_check_t::unchecked) || x.is_finite()) {
+    mpfr_set(value_, x.c_mpfr(), rnd);
+    mpfr_nextbelow(value_);
+  } else
+    domain_error_("invalid arg of nextbelow()", check);
 }
@@ -0,0 +1,261 @@
+/*
+  This file is part of the Teuthid project.
+  Copyright (c) 2016-2017 Mariusz Przygodzki (mariusz.przygodzki@gmail.com)
+
+  The Teuthid is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or (at your
+  option) any later version.
+
+  The Teuthid is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+  FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+  for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with the Teuthid; see the file LICENSE.LGPLv3.  If not, see
+  <http://www.gnu.org/licenses/>.
+*/
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <stdexcept>
+
+#include <mpfr.h>
+#include <teuthid/floatmp_arena.hpp>
+
+using namespace teuthid;
+
+namespace {
+// a block of the arena; the memory of the block follows its header
+struct __arena_block {
+  __arena_block *next;
+  std::size_t size;
+  std::size_t used;
+  unsigned char *data() noexcept {
+    return reinterpret_cast<unsigned char *>(this) + header_size;
+  }
+  static constexpr std::size_t alignment = alignof(std::max_align_t);
+  static constexpr std::size_t header_size =
+      (sizeof(__arena_block *) + 2 * sizeof(std::size_t) + alignment - 1) /
+      alignment * alignment;
+};
+
+// the arena of one thread (trivially destructible, so the memory functions
+// may still use it while other thread-local objects are destroyed)
+struct __arena_state {
+  __arena_block *first;
+  __arena_block *current;
+};
+
+thread_local __arena_state __arena = {nullptr, nullptr};
+
+// frees the blocks of the arena when the thread exits
+struct __arena_reaper {
+  bool armed = false;
+  ~__arena_reaper();
+};
+
+thread_local __arena_reaper __reaper;
+
+std::mutex __install_mutex;
+std::atomic<bool> __installed(false);
+std::atomic<std::size_t> __block_size(floatmp_arena::default_block_size);
+std::atomic<int> __active_scopes(0);
+void *(*__heap_alloc)(std::size_t) = nullptr;
+void *(*__heap_realloc)(void *, std::size_t, std::size_t) = nullptr;
+void (*__heap_free)(void *, std::size_t) = nullptr;
+
+std::size_t __aligned(std::size_t size) noexcept {
+  return (size + __arena_block::alignment - 1) / __arena_block::alignment *
+         __arena_block::alignment;
+}
+
+void __free_blocks() noexcept {
+  __arena_block *__b = __arena.first;
+  while (__b) {
+    __arena_block *__next = __b->next;
+    std::free(__b);
+    __b = __next;
+  }
+  __arena.first = __arena.current = nullptr;
+}
+
+__arena_reaper::~__arena_reaper() { __free_blocks(); }
+
+bool __owns(const void *ptr) noexcept {
+  const unsigned char *__p = static_cast<const unsigned char *>(ptr);
+  for (__arena_block *__b = __arena.first; __b; __b = __b->next)
+    if ((__p >= __b->data()) && (__p < __b->data() + __b->size))
+      return true;
+  return false;
+}
+
+// the block inserted after the given one (or the first block)
+__arena_block *__new_block(__arena_block *prev, std::size_t size) {
+  size = std::max(size, __block_size.load(std::memory_order_relaxed));
+  __arena_block *__b = static_cast<__arena_block *>(
+      std::malloc(__arena_block::header_size + size));
+  if (!__b)
+    throw std::bad_alloc();
+  __b->size = size;
+  __b->used = 0;
+  if (prev) {
+    __b->next = prev->next;
+    prev->next = __b;
+  } else {
+    __b->next = __arena.first;
+    __arena.first = __b;
+  }
+  __reaper.armed = true;
+  return __b;
+}
+
+void *__bump(std::size_t size) {
+  size = __aligned(size);
+  __arena_block *__b = __arena.current;
+  if (!__b)
+    __b = __arena.first ? __arena.first : __new_block(nullptr, size);
+  if (__b->size - __b->used < size) {
+    // the blocks after the current one are unused
+    if (__b->next && (__b->next->size >= size))
+      __b = __b->next;
+    else
+      __b = __new_block(__b, size);
+  }
+  __arena.current = __b;
+  void *__p = __b->data() + __b->used;
+  __b->used += size;
+  return __p;
+}
+
+// the last allocation of the current block is given back at once
+bool __pop(void *ptr, std::size_t size) noexcept {
+  __arena_block *__b = __arena.current;
+  size = __aligned(size);
+  if (__b && (static_cast<unsigned char *>(ptr) + size ==
+              __b->data() + __b->used)) {
+    __b->used -= size;
+    return true;
+  }
+  return false;
+}
+} // namespace
+
+constexpr std::size_t floatmp_arena::default_block_size;
+thread_local int floatmp_arena::scopes_ = 0;
+thread_local int floatmp_arena::suspended_ = 0;
+
+floatmp_arena::scope::scope() {
+  if (!floatmp_arena::is_installed())
+    throw std::logic_error("floatmp_arena is not installed");
+  block_ = __arena.current;
+  used_ = __arena.current ? __arena.current->used : 0;
+  ++floatmp_arena::scopes_;
+  __active_scopes.fetch_add(1, std::memory_order_relaxed);
+}
+
+floatmp_arena::scope::~scope() {
+  --floatmp_arena::scopes_;
+  // the caches of MPFR may hold the memory rewound below, also for the
+  // inner scopes
+  mpfr_free_cache2(MPFR_FREE_LOCAL_CACHE);
+  // the blocks after the current one are unused
+  __arena_block *__b = static_cast<__arena_block *>(block_);
+  if (__b)
+    __b->used = used_;
+  for (__b = (__b ? __b->next : __arena.first); __b && (__b->used != 0);
+       __b = __b->next)
+    __b->used = 0;
+  __arena.current = static_cast<__arena_block *>(block_);
+  __active_scopes.fetch_sub(1, std::memory_order_relaxed);
+}
+
+void floatmp_arena::install(std::size_t block_size) {
+  std::lock_guard<std::mutex> __lock(__install_mutex);
+  __block_size.store(std::max<std::size_t>(block_size, 1),
+                     std::memory_order_relaxed);
+  if (__installed.load(std::memory_order_relaxed))
+    return;
+  mpfr_mp_memory_cleanup();
+  mp_get_memory_functions(&__heap_alloc, &__heap_realloc, &__heap_free);
+  mp_set_memory_functions(floatmp_arena::alloc_, floatmp_arena::realloc_,
+                          floatmp_arena::free_);
+  __installed.store(true, std::memory_order_release);
+}
+
+void floatmp_arena::uninstall() {
+  std::lock_guard<std::mutex> __lock(__install_mutex);
+  if (!__installed.load(std::memory_order_relaxed))
+    return;
+  if (__active_scopes.load(std::memory_order_relaxed) != 0)
+    throw std::logic_error("floatmp_arena is in use");
+  mpfr_mp_memory_cleanup();
+  mp_set_memory_functions(__heap_alloc, __heap_realloc, __heap_free);
+  __installed.store(false, std::memory_order_release);
+  __free_blocks();
+}
+
+bool floatmp_arena::is_installed() noexcept {
+  return __installed.load(std::memory_order_acquire);
+}
+
+bool floatmp_arena::is_active() noexcept {
+  return (scopes_ > 0) && (suspended_ == 0);
+}
+
+std::size_t floatmp_arena::bytes_in_use() noexcept {
+  std::size_t __bytes = 0;
+  for (__arena_block *__b = __arena.first; __b; __b = __b->next)
+    __bytes += __b->used;
+  return __bytes;
+}
+
+std::size_t floatmp_arena::bytes_reserved() noexcept {
+  std::size_t __bytes = 0;
+  for (__arena_block *__b = __arena.first; __b; __b = __b->next)
+    __bytes += __b->size;
+  return __bytes;
+}
+
+void floatmp_arena::release() {
+  if (scopes_ > 0)
+    throw std::logic_error("floatmp_arena is in use");
+  __free_blocks();
+}
+
+void *floatmp_arena::alloc_(std::size_t size) {
+  if (is_active())
+    return __bump(size);
+  return __heap_alloc(size);
+}
+
+void *floatmp_arena::realloc_(void *ptr, std::size_t old_size,
+                              std::size_t new_size) {
+  if (!__owns(ptr))
+    return __heap_realloc(ptr, old_size, new_size);
+  // the last allocation grows or shrinks in place
+  __arena_block *__b = __arena.current;
+  if (__pop(ptr, old_size)) {
+    if (__b->size - __b->used >= __aligned(new_size)) {
+      __b->used += __aligned(new_size);
+      return ptr;
+    }
+    __b->used += __aligned(old_size);
+  }
+  void *__p = alloc_(new_size);
+  std::memcpy(__p, ptr, std::min(old_size, new_size));
+  free_(ptr, old_size);
+  return __p;
+}
+
+void floatmp_arena::free_(void *ptr, std::size_t size) {
+  if (__owns(ptr))
+    __pop(ptr, size);
+  else
+    __heap_free(ptr, size);
+}
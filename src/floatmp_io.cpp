@@ -0,0 +1,158 @@
+/*
+  This file is part of the Teuthid project.
+  Copyright (c) 2016-2017 Mariusz Przygodzki (mariusz.przygodzki@gmail.com)
+
+  The Teuthid is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or (at your
+  option) any later version.
+
+  The Teuthid is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+  FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+  for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with the Teuthid; see the file LICENSE.LGPLv3.  If not, see
+  <http://www.gnu.org/licenses/>.
+*/
+
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+#include <teuthid/floatmp_io.hpp>
+
+using namespace teuthid;
+
+namespace {
+// the header is {magic, version, byte order, limb bits, 0, precision, count}
+const char __magic[8] = {'T', 'E', 'U', 'T', 'H', 'I', 'D', 'F'};
+constexpr std::uint32_t __version = 1;
+constexpr std::uint32_t __byte_order = 0x01020304;
+
+template <typename T> void __put(unsigned char *data, T value) noexcept {
+  std::memcpy(data, &value, sizeof(T));
+}
+
+template <typename T> T __get(const unsigned char *data) noexcept {
+  T __value;
+  std::memcpy(&__value, data, sizeof(T));
+  return __value;
+}
+
+[[noreturn]] void __invalid_data() {
+  throw std::runtime_error("invalid floatmp binary data");
+}
+} // namespace
+
+constexpr std::size_t floatmp_io::header_size;
+constexpr std::size_t floatmp_io::record_head_size_;
+constexpr std::size_t floatmp_io::chunk_size_;
+
+void floatmp_io::write_header_(std::ostream &os, std::size_t precision,
+                               std::size_t count) {
+  unsigned char __header[header_size] = {};
+  std::memcpy(__header, __magic, sizeof(__magic));
+  __put<std::uint32_t>(__header + 8, __version);
+  __put<std::uint32_t>(__header + 12, __byte_order);
+  __put<std::uint32_t>(__header + 16, GMP_NUMB_BITS);
+  __put<std::uint64_t>(__header + 24, precision);
+  __put<std::uint64_t>(__header + 32, count);
+  write_(os, __header, header_size);
+}
+
+void floatmp_io::read_header_(std::istream &is, std::size_t &precision,
+                              std::size_t &count) {
+  unsigned char __header[header_size];
+  read_(is, __header, header_size);
+  check_header_(__header, precision, count);
+}
+
+void floatmp_io::check_header_(const unsigned char *data,
+                               std::size_t &precision, std::size_t &count) {
+  if ((std::memcmp(data, __magic, sizeof(__magic)) != 0) ||
+      (__get<std::uint32_t>(data + 8) != __version) ||
+      (__get<std::uint32_t>(data + 12) != __byte_order) ||
+      (__get<std::uint32_t>(data + 16) != GMP_NUMB_BITS))
+    __invalid_data();
+  std::uint64_t __precision = __get<std::uint64_t>(data + 24);
+  std::uint64_t __count = __get<std::uint64_t>(data + 32);
+  if ((__precision < MPFR_PREC_MIN) ||
+      (__precision > TEUTHID_FLOATMP_MAX_PRECISION) ||
+      (__count > std::numeric_limits<std::size_t>::max() /
+                     record_size(__precision)))
+    __invalid_data();
+  precision = __precision;
+  count = __count;
+}
+
+void floatmp_io::encode_(unsigned char *record, mpfr_srcptr x) {
+  std::size_t __bytes = floatmp_limbs(mpfr_get_prec(x)) * sizeof(mp_limb_t);
+  int __kind = mpfr_custom_get_kind(x);
+  std::int64_t __exp = 0;
+  if (mpfr_regular_p(x)) {
+    __exp = mpfr_custom_get_exp(x);
+    std::memcpy(record + record_head_size_, mpfr_custom_get_significand(x),
+                __bytes);
+  } else
+    std::memset(record + record_head_size_, 0, __bytes);
+  __put<std::int64_t>(record, __exp);
+  __put<std::int32_t>(record + 8, __kind);
+  __put<std::uint32_t>(record + 12, 0);
+}
+
+void floatmp_io::decode_(const unsigned char *record, std::size_t precision,
+                         mpfr_ptr x) {
+  std::int64_t __exp = __get<std::int64_t>(record);
+  int __kind = __get<std::int32_t>(record + 8);
+  mp_limb_t *__limbs = reinterpret_cast<mp_limb_t *>(
+      const_cast<unsigned char *>(record + record_head_size_));
+  switch (__kind < 0 ? -__kind : __kind) {
+  case MPFR_REGULAR_KIND: {
+    // the significand must be normalized and rounded to the precision
+    std::size_t __n = floatmp_limbs(precision);
+    if ((__exp < mpfr_get_emin()) || (__exp > mpfr_get_emax()) ||
+        ((__limbs[__n - 1] >> (GMP_NUMB_BITS - 1)) == 0) ||
+        ((__limbs[0] & ((mp_limb_t(1) << (__n * GMP_NUMB_BITS - precision)) -
+                        1)) != 0))
+      __invalid_data();
+    break;
+  }
+  case MPFR_NAN_KIND:
+  case MPFR_INF_KIND:
+  case MPFR_ZERO_KIND:
+    __exp = 0;
+    break;
+  default:
+    __invalid_data();
+  }
+  mpfr_custom_init_set(x, __kind, __exp, precision, __limbs);
+}
+
+void floatmp_io::write_(std::ostream &os, const unsigned char *data,
+                        std::size_t size) {
+  if (!os.write(reinterpret_cast<const char *>(data), size))
+    throw std::runtime_error("cannot write floatmp binary data");
+}
+
+void floatmp_io::read_(std::istream &is, unsigned char *data,
+                       std::size_t size) {
+  if (!is.read(reinterpret_cast<char *>(data), size))
+    throw std::runtime_error("cannot read floatmp binary data");
+}
+
+floatmp_mapping::floatmp_mapping(const std::string &path)
+    : precision_(0), count_(0), record_size_(0), records_(nullptr),
+      file_(path) {
+  if (file_.size() < floatmp_io::header_size)
+    __invalid_data();
+  const unsigned char *__data =
+      reinterpret_cast<const unsigned char *>(file_.data());
+  floatmp_io::check_header_(__data, precision_, count_);
+  record_size_ = floatmp_io::record_size(precision_);
+  if ((file_.size() - floatmp_io::header_size) / record_size_ < count_)
+    __invalid_data();
+  records_ = __data + floatmp_io::header_size;
+}
@@ -0,0 +1,217 @@
+/*
+  This file is part of the Teuthid project.
+  Copyright (c) 2016-2017 Mariusz Przygodzki (mariusz.przygodzki@gmail.com)
+
+  The Teuthid is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or (at your
+  option) any later version.
+
+  The Teuthid is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+  FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+  for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with the Teuthid; see the file LICENSE.LGPLv3.  If not, see
+  <http://www.gnu.org/licenses/>.
+*/
+
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <thread>
+
+#include <teuthid/host_topology.hpp>
+
+using namespace teuthid;
+
+namespace {
+// the first line of a file; false if the file cannot be read
+bool __read_line(const std::string &path, std::string &line) {
+  std::ifstream __file(path);
+  return static_cast<bool>(std::getline(__file, line));
+}
+
+bool __read_number(const std::string &path, std::size_t &x) {
+  std::string __line;
+  if (!__read_line(path, __line))
+    return false;
+  std::istringstream __ss(__line);
+  return static_cast<bool>(__ss >> x);
+}
+
+// a list like "0-3,8,10-11"; empty if it is invalid
+std::vector<unsigned> __parse_cpu_list(const std::string &s) {
+  std::vector<unsigned> __cpus;
+  std::istringstream __ss(s);
+  std::string __range;
+  while (std::getline(__ss, __range, ',')) {
+    unsigned __first, __last;
+    char __dash;
+    std::istringstream __rs(__range);
+    if (!(__rs >> __first))
+      return {};
+    __last = __first;
+    if ((__rs >> __dash) && ((__dash != '-') || !(__rs >> __last)))
+      return {};
+    for (unsigned __i = __first; __i <= __last; ++__i)
+      __cpus.push_back(__i);
+  }
+  return __cpus;
+}
+
+bool __read_cpu_list(const std::string &path, std::vector<unsigned> &cpus) {
+  std::string __line;
+  if (!__read_line(path, __line))
+    return false;
+  cpus = __parse_cpu_list(__line);
+  return !cpus.empty();
+}
+
+// a size like "32K" or "1M"
+std::size_t __parse_size(const std::string &s) {
+  std::istringstream __ss(s);
+  std::size_t __size = 0;
+  char __unit = 0;
+  __ss >> __size >> __unit;
+  switch (std::toupper(__unit)) {
+  case 'K':
+    return __size << 10;
+  case 'M':
+    return __size << 20;
+  case 'G':
+    return __size << 30;
+  default:
+    return __size;
+  }
+}
+} // namespace
+
+host_topology::host_topology(const std::string &root)
+    : cores_(0), packages_(0) {
+  read_cpus_(root);
+  if (cpus_.empty()) {
+    assume_flat_();
+    return;
+  }
+  read_caches_(root);
+  read_nodes_(root);
+}
+
+std::size_t host_topology::cache_size(unsigned level) const noexcept {
+  if (cpus_.empty())
+    return 0;
+  for (const cache &__c : caches_)
+    if ((__c.level == level) && (__c.type != cpu_cache_t::instruction) &&
+        (std::find(__c.cpus.begin(), __c.cpus.end(), cpus_[0].id) !=
+         __c.cpus.end()))
+      return __c.size;
+  return 0;
+}
+
+std::size_t host_topology::cache_line_size() const noexcept {
+  for (const cache &__c : caches_)
+    if ((__c.level == 1) && (__c.type != cpu_cache_t::instruction))
+      return __c.line_size;
+  return 0;
+}
+
+void host_topology::read_cpus_(const std::string &root) {
+  std::vector<unsigned> __online;
+  if (!__read_cpu_list(root + "/cpu/online", __online))
+    return;
+  // the physical cores are the distinct sets of SMT siblings
+  std::map<std::string, unsigned> __cores;
+  std::vector<std::size_t> __packages;
+  for (unsigned __id : __online) {
+    std::string __dir = root + "/cpu/cpu" + std::to_string(__id) + "/topology";
+    std::string __siblings;
+    if (!__read_line(__dir + "/thread_siblings_list", __siblings))
+      __siblings = std::to_string(__id);
+    std::size_t __package = 0;
+    __read_number(__dir + "/physical_package_id", __package);
+    auto __core = __cores.emplace(__siblings, __cores.size()).first;
+    if (std::find(__packages.begin(), __packages.end(), __package) ==
+        __packages.end())
+      __packages.push_back(__package);
+    cpus_.push_back({__id, __core->second, static_cast<unsigned>(__package),
+                     0});
+  }
+  cores_ = __cores.size();
+  packages_ = __packages.size();
+}
+
+void host_topology::read_caches_(const std::string &root) {
+  for (const logical_cpu &__cpu : cpus_)
+    for (unsigned __index = 0;; ++__index) {
+      std::string __dir = root + "/cpu/cpu" + std::to_string(__cpu.id) +
+                          "/cache/index" + std::to_string(__index);
+      std::size_t __level, __line_size = 0, __ways = 0;
+      std::string __type, __size, __shared;
+      if (!__read_number(__dir + "/level", __level) ||
+          !__read_line(__dir + "/type", __type))
+        break;
+      __read_line(__dir + "/size", __size);
+      __read_number(__dir + "/coherency_line_size", __line_size);
+      __read_number(__dir + "/ways_of_associativity", __ways);
+      cache __c = {static_cast<unsigned>(__level), cpu_cache_t::unified,
+                   __parse_size(__size), __line_size,
+                   static_cast<unsigned>(__ways), {}};
+      if (__type == "Data")
+        __c.type = cpu_cache_t::data;
+      else if (__type == "Instruction")
+        __c.type = cpu_cache_t::instruction;
+      if (!__read_cpu_list(__dir + "/shared_cpu_list", __c.cpus))
+        __c.cpus.assign(1, __cpu.id);
+      // a shared cache is listed once
+      if (std::none_of(caches_.begin(), caches_.end(), [&__c](const cache &c) {
+            return (c.level == __c.level) && (c.type == __c.type) &&
+                   (c.cpus == __c.cpus);
+          }))
+        caches_.push_back(std::move(__c));
+    }
+}
+
+void host_topology::read_nodes_(const std::string &root) {
+  std::vector<unsigned> __online;
+  if (__read_cpu_list(root + "/node/online", __online))
+    for (unsigned __id : __online) {
+      std::string __dir = root + "/node/node" + std::to_string(__id);
+      numa_node __node = {__id, 0, {}};
+      __read_cpu_list(__dir + "/cpulist", __node.cpus);
+      // "Node 0 MemTotal:       16314540 kB"
+      std::ifstream __meminfo(__dir + "/meminfo");
+      for (std::string __line; std::getline(__meminfo, __line);) {
+        std::size_t __pos = __line.find("MemTotal:");
+        if (__pos != std::string::npos) {
+          __node.memory = __parse_size(__line.substr(__pos + 9));
+          break;
+        }
+      }
+      nodes_.push_back(std::move(__node));
+    }
+  if (nodes_.empty()) { // a system without NUMA
+    nodes_.push_back({0, 0, {}});
+    for (const logical_cpu &__cpu : cpus_)
+      nodes_[0].cpus.push_back(__cpu.id);
+  }
+  for (logical_cpu &__cpu : cpus_)
+    for (std::size_t __i = 0; __i < nodes_.size(); ++__i)
+      if (std::find(nodes_[__i].cpus.begin(), nodes_[__i].cpus.end(),
+                    __cpu.id) != nodes_[__i].cpus.end())
+        __cpu.node = static_cast<unsigned>(__i);
+}
+
+void host_topology::assume_flat_() {
+  unsigned __n = std::max(std::thread::hardware_concurrency(), 1u);
+  nodes_.push_back({0, 0, {}});
+  for (unsigned __i = 0; __i < __n; ++__i) {
+    cpus_.push_back({__i, __i, 0, 0});
+    nodes_[0].cpus.push_back(__i);
+  }
+  cores_ = __n;
+  packages_ = 1;
+}
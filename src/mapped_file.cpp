@@ -0,0 +1,80 @@
+/*
+  This file is part of the Teuthid project.
+  Copyright (c) 2016-2017 Mariusz Przygodzki (mariusz.przygodzki@gmail.com)
+
+  The Teuthid is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or (at your
+  option) any later version.
+
+  The Teuthid is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+  FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+  for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with the Teuthid; see the file LICENSE.LGPLv3.  If not, see
+  <http://www.gnu.org/licenses/>.
+*/
+
+#include <fstream>
+#include <new>
+#include <stdexcept>
+
+#include <teuthid/mapped_file.hpp>
+
+#if defined(TEUTHID_HAVE_MMAP)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif // TEUTHID_HAVE_MMAP
+
+using namespace teuthid;
+
+mapped_file::mapped_file(const std::string &path)
+    : data_(nullptr), size_(0), mapped_(false) {
+#if defined(TEUTHID_HAVE_MMAP)
+  int __fd = ::open(path.c_str(), O_RDONLY);
+  if (__fd < 0)
+    throw std::runtime_error("cannot open file: " + path);
+  struct stat __st;
+  if (::fstat(__fd, &__st) != 0) {
+    ::close(__fd);
+    throw std::runtime_error("cannot open file: " + path);
+  }
+  size_ = __st.st_size;
+  if (size_ > 0) {
+    data_ = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, __fd, 0);
+    mapped_ = (data_ != MAP_FAILED);
+    if (!mapped_)
+      data_ = nullptr;
+  }
+  ::close(__fd);
+  if ((size_ > 0) && !mapped_)
+    throw std::runtime_error("cannot map file: " + path);
+#else
+  std::ifstream __file(path, std::ios::binary | std::ios::ate);
+  if (!__file)
+    throw std::runtime_error("cannot open file: " + path);
+  size_ = __file.tellg();
+  __file.seekg(0);
+  // aligned like the memory of mmap() (for the limbs of floatmp_io)
+  data_ = ::operator new(size_ ? size_ : 1);
+  if (!__file.read(static_cast<char *>(data_), size_)) {
+    release_();
+    throw std::runtime_error("cannot read file: " + path);
+  }
+#endif // TEUTHID_HAVE_MMAP
+}
+
+void mapped_file::release_() noexcept {
+#if defined(TEUTHID_HAVE_MMAP)
+  if (mapped_)
+    ::munmap(data_, size_);
+#else
+  ::operator delete(data_);
+#endif // TEUTHID_HAVE_MMAP
+  data_ = nullptr;
+  mapped_ = false;
+}
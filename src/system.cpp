@@ -20,11 +20,26 @@
 #include <algorithm>
 #include <cassert>
 #include <cctype>
+#include <cerrno>
+#include <cfloat>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <initializer_list>
+#include <limits>
+#include <mutex>
 #include <sstream>
 #include <stdexcept>
+#include <thread>
+#include <type_traits>
 
 #include <teuthid/system.hpp>
 
+#ifdef TEUTHID_HAVE_CPUID
+#include <cpuid.h>
+#endif
+
 #if defined(TEUTHID_WITH_OPENCL)
 #include <teuthid/clb/error.hpp>
 #include <teuthid/clb/platform.hpp>
@@ -33,101 +48,343 @@
 using namespace teuthid;
 
 #if defined(TEUTHID_WITH_OPENCL)
-std::atomic_bool system::clb_(system::has_cl_backend());
+std::atomic_bool system::clb_(true);
 #else
 std::atomic_bool system::clb_(false);
 #endif
 
 std::string system::version_ = std::string(TEUTHID_VERSION);
-std::atomic<std::streamsize>
-    system::format_float_precision_(system::default_format_float_precision_);
-std::atomic_bool system::format_float_scientific_(false);
+thread_local system::float_format system::float_format_ = {
+    system::default_format_float_precision_, false};
 
 bool system::check_version(uint8_t major, uint8_t minor) noexcept {
   return (TEUTHID_MAJOR_VERSION > major ||
           (TEUTHID_MAJOR_VERSION == major && TEUTHID_MINOR_VERSION >= minor));
 }
 
-bool system::has_cl_backend() {
 #if defined(TEUTHID_WITH_OPENCL)
-  try {
-    for (auto __platform : clb::platform::get_all())
-      if (__platform.device_count() > 0)
-        return true;
-  } catch (const clb::error &) {
-    // some problems with the compute kernel - it wil be disabled
+namespace {
+// the OpenCL platforms and devices are detected once, at the first use
+enum : int { __clb_unknown, __clb_probing, __clb_found, __clb_missing };
+std::atomic_int __clb_state(__clb_unknown);
+std::once_flag __clb_once;
+
+void __detect_cl_backend() {
+  std::call_once(__clb_once, []() {
+    bool __found = false;
+    try {
+      for (auto __platform : clb::platform::get_all())
+        if (__platform.device_count() > 0) {
+          __found = true;
+          break;
+        }
+    } catch (const clb::error &) {
+      // some problems with the compute kernel - it wil be disabled
+    }
+    __clb_state.store(__found ? __clb_found : __clb_missing);
+  });
+}
+
+// runs the detection on a background thread; the thread is joined at exit
+// before the platforms are destroyed
+class __clb_prober {
+public:
+  ~__clb_prober() {
+    if (thread_.joinable())
+      thread_.join();
+  }
+  static void start() {
+    static __clb_prober __prober;
+    int __unknown = __clb_unknown;
+    std::lock_guard<std::mutex> __lock(__prober.mutex_);
+    if (__clb_state.compare_exchange_strong(__unknown, __clb_probing))
+      __prober.thread_ = std::thread(__detect_cl_backend);
   }
+
+private:
+  std::mutex mutex_;
+  std::thread thread_;
+};
+} // namespace
+#endif // TEUTHID_WITH_OPENCL
+
+bool system::has_cl_backend() {
+#if defined(TEUTHID_WITH_OPENCL)
+  __detect_cl_backend(); // waits for a detection in progress
+  return (__clb_state.load() == __clb_found);
+#else
+  return false;
+#endif // TEUTHID_WITH_OPENCL
+}
+
+void system::probe_cl_backend() noexcept {
+#if defined(TEUTHID_WITH_OPENCL)
+  if (__clb_state.load() == __clb_unknown)
+    try {
+      __clb_prober::start();
+    } catch (const std::system_error &) {
+      // no thread - the backend will be detected by has_cl_backend()
+    }
 #endif // TEUTHID_WITH_OPENCL
+}
+
+bool system::uses_cl_backend() noexcept {
+#if defined(TEUTHID_WITH_OPENCL)
+  system::probe_cl_backend();
+  return (__clb_state.load() == __clb_found) && system::clb_.load();
+#else
   return false;
+#endif // TEUTHID_WITH_OPENCL
 }
 
 bool system::uses_cl_backend(bool enabled) {
   if (system::has_cl_backend())
     system::clb_.store(enabled);
-  return system::clb_.load();
+  return system::uses_cl_backend();
 }
 
-#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace {
+const char *const __cpu_feature_names[] = {
+    "sse4.2",   "avx",      "avx2",     "fma",      "f16c",
+    "avx512f",  "avx512dq", "avx512cd", "avx512bw", "avx512vl"};
+constexpr int __cpu_feature_count =
+    sizeof(__cpu_feature_names) / sizeof(__cpu_feature_names[0]);
 
-#ifdef TEUTHID_HAVE_INT_128
-std::string system::uint128_to_string_(uint128_t x) {
-  uint128_t __div, __value = x;
+inline unsigned __cpu_bit(cpu_feature_t feature) noexcept {
+  return 1u << static_cast<int>(feature);
+}
+
+// the features supported by both the CPU and the operating system (which must
+// save the AVX and AVX-512 registers)
+unsigned __detect_cpu_features() noexcept {
+  unsigned __features = 0;
+#ifdef TEUTHID_HAVE_CPUID
+  unsigned __eax, __ebx, __ecx, __edx;
+  if (!__get_cpuid(1, &__eax, &__ebx, &__ecx, &__edx))
+    return 0;
+  if (__ecx & bit_SSE4_2)
+    __features |= __cpu_bit(cpu_feature_t::sse4_2);
+  if (!(__ecx & bit_OSXSAVE))
+    return __features;
+  unsigned __xcr0, __xcr0_high;
+  __asm__("xgetbv" : "=a"(__xcr0), "=d"(__xcr0_high) : "c"(0));
+  bool __avx_state = ((__xcr0 & 0x06) == 0x06);       // XMM and YMM
+  bool __avx512_state = ((__xcr0 & 0xe6) == 0xe6);    // and opmask, ZMM
+  if (!__avx_state)
+    return __features;
+  if (__ecx & bit_AVX)
+    __features |= __cpu_bit(cpu_feature_t::avx);
+  if (__ecx & bit_FMA)
+    __features |= __cpu_bit(cpu_feature_t::fma);
+  if (__ecx & bit_F16C)
+    __features |= __cpu_bit(cpu_feature_t::f16c);
+  if (!__get_cpuid_count(7, 0, &__eax, &__ebx, &__ecx, &__edx))
+    return __features;
+  if (__ebx & bit_AVX2)
+    __features |= __cpu_bit(cpu_feature_t::avx2);
+  if (__avx512_state && (__ebx & bit_AVX512F)) {
+    __features |= __cpu_bit(cpu_feature_t::avx512f);
+    if (__ebx & bit_AVX512DQ)
+      __features |= __cpu_bit(cpu_feature_t::avx512dq);
+    if (__ebx & bit_AVX512CD)
+      __features |= __cpu_bit(cpu_feature_t::avx512cd);
+    if (__ebx & bit_AVX512BW)
+      __features |= __cpu_bit(cpu_feature_t::avx512bw);
+    if (__ebx & bit_AVX512VL)
+      __features |= __cpu_bit(cpu_feature_t::avx512vl);
+  }
+#endif // TEUTHID_HAVE_CPUID
+  return __features;
+}
+
+unsigned __cpu_features() noexcept {
+  static const unsigned __features = __detect_cpu_features();
+  return __features;
+}
+} // namespace
+
+bool system::has_cpu_feature(cpu_feature_t feature) noexcept {
+  return (__cpu_features() & __cpu_bit(feature)) != 0;
+}
+
+const host_topology &system::topology() {
+  static const host_topology __topology;
+  return __topology;
+}
+
+std::string system::cpu_features() {
   std::string __s;
-  do {
-    __div = __value / 10;
-    unsigned __mod = __value % 10;
-    __s += std::to_string(__mod);
-    __value = __div;
-  } while (__div > 0);
-  std::reverse(__s.begin(), __s.end());
+  for (int __i = 0; __i < __cpu_feature_count; ++__i)
+    if (system::has_cpu_feature(static_cast<cpu_feature_t>(__i))) {
+      if (!__s.empty())
+        __s += ' ';
+      __s += __cpu_feature_names[__i];
+    }
   return __s;
 }
 
-template <> std::string system::to_string(const int128_t &x) {
-  if ((x < INT64_MIN) || (x > INT64_MAX)) {
-    bool __minus = (x < 0);
-    uint128_t __value = (x >= 0) ? x : -x;
-    std::string __s = system::uint128_to_string_(__value);
-    __s = __minus ? ("-" + __s) : __s;
-    return __s;
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+
+namespace {
+// the decimal digits of the numbers 0..99
+const char __digit_pairs[] =
+    "000102030405060708091011121314151617181920212223242526272829"
+    "303132333435363738394041424344454647484950515253545556575859"
+    "606162636465666768697071727374757677787980818283848586878889"
+    "90919293949596979899";
+
+inline bool __is_digit(char c) noexcept { return (c >= '0') && (c <= '9'); }
+
+// writes the digits of x in front of p and returns the first of them
+char *__format_digits(char *p, uint64_t x) noexcept {
+  while (x >= 100) {
+    unsigned __i = static_cast<unsigned>(x % 100) * 2;
+    x /= 100;
+    p -= 2;
+    std::memcpy(p, __digit_pairs + __i, 2);
+  }
+  if (x >= 10) {
+    p -= 2;
+    std::memcpy(p, __digit_pairs + x * 2, 2);
   } else
-    return std::to_string(static_cast<long long>(x));
+    *--p = static_cast<char>('0' + x);
+  return p;
+}
+
+#ifdef TEUTHID_HAVE_INT_128
+// the 128-bit values are converted in blocks of 19 digits, the most that
+// always fit into 64 bits
+constexpr std::size_t __block_digits = 19;
+constexpr uint64_t __block_base = 10000000000000000000ULL;
+
+char *__format_digits(char *p, uint128_t x) noexcept {
+  while (x > UINT64_MAX) {
+    uint64_t __block = static_cast<uint64_t>(x % __block_base);
+    x /= __block_base;
+    char *__q = __format_digits(p, __block);
+    p -= __block_digits;
+    std::memset(p, '0', __q - p);
+  }
+  return __format_digits(p, static_cast<uint64_t>(x));
+}
+
+// parses the digits from first into x and returns their end; overflow is set
+// if the value exceeds max (x is then undefined)
+const char *__parse_digits(const char *first, const char *last, uint128_t max,
+                           uint128_t &x, bool &overflow) noexcept {
+  uint128_t __value = 0;
+  overflow = false;
+  for (;;) {
+    const char *__p = first, *__end = last;
+    if (static_cast<std::size_t>(last - first) > __block_digits)
+      __end = first + __block_digits;
+    uint64_t __block = 0, __scale = 1;
+    for (; (__p != __end) && __is_digit(*__p); ++__p) {
+      __block = __block * 10 + static_cast<unsigned>(*__p - '0');
+      __scale *= 10;
+    }
+    if (__p == first)
+      break;
+    if (overflow || (__value > (max - __block) / __scale))
+      overflow = true;
+    else
+      __value = __value * __scale + __block;
+    first = __p;
+  }
+  x = __value;
+  return first;
+}
+#endif // TEUTHID_HAVE_INT_128
+} // namespace
+
+#ifdef TEUTHID_HAVE_INT_128
+std::string system::uint128_to_string_(uint128_t x, bool negative) {
+  char __buf[48], *__end = __buf + sizeof(__buf);
+  char *__p = __format_digits(__end, x);
+  if (negative)
+    *--__p = '-';
+  return std::string(__p, __end);
+}
+
+template <> std::string system::to_string(const int128_t &x) {
+  uint128_t __abs = (x < 0) ? uint128_t(0) - static_cast<uint128_t>(x)
+                            : static_cast<uint128_t>(x);
+  return system::uint128_to_string_(__abs, (x < 0));
 }
 
 template <> std::string system::to_string(const uint128_t &x) {
-  if (x > UINT64_MAX)
-    return system::uint128_to_string_(x);
-  else
-    return std::to_string(static_cast<unsigned long long>(x));
+  return system::uint128_to_string_(x, false);
 }
 #endif // TEUTHID_HAVE_INT_128
 
-#define __TEUTHID_STRING_FROM_FLOAT(TYPE)                                      \
+namespace {
+// prints into a buffer on the stack, or into the string itself when the output
+// does not fit into it; F is like snprintf() without the format
+template <typename F> std::string __print_string(F print) {
+  char __buf[128];
+  int __n = print(__buf, sizeof(__buf));
+  if (__n < 0)
+    throw std::runtime_error("cannot format floating point value");
+  if (static_cast<std::size_t>(__n) < sizeof(__buf))
+    return std::string(__buf, __n);
+  std::string __s(__n, '\0');
+  print(&__s[0], __s.size() + 1);
+  return __s;
+}
+} // namespace
+
+#define __TEUTHID_STRING_FROM_FLOAT(TYPE, LENGTH)                              \
+  template <>                                                                  \
+  std::string system::to_string(const TYPE &x, const float_format &format) {   \
+    return __print_string([&](char *s, std::size_t n) {                        \
+      return std::snprintf(s, n, format.scientific ? "%.*" LENGTH "e"          \
+                                                   : "%.*" LENGTH "f",         \
+                           static_cast<int>(format.precision), x);             \
+    });                                                                        \
+  }                                                                            \
   template <> std::string system::to_string(const TYPE &x) {                   \
-    std::ostringstream __os;                                                   \
-    __os.precision(system::format_float_precision_.load());                    \
-    __os << (system::format_float_scientific_.load() ? std::scientific         \
-                                                     : std::fixed);            \
-    __os << x;                                                                 \
-    return __os.str();                                                         \
-  }
-__TEUTHID_STRING_FROM_FLOAT(float);
-__TEUTHID_STRING_FROM_FLOAT(double);
-__TEUTHID_STRING_FROM_FLOAT(long double);
+    return system::to_string(x, system::float_format_);                        \
+  }
+__TEUTHID_STRING_FROM_FLOAT(float, "");
+__TEUTHID_STRING_FROM_FLOAT(double, "");
+__TEUTHID_STRING_FROM_FLOAT(long double, "L");
 #undef __TEUTHID_STRING_FROM_FLOAT
 
+#ifdef TEUTHID_HAVE_QUADMATH
+template <>
+std::string system::to_string(const __float128 &x,
+                              const float_format &format) {
+  return __print_string([&](char *s, std::size_t n) {
+    return quadmath_snprintf(s, n, format.scientific ? "%.*Qe" : "%.*Qf",
+                             static_cast<int>(format.precision), x);
+  });
+}
+
+template <> std::string system::to_string(const __float128 &x) {
+  return system::to_string(x, system::float_format_);
+}
+#endif // TEUTHID_HAVE_QUADMATH
+
+template <>
+std::string system::to_string(const mpfr_t &x, const float_format &format) {
+  return __print_string([&](char *s, std::size_t n) {
+    return mpfr_snprintf(s, n, format.scientific ? "%.*Re" : "%.*Rf",
+                         static_cast<int>(format.precision), x);
+  });
+}
+
 template <> std::string system::to_string(const mpfr_t &x) {
-  char __str[512], __precision[64];
-  std::string __format =
-      (system::format_float_scientific_.load() ? "%%.%ldRe" : "%%.%ldRf");
-  sprintf(__precision, __format.c_str(),
-          system::format_float_precision_.load());
-  mpfr_sprintf(__str, __precision, x);
-  return std::string(__str);
+  return system::to_string(x, system::float_format_);
+}
+
+template <>
+std::string system::to_string(const floatmp_base &x,
+                              const float_format &format) {
+  return system::to_string(x.c_mpfr(), format);
 }
 
 template <> std::string system::to_string(const floatmp_base &x) {
-  return system::to_string(x.c_mpfr());
+  return system::to_string(x.c_mpfr(), system::float_format_);
 }
 
 template <> std::string system::to_string(const std::vector<std::string> &v) {
@@ -140,6 +397,476 @@ template <> std::string system::to_string(const std::vector<std::string> &v) {
   return __str;
 }
 
+namespace {
+typedef system::to_chars_result __chars_result;
+
+__chars_result __too_large(char *last) noexcept {
+  return {last, std::errc::value_too_large};
+}
+
+__chars_result __copy_chars(char *first, char *last, const char *s,
+                            std::size_t n) noexcept {
+  if (static_cast<std::size_t>(last - first) < n)
+    return __too_large(last);
+  std::memcpy(first, s, n);
+  return {first + n, std::errc()};
+}
+
+template <typename U>
+__chars_result __integer_to_chars(char *first, char *last, U value,
+                                  bool negative) noexcept {
+  typedef typename std::conditional<(sizeof(U) > sizeof(uint64_t)), U,
+                                    uint64_t>::type __word_t;
+  char __buf[48], *__end = __buf + sizeof(__buf);
+  char *__p = __format_digits(__end, static_cast<__word_t>(value));
+  if (negative)
+    *--__p = '-';
+  return __copy_chars(first, last, __p, __end - __p);
+}
+
+std::size_t __decimal_length(unsigned long x) noexcept {
+  std::size_t __n = 1;
+  for (; x >= 10; x /= 10)
+    ++__n;
+  return __n;
+}
+
+// writes [-]digits * 10^exponent in the shorter of the fixed and the
+// scientific notation (the fixed one if they are equally long)
+__chars_result __decimal_to_chars(char *first, char *last, bool negative,
+                                  const char *digits, std::size_t n,
+                                  long exponent) noexcept {
+  while ((n > 1) && (digits[n - 1] == '0')) {
+    --n;
+    ++exponent;
+  }
+  if ((n == 1) && (digits[0] == '0'))
+    exponent = 0;
+  long __sci = exponent + static_cast<long>(n) - 1;
+  unsigned long __abs_sci = (__sci < 0) ? -__sci : __sci;
+  std::size_t __sci_length =
+      n + (n > 1) + 2 + std::max<std::size_t>(__decimal_length(__abs_sci), 2);
+  std::size_t __fixed_length;
+  if (exponent >= 0)
+    __fixed_length = n + exponent;
+  else if (__sci >= 0)
+    __fixed_length = n + 1;
+  else
+    __fixed_length = n + 1 + __abs_sci;
+  std::size_t __length = negative + std::min(__fixed_length, __sci_length);
+  if (static_cast<std::size_t>(last - first) < __length)
+    return __too_large(last);
+  char *__p = first;
+  if (negative)
+    *__p++ = '-';
+  if (__fixed_length <= __sci_length) {
+    if (exponent >= 0) {
+      std::memcpy(__p, digits, n);
+      std::memset(__p + n, '0', exponent);
+    } else if (__sci >= 0) {
+      std::memcpy(__p, digits, __sci + 1);
+      __p[__sci + 1] = '.';
+      std::memcpy(__p + __sci + 2, digits + __sci + 1, n - __sci - 1);
+    } else {
+      __p[0] = '0';
+      __p[1] = '.';
+      std::memset(__p + 2, '0', __abs_sci - 1);
+      std::memcpy(__p + 1 + __abs_sci, digits, n);
+    }
+    return {first + __length, std::errc()};
+  }
+  *__p++ = digits[0];
+  if (n > 1) {
+    *__p++ = '.';
+    std::memcpy(__p, digits + 1, n - 1);
+    __p += n - 1;
+  }
+  *__p++ = 'e';
+  *__p++ = (__sci < 0) ? '-' : '+';
+  if (__abs_sci < 10)
+    *__p++ = '0';
+  return __integer_to_chars(__p, last, __abs_sci, false);
+}
+
+__chars_result __special_to_chars(char *first, char *last, bool negative,
+                                  bool nan) noexcept {
+  if (nan)
+    return __copy_chars(first, last, "nan", 3);
+  return negative ? __copy_chars(first, last, "-inf", 4)
+                  : __copy_chars(first, last, "inf", 3);
+}
+
+// the shortest digits of x which are read back as x, found by printing x
+// with increasing precision
+inline int __print_exponential(char *s, std::size_t n, int precision,
+                               float x) {
+  return std::snprintf(s, n, "%.*e", precision, x);
+}
+inline int __print_exponential(char *s, std::size_t n, int precision,
+                               double x) {
+  return std::snprintf(s, n, "%.*e", precision, x);
+}
+inline int __print_exponential(char *s, std::size_t n, int precision,
+                               long double x) {
+  return std::snprintf(s, n, "%.*Le", precision, x);
+}
+inline void __read(const char *s, float &x) { x = std::strtof(s, nullptr); }
+inline void __read(const char *s, double &x) { x = std::strtod(s, nullptr); }
+inline void __read(const char *s, long double &x) {
+  x = std::strtold(s, nullptr);
+}
+#ifdef TEUTHID_HAVE_QUADMATH
+inline int __print_exponential(char *s, std::size_t n, int precision,
+                               __float128 x) {
+  return quadmath_snprintf(s, n, "%.*Qe", precision, x);
+}
+inline void __read(const char *s, __float128 &x) {
+  x = strtoflt128(s, nullptr);
+}
+#endif // TEUTHID_HAVE_QUADMATH
+
+template <typename T, int MaxDigits>
+__chars_result __printed_to_chars(char *first, char *last, const T &x) {
+  char __buf[MaxDigits + 16], __digits[MaxDigits + 1];
+  T __y;
+  int __precision = 0;
+  for (; __precision < MaxDigits - 1; ++__precision) {
+    __print_exponential(__buf, sizeof(__buf), __precision, x);
+    __read(__buf, __y);
+    if (__y == x)
+      break;
+  }
+  __print_exponential(__buf, sizeof(__buf), __precision, x);
+  // [-]d.ddde[+-]xx
+  const char *__p = __buf + (__buf[0] == '-');
+  std::size_t __n = 0;
+  for (; *__p != 'e'; ++__p)
+    if (*__p != '.')
+      __digits[__n++] = *__p;
+  long __exponent = std::strtol(__p + 1, nullptr, 10);
+  return __decimal_to_chars(first, last, (__buf[0] == '-'), __digits, __n,
+                            __exponent - static_cast<long>(__n) + 1);
+}
+
+template <typename T>
+__chars_result __float_to_chars(char *first, char *last, const T &x) {
+  if (!std::isfinite(x))
+    return __special_to_chars(first, last, std::signbit(x), std::isnan(x));
+  if (x == 0)
+    return __decimal_to_chars(first, last, std::signbit(x), "0", 1, 0);
+  return __printed_to_chars<T, std::numeric_limits<T>::max_digits10>(first,
+                                                                     last, x);
+}
+
+#ifdef TEUTHID_HAVE_INT_128
+// the shortest decimal representation of a binary floating point value which
+// is read back as the same value (the algorithm Ryu by Ulf Adams); the tables
+// of double are used also for float
+class __ryu {
+public:
+  static const __ryu &instance() {
+    static const __ryu __instance;
+    return __instance;
+  }
+  // the value is mantissa * 2^exponent in the IEEE 754 binary format
+  void shortest(uint64_t mantissa, int32_t exponent, int mantissa_bits,
+                int bias, uint64_t &digits, int32_t &e10) const noexcept;
+
+private:
+  static constexpr int bitcount_ = 125;
+  static constexpr int pow5_size_ = 326;
+  static constexpr int pow5_inv_size_ = 342;
+  uint64_t pow5_[pow5_size_][2];
+  uint64_t pow5_inv_[pow5_inv_size_][2];
+
+  __ryu();
+  static void export_(mpz_srcptr x, uint64_t *words) {
+    words[0] = words[1] = 0;
+    mpz_export(words, nullptr, -1, sizeof(uint64_t), 0, 0, x);
+  }
+  static int32_t pow5bits_(int32_t e) noexcept {
+    return static_cast<int32_t>(((e * 1217359) >> 19) + 1);
+  }
+  static uint32_t log10_pow2_(int32_t e) noexcept {
+    return (static_cast<uint32_t>(e) * 78913) >> 18;
+  }
+  static uint32_t log10_pow5_(int32_t e) noexcept {
+    return (static_cast<uint32_t>(e) * 732923) >> 20;
+  }
+  static uint32_t pow5_factor_(uint64_t x) noexcept {
+    uint32_t __count = 0;
+    for (; x % 5 == 0; x /= 5)
+      ++__count;
+    return __count;
+  }
+  static bool multiple_of_pow5_(uint64_t x, uint32_t p) noexcept {
+    return pow5_factor_(x) >= p;
+  }
+  static bool multiple_of_pow2_(uint64_t x, uint32_t p) noexcept {
+    return (x & ((uint64_t(1) << p) - 1)) == 0;
+  }
+  static uint64_t mul_shift_(uint64_t m, const uint64_t *mul,
+                             int32_t j) noexcept {
+    uint128_t __b0 = static_cast<uint128_t>(m) * mul[0];
+    uint128_t __b2 = static_cast<uint128_t>(m) * mul[1];
+    return static_cast<uint64_t>(((__b0 >> 64) + __b2) >> (j - 64));
+  }
+};
+
+constexpr int __ryu::bitcount_;
+constexpr int __ryu::pow5_size_;
+constexpr int __ryu::pow5_inv_size_;
+
+__ryu::__ryu() {
+  floatmp_arena::suspend __suspend;
+  mpz_t __pow, __x;
+  mpz_init_set_ui(__pow, 1);
+  mpz_init(__x);
+  for (int __i = 0; __i < pow5_inv_size_; ++__i) {
+    int32_t __length = mpz_sizeinbase(__pow, 2);
+    if (__i < pow5_size_) {
+      if (__length >= bitcount_)
+        mpz_tdiv_q_2exp(__x, __pow, __length - bitcount_);
+      else
+        mpz_mul_2exp(__x, __pow, bitcount_ - __length);
+      export_(__x, pow5_[__i]);
+    }
+    mpz_set_ui(__x, 1);
+    mpz_mul_2exp(__x, __x, __length - 1 + bitcount_);
+    mpz_tdiv_q(__x, __x, __pow);
+    mpz_add_ui(__x, __x, 1);
+    export_(__x, pow5_inv_[__i]);
+    mpz_mul_ui(__pow, __pow, 5);
+  }
+  mpz_clear(__x);
+  mpz_clear(__pow);
+}
+
+void __ryu::shortest(uint64_t mantissa, int32_t exponent, int mantissa_bits,
+                     int bias, uint64_t &digits, int32_t &e10) const noexcept {
+  int32_t __e2;
+  uint64_t __m2;
+  if (exponent == 0) {
+    __e2 = 1 - bias - mantissa_bits - 2;
+    __m2 = mantissa;
+  } else {
+    __e2 = exponent - bias - mantissa_bits - 2;
+    __m2 = (uint64_t(1) << mantissa_bits) | mantissa;
+  }
+  bool __accept_bounds = ((__m2 & 1) == 0);
+
+  // the interval of the values which are read back as the given one
+  uint64_t __mv = 4 * __m2;
+  uint32_t __mm_shift = (mantissa != 0) || (exponent <= 1);
+  uint64_t __vr, __vp, __vm;
+  bool __vm_trailing_zeros = false, __vr_trailing_zeros = false;
+  if (__e2 >= 0) {
+    uint32_t __q = log10_pow2_(__e2) - (__e2 > 3);
+    e10 = __q;
+    int32_t __k = bitcount_ + pow5bits_(__q) - 1;
+    int32_t __i = -__e2 + static_cast<int32_t>(__q) + __k;
+    __vr = mul_shift_(__mv, pow5_inv_[__q], __i);
+    __vp = mul_shift_(__mv + 2, pow5_inv_[__q], __i);
+    __vm = mul_shift_(__mv - 1 - __mm_shift, pow5_inv_[__q], __i);
+    if (__q <= 21) {
+      if (__mv % 5 == 0)
+        __vr_trailing_zeros = multiple_of_pow5_(__mv, __q);
+      else if (__accept_bounds)
+        __vm_trailing_zeros = multiple_of_pow5_(__mv - 1 - __mm_shift, __q);
+      else
+        __vp -= multiple_of_pow5_(__mv + 2, __q);
+    }
+  } else {
+    uint32_t __q = log10_pow5_(-__e2) - (-__e2 > 1);
+    e10 = static_cast<int32_t>(__q) + __e2;
+    int32_t __i = -__e2 - static_cast<int32_t>(__q);
+    int32_t __k = pow5bits_(__i) - bitcount_;
+    int32_t __j = static_cast<int32_t>(__q) - __k;
+    __vr = mul_shift_(__mv, pow5_[__i], __j);
+    __vp = mul_shift_(__mv + 2, pow5_[__i], __j);
+    __vm = mul_shift_(__mv - 1 - __mm_shift, pow5_[__i], __j);
+    if (__q <= 1) {
+      __vr_trailing_zeros = true;
+      if (__accept_bounds)
+        __vm_trailing_zeros = (__mm_shift == 1);
+      else
+        --__vp;
+    } else if (__q < 63)
+      __vr_trailing_zeros = multiple_of_pow2_(__mv, __q);
+  }
+
+  // the shortest representation in the interval
+  int32_t __removed = 0;
+  unsigned __last_removed = 0;
+  if (__vm_trailing_zeros || __vr_trailing_zeros) {
+    while (__vp / 10 > __vm / 10) {
+      __vm_trailing_zeros &= (__vm % 10 == 0);
+      __vr_trailing_zeros &= (__last_removed == 0);
+      __last_removed = __vr % 10;
+      __vr /= 10;
+      __vp /= 10;
+      __vm /= 10;
+      ++__removed;
+    }
+    if (__vm_trailing_zeros)
+      while (__vm % 10 == 0) {
+        __vr_trailing_zeros &= (__last_removed == 0);
+        __last_removed = __vr % 10;
+        __vr /= 10;
+        __vp /= 10;
+        __vm /= 10;
+        ++__removed;
+      }
+    if (__vr_trailing_zeros && (__last_removed == 5) && (__vr % 2 == 0))
+      __last_removed = 4; // round to even
+    digits = __vr + (((__vr == __vm) &&
+                      (!__accept_bounds || !__vm_trailing_zeros)) ||
+                     (__last_removed >= 5));
+  } else {
+    bool __round_up = false;
+    while (__vp / 10 > __vm / 10) {
+      __round_up = (__vr % 10 >= 5);
+      __vr /= 10;
+      __vp /= 10;
+      __vm /= 10;
+      ++__removed;
+    }
+    digits = __vr + ((__vr == __vm) || __round_up);
+  }
+  e10 += __removed;
+}
+
+template <typename T, typename U, int MantissaBits, int ExponentBits>
+__chars_result __ryu_to_chars(char *first, char *last, const T &x) noexcept {
+  U __bits;
+  std::memcpy(&__bits, &x, sizeof(T));
+  bool __negative = ((__bits >> (MantissaBits + ExponentBits)) & 1) != 0;
+  uint64_t __mantissa = __bits & ((U(1) << MantissaBits) - 1);
+  int32_t __exponent = (__bits >> MantissaBits) & ((1 << ExponentBits) - 1);
+  if (__exponent == (1 << ExponentBits) - 1)
+    return __special_to_chars(first, last, __negative, (__mantissa != 0));
+  if ((__exponent == 0) && (__mantissa == 0))
+    return __decimal_to_chars(first, last, __negative, "0", 1, 0);
+  uint64_t __output;
+  int32_t __e10;
+  __ryu::instance().shortest(__mantissa, __exponent, MantissaBits,
+                             (1 << (ExponentBits - 1)) - 1, __output, __e10);
+  char __digits[24];
+  __chars_result __r = __integer_to_chars(
+      __digits, __digits + sizeof(__digits), __output, false);
+  return __decimal_to_chars(first, last, __negative, __digits,
+                            __r.ptr - __digits, __e10);
+}
+#endif // TEUTHID_HAVE_INT_128
+} // namespace
+
+#define __TEUTHID_SIGNED_INTEGER_TO_CHARS(TYPE, UTYPE)                         \
+  template <>                                                                  \
+  system::to_chars_result system::to_chars(char *first, char *last,            \
+                                           const TYPE &x) {                    \
+    UTYPE __abs = (x < 0) ? UTYPE(0) - static_cast<UTYPE>(x)                   \
+                          : static_cast<UTYPE>(x);                             \
+    return __integer_to_chars(first, last, __abs, (x < 0));                    \
+  }
+__TEUTHID_SIGNED_INTEGER_TO_CHARS(int8_t, uint8_t);
+__TEUTHID_SIGNED_INTEGER_TO_CHARS(int16_t, uint16_t);
+__TEUTHID_SIGNED_INTEGER_TO_CHARS(int32_t, uint32_t);
+__TEUTHID_SIGNED_INTEGER_TO_CHARS(int64_t, uint64_t);
+#ifdef TEUTHID_HAVE_INT_128
+__TEUTHID_SIGNED_INTEGER_TO_CHARS(int128_t, uint128_t);
+#endif // TEUTHID_HAVE_INT_128
+#undef __TEUTHID_SIGNED_INTEGER_TO_CHARS
+
+#define __TEUTHID_UNSIGNED_INTEGER_TO_CHARS(TYPE)                              \
+  template <>                                                                  \
+  system::to_chars_result system::to_chars(char *first, char *last,            \
+                                           const TYPE &x) {                    \
+    return __integer_to_chars(first, last, x, false);                          \
+  }
+__TEUTHID_UNSIGNED_INTEGER_TO_CHARS(uint8_t);
+__TEUTHID_UNSIGNED_INTEGER_TO_CHARS(uint16_t);
+__TEUTHID_UNSIGNED_INTEGER_TO_CHARS(uint32_t);
+__TEUTHID_UNSIGNED_INTEGER_TO_CHARS(uint64_t);
+#ifdef TEUTHID_HAVE_INT_128
+__TEUTHID_UNSIGNED_INTEGER_TO_CHARS(uint128_t);
+#endif // TEUTHID_HAVE_INT_128
+#undef __TEUTHID_UNSIGNED_INTEGER_TO_CHARS
+
+#ifdef TEUTHID_HAVE_INT_128
+template <>
+system::to_chars_result system::to_chars(char *first, char *last,
+                                         const float &x) {
+  static_assert(std::numeric_limits<float>::is_iec559, "requires IEEE 754");
+  return __ryu_to_chars<float, uint32_t, 23, 8>(first, last, x);
+}
+
+template <>
+system::to_chars_result system::to_chars(char *first, char *last,
+                                         const double &x) {
+  static_assert(std::numeric_limits<double>::is_iec559, "requires IEEE 754");
+  return __ryu_to_chars<double, uint64_t, 52, 11>(first, last, x);
+}
+#else
+template <>
+system::to_chars_result system::to_chars(char *first, char *last,
+                                         const float &x) {
+  return __float_to_chars(first, last, x);
+}
+
+template <>
+system::to_chars_result system::to_chars(char *first, char *last,
+                                         const double &x) {
+  return __float_to_chars(first, last, x);
+}
+#endif // TEUTHID_HAVE_INT_128
+
+template <>
+system::to_chars_result system::to_chars(char *first, char *last,
+                                         const long double &x) {
+  return __float_to_chars(first, last, x);
+}
+
+#ifdef TEUTHID_HAVE_QUADMATH
+template <>
+system::to_chars_result system::to_chars(char *first, char *last,
+                                         const __float128 &x) {
+  if (isinfq(x) || isnanq(x))
+    return __special_to_chars(first, last, signbitq(x), isnanq(x));
+  if (x == 0)
+    return __decimal_to_chars(first, last, signbitq(x), "0", 1, 0);
+  return __printed_to_chars<__float128, FLT128_DIG + 3>(first, last, x);
+}
+#endif // TEUTHID_HAVE_QUADMATH
+
+template <>
+system::to_chars_result system::to_chars(char *first, char *last,
+                                         const mpfr_t &x) {
+  if (mpfr_nan_p(x) || mpfr_inf_p(x))
+    return __special_to_chars(first, last, mpfr_signbit(x), mpfr_nan_p(x));
+  if (mpfr_zero_p(x))
+    return __decimal_to_chars(first, last, mpfr_signbit(x), "0", 1, 0);
+  // the number of digits which are read back as the same value
+  std::size_t __n = 1 + static_cast<std::size_t>(
+                           std::ceil(mpfr_get_prec(x) * 0.30102999566398120));
+  char __buf[TEUTHID_FLOATMP_MAX_PRECISION * 3 / 10 + 8];
+  mpfr_exp_t __exp;
+  char *__digits = mpfr_get_str((__n + 2 <= sizeof(__buf)) ? __buf : nullptr,
+                                &__exp, 10, __n, x, MPFR_RNDN);
+  bool __negative = (__digits[0] == '-');
+  system::to_chars_result __r =
+      __decimal_to_chars(first, last, __negative, __digits + __negative, __n,
+                         static_cast<long>(__exp) - static_cast<long>(__n));
+  if (__digits != __buf)
+    mpfr_free_str(__digits);
+  return __r;
+}
+
+template <>
+system::to_chars_result system::to_chars(char *first, char *last,
+                                         const floatmp_base &x) {
+  return system::to_chars(first, last, x.c_mpfr());
+}
+
 #endif // DOXYGEN_SHOULD_SKIP_THIS
 
 std::size_t system::split_string(const std::string &s,
@@ -168,13 +895,15 @@ std::size_t system::split_string(const std::string &s,
 
 void system::format_float_output(std::streamsize precision, bool scientific) {
   assert(precision > 0);
-  system::format_float_precision_.store(precision);
-  system::format_float_scientific_.store(scientific);
+  system::float_format_.precision = precision;
+  system::float_format_.scientific = scientific;
 }
 
 std::streamsize system::format_float_precision(std::streamsize precision) {
   assert(precision > 0);
-  return format_float_precision_.exchange(precision);
+  std::streamsize __prev = system::float_format_.precision;
+  system::float_format_.precision = precision;
+  return __prev;
 }
 
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
@@ -237,15 +966,14 @@ __TEUTHID_UNSIGNED_INTEGER_FROM_STRING(uint64_t);
 #undef __TEUTHID_UNSIGNED_INTEGER_FROM_STRING
 
 #ifdef TEUTHID_HAVE_INT_128
-uint128_t system::string_to_unit128_(const std::string &s) {
-  uint128_t __value = 0;
-  for (std::size_t __i = 0; __i < s.size(); __i++)
-    if (std::isdigit(s[__i])) {
-      __value += std::stoi(s.substr(__i, 1));
-      if ((__i + 1) < s.size())
-        __value *= 10;
-    } else
-      throw std::invalid_argument("invalid string");
+uint128_t system::string_to_unit128_(const std::string &s, uint128_t max) {
+  const char *__end = s.data() + s.size();
+  uint128_t __value;
+  bool __overflow;
+  if (__parse_digits(s.data(), __end, max, __value, __overflow) != __end)
+    throw std::invalid_argument("invalid string");
+  if (__overflow)
+    throw std::out_of_range("value out of range");
   return __value;
 }
 
@@ -258,8 +986,12 @@ template <> int128_t &system::from_string(const std::string &s, int128_t &x) {
       __s = __s.substr(1);
     }
     if (!__s.empty()) {
-      x = system::string_to_unit128_(__s);
-      x = __minus ? -x : x;
+      uint128_t __max = (~uint128_t(0) >> 1) + __minus;
+      uint128_t __abs = system::string_to_unit128_(__s, __max);
+      if (!__minus)
+        x = static_cast<int128_t>(__abs);
+      else
+        x = (__abs == 0) ? 0 : -static_cast<int128_t>(__abs - 1) - 1;
       return x;
     }
   }
@@ -272,7 +1004,7 @@ template <> uint128_t &system::from_string(const std::string &s, uint128_t &x) {
     if (__s[0] == '+')
       __s = __s.substr(1);
     if (!__s.empty()) {
-      x = system::string_to_unit128_(__s);
+      x = system::string_to_unit128_(__s, ~uint128_t(0));
       return x;
     }
   }
@@ -294,6 +1026,25 @@ __TEUTHID_FLOAT_FROM_STRING(double, stod);
 __TEUTHID_FLOAT_FROM_STRING(long double, stold);
 #undef __TEUTHID_FLOAT_FROM_STRING
 
+#ifdef TEUTHID_HAVE_QUADMATH
+template <>
+__float128 &system::from_string(const std::string &s, __float128 &x) {
+  std::string __s = system::validate_string_(s);
+  if (!__s.empty()) {
+    char *__end;
+    errno = 0;
+    __float128 __x = strtoflt128(__s.c_str(), &__end);
+    if (__end != __s.c_str()) {
+      if (errno == ERANGE)
+        throw std::out_of_range("value out of range");
+      x = __x;
+      return x;
+    }
+  }
+  throw std::invalid_argument("empty or invalid string");
+}
+#endif // TEUTHID_HAVE_QUADMATH
+
 template <> mpfr_t &system::from_string(const std::string &s, mpfr_t &x) {
   std::string __s = system::validate_string_(s);
   if (!__s.empty())
@@ -305,55 +1056,575 @@ template <> mpfr_t &system::from_string(const std::string &s, mpfr_t &x) {
 template <>
 floatmp_base &system::from_string(const std::string &s, floatmp_base &x) {
   std::string __s = system::validate_string_(s);
-  mpfr_t __result;
-  mpfr_init2(__result, mpfr_get_prec(x.c_mpfr()));
-  if (!__s.empty())
+  if (!__s.empty()) {
+    floatmp_scratch_pool::lease __result(mpfr_get_prec(x.c_mpfr()));
     if (mpfr_set_str(__result, __s.c_str(), 10,
                      static_cast<mpfr_rnd_t>(floatmp_base::rounding_mode())) ==
         0) {
-      x.assign(__result);
-      mpfr_clear(__result);
+      mpfr_set(x.value_, __result, MPFR_RNDN); // exact
       return x;
     }
+  }
   throw std::invalid_argument("empty or invalid string");
 }
 
-#define __TEUTHID_FLOAT_EQUAL_TO(TYPE)                                         \
-  template <> bool system::equal_to(const TYPE &x, const TYPE &y) {            \
-    if (std::isfinite(x) && std::isfinite(y))                                  \
-      return (system::to_string(x).compare(system::to_string(y)) == 0);        \
-    else                                                                       \
-      return false;                                                            \
+namespace {
+typedef system::from_chars_result __parse_result;
+
+// the value is not changed if the digits are out of range
+template <typename U>
+__parse_result __parse_unsigned(const char *first, const char *last, U &x,
+                                U max) noexcept {
+  const char *__p = first;
+  const U __limit = max / 10;
+  const unsigned __last_digit = static_cast<unsigned>(max % 10);
+  U __value = 0;
+  bool __overflow = false;
+  for (; (__p != last) && __is_digit(*__p); ++__p) {
+    unsigned __digit = *__p - '0';
+    if ((__value > __limit) ||
+        ((__value == __limit) && (__digit > __last_digit)))
+      __overflow = true;
+    else
+      __value = static_cast<U>(__value * 10 + __digit);
   }
-__TEUTHID_FLOAT_EQUAL_TO(float);
-__TEUTHID_FLOAT_EQUAL_TO(double);
-__TEUTHID_FLOAT_EQUAL_TO(long double);
-#undef __TEUTHID_FLOAT_EQUAL_TO
+  if (__p == first)
+    return {first, std::errc::invalid_argument};
+  if (__overflow)
+    return {__p, std::errc::result_out_of_range};
+  x = __value;
+  return {__p, std::errc()};
+}
 
-template <> bool system::equal_to(const mpfr_t &x, const mpfr_t &y) {
-  if ((mpfr_number_p(x) == 0) || (mpfr_number_p(y) == 0))
+#ifdef TEUTHID_HAVE_INT_128
+__parse_result __parse_unsigned(const char *first, const char *last,
+                                uint128_t &x, uint128_t max) noexcept {
+  uint128_t __value;
+  bool __overflow;
+  const char *__p = __parse_digits(first, last, max, __value, __overflow);
+  if (__p == first)
+    return {first, std::errc::invalid_argument};
+  if (__overflow)
+    return {__p, std::errc::result_out_of_range};
+  x = __value;
+  return {__p, std::errc()};
+}
+#endif // TEUTHID_HAVE_INT_128
+
+template <typename T, typename U>
+__parse_result __parse_signed(const char *first, const char *last,
+                              T &x) noexcept {
+  bool __negative = (first != last) && (*first == '-');
+  U __max = static_cast<U>(~U(0)) >> 1, __abs = 0;
+  __parse_result __r =
+      __parse_unsigned(first + __negative, last, __abs,
+                       static_cast<U>(__max + __negative));
+  if (__r.ec == std::errc::invalid_argument)
+    return {first, __r.ec};
+  if (__r.ec == std::errc()) {
+    if (!__negative)
+      x = static_cast<T>(__abs);
+    else
+      x = (__abs == 0) ? T(0) : -static_cast<T>(__abs - 1) - 1;
+  }
+  return __r;
+}
+
+// compares the characters with a lower case word
+bool __starts_with(const char *first, const char *last,
+                   const char *word) noexcept {
+  for (; *word; ++first, ++word)
+    if ((first == last) || (std::tolower(*first) != *word))
+      return false;
+  return true;
+}
+
+// the end of a decimal floating point number (or inf, infinity, nan,
+// nan(chars)) at the beginning of the range, or first if there is none
+const char *__scan_float(const char *first, const char *last) noexcept {
+  const char *__p = first;
+  if ((__p != last) && (*__p == '-'))
+    ++__p;
+  if (__starts_with(__p, last, "inf"))
+    return __p + (__starts_with(__p, last, "infinity") ? 8 : 3);
+  if (__starts_with(__p, last, "nan")) {
+    __p += 3;
+    if ((__p != last) && (*__p == '(')) {
+      const char *__q = __p + 1;
+      while ((__q != last) && (std::isalnum(*__q) || (*__q == '_')))
+        ++__q;
+      if ((__q != last) && (*__q == ')'))
+        __p = __q + 1;
+    }
+    return __p;
+  }
+  const char *__digits = __p;
+  while ((__p != last) && __is_digit(*__p))
+    ++__p;
+  bool __any = (__p != __digits);
+  if ((__p != last) && (*__p == '.')) {
+    __digits = ++__p;
+    while ((__p != last) && __is_digit(*__p))
+      ++__p;
+    __any = __any || (__p != __digits);
+  }
+  if (!__any)
+    return first;
+  if ((__p != last) && ((*__p == 'e') || (*__p == 'E'))) {
+    const char *__q = __p + 1;
+    if ((__q != last) && ((*__q == '+') || (*__q == '-')))
+      ++__q;
+    if ((__q != last) && __is_digit(*__q)) {
+      while ((__q != last) && __is_digit(*__q))
+        ++__q;
+      __p = __q;
+    }
+  }
+  return __p;
+}
+
+// an exact conversion when the digits and the power of 10 are exactly
+// representable, so that the result is rounded once (the fast path of
+// Clinger); the range holds a number found by __scan_float()
+template <typename T> bool __parse_fast(const char *, const char *, T &) {
+  return false;
+}
+
+template <typename T, int MantissaBits, int MaxExponent>
+bool __parse_exact(const char *first, const char *last, T &x,
+                   const T *powers) noexcept {
+#if FLT_EVAL_METHOD == 0
+  const char *__p = first;
+  bool __negative = (*__p == '-');
+  __p += __negative;
+  uint64_t __m = 0;
+  int __digits = 0;
+  long __exponent = 0;
+  for (; (__p != last) && __is_digit(*__p); ++__p)
+    if ((__m != 0) || (*__p != '0')) {
+      if (++__digits > 19)
+        return false;
+      __m = __m * 10 + (*__p - '0');
+    }
+  if ((__p != last) && (*__p == '.'))
+    for (++__p; (__p != last) && __is_digit(*__p); ++__p, --__exponent)
+      if ((__m != 0) || (*__p != '0')) {
+        if (++__digits > 19)
+          return false;
+        __m = __m * 10 + (*__p - '0');
+      }
+  if (__p != last) {
+    if ((*__p != 'e') && (*__p != 'E'))
+      return false; // inf or nan
+    bool __minus = (*++__p == '-');
+    __p += (*__p == '+') || __minus;
+    long __e = 0;
+    for (; (__p != last) && (__e < 10000); ++__p)
+      __e = __e * 10 + (*__p - '0');
+    __exponent += __minus ? -__e : __e;
+  }
+  if ((__m >> MantissaBits) != 0)
     return false;
+  if (__m == 0)
+    __exponent = 0;
+  if ((__exponent < -MaxExponent) || (__exponent > MaxExponent))
+    return false;
+  T __value = static_cast<T>(__m);
+  if (__exponent < 0)
+    __value /= powers[-__exponent];
   else
-    return (system::to_string(x).compare(system::to_string(y)) == 0);
+    __value *= powers[__exponent];
+  x = __negative ? -__value : __value;
+  return true;
+#else
+  return false;
+#endif // FLT_EVAL_METHOD
+}
+
+bool __parse_fast(const char *first, const char *last, float &x) {
+  static const float __powers[] = {1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f,
+                                   1e6f, 1e7f, 1e8f, 1e9f, 1e10f};
+  return __parse_exact<float, 24, 10>(first, last, x, __powers);
+}
+
+bool __parse_fast(const char *first, const char *last, double &x) {
+  static const double __powers[] = {
+      1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+      1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+  return __parse_exact<double, 53, 22>(first, last, x, __powers);
+}
+
+// calls parse() with a NUL-terminated copy of the range, which is made on
+// the stack unless the range is very long
+template <typename F>
+void __parse_cstring(const char *first, const char *last, F parse) {
+  char __buf[256];
+  std::size_t __n = last - first;
+  if (__n < sizeof(__buf)) {
+    std::memcpy(__buf, first, __n);
+    __buf[__n] = '\0';
+    parse(__buf);
+  } else
+    parse(std::string(first, last).c_str());
+}
+
+inline void __strto(const char *s, float &x) { x = std::strtof(s, nullptr); }
+inline void __strto(const char *s, double &x) { x = std::strtod(s, nullptr); }
+inline void __strto(const char *s, long double &x) {
+  x = std::strtold(s, nullptr);
+}
+#ifdef TEUTHID_HAVE_QUADMATH
+inline void __strto(const char *s, __float128 &x) {
+  x = strtoflt128(s, nullptr);
+}
+#endif // TEUTHID_HAVE_QUADMATH
+
+template <typename T>
+__parse_result __parse_float(const char *first, const char *last, T &x) {
+  const char *__end = __scan_float(first, last);
+  if (__end == first)
+    return {first, std::errc::invalid_argument};
+  if (__parse_fast(first, __end, x))
+    return {__end, std::errc()};
+  T __value;
+  int __errno;
+  __parse_cstring(first, __end, [&](const char *s) {
+    errno = 0;
+    __strto(s, __value);
+    __errno = errno;
+  });
+  // overflows and underflows to zero (the subnormal values are accepted)
+  if ((__errno == ERANGE) &&
+      ((__value == 0) || (__value - __value != __value - __value)))
+    return {__end, std::errc::result_out_of_range};
+  x = __value;
+  return {__end, std::errc()};
+}
+
+__parse_result __parse_mpfr(const char *first, const char *last, mpfr_ptr x,
+                            mpfr_rnd_t rnd) {
+  const char *__end = __scan_float(first, last);
+  if (__end == first)
+    return {first, std::errc::invalid_argument};
+  floatmp_scratch_pool::lease __result(mpfr_get_prec(x));
+  __parse_cstring(first, __end, [&](const char *s) {
+    mpfr_strtofr(__result, s, nullptr, 10, rnd);
+  });
+  if (mpfr_inf_p(__result) &&
+      !__starts_with(first + (*first == '-'), __end, "inf"))
+    return {__end, std::errc::result_out_of_range};
+  mpfr_set(x, __result, MPFR_RNDN); // exact
+  return {__end, std::errc()};
+}
+} // namespace
+
+template <>
+system::from_chars_result system::from_chars(const char *first,
+                                             const char *last, bool &x) {
+  // the words are case insensitive, as in from_string()
+  const char *__words[] = {"false", "true"};
+  for (bool __value : {false, true}) {
+    const char *__word = __words[__value];
+    if (__starts_with(first, last, __word)) {
+      x = __value;
+      return {first + std::strlen(__word), std::errc()};
+    }
+  }
+  if ((first != last) && ((*first == '0') || (*first == '1'))) {
+    x = (*first == '1');
+    return {first + 1, std::errc()};
+  }
+  return {first, std::errc::invalid_argument};
+}
+
+#define __TEUTHID_SIGNED_INTEGER_FROM_CHARS(TYPE, UTYPE)                       \
+  template <>                                                                  \
+  system::from_chars_result system::from_chars(const char *first,              \
+                                               const char *last, TYPE &x) {    \
+    return __parse_signed<TYPE, UTYPE>(first, last, x);                        \
+  }
+__TEUTHID_SIGNED_INTEGER_FROM_CHARS(int8_t, uint8_t);
+__TEUTHID_SIGNED_INTEGER_FROM_CHARS(int16_t, uint16_t);
+__TEUTHID_SIGNED_INTEGER_FROM_CHARS(int32_t, uint32_t);
+__TEUTHID_SIGNED_INTEGER_FROM_CHARS(int64_t, uint64_t);
+#ifdef TEUTHID_HAVE_INT_128
+__TEUTHID_SIGNED_INTEGER_FROM_CHARS(int128_t, uint128_t);
+#endif // TEUTHID_HAVE_INT_128
+#undef __TEUTHID_SIGNED_INTEGER_FROM_CHARS
+
+#define __TEUTHID_UNSIGNED_INTEGER_FROM_CHARS(TYPE)                            \
+  template <>                                                                  \
+  system::from_chars_result system::from_chars(const char *first,              \
+                                               const char *last, TYPE &x) {    \
+    return __parse_unsigned(first, last, x, static_cast<TYPE>(~TYPE(0)));      \
+  }
+__TEUTHID_UNSIGNED_INTEGER_FROM_CHARS(uint8_t);
+__TEUTHID_UNSIGNED_INTEGER_FROM_CHARS(uint16_t);
+__TEUTHID_UNSIGNED_INTEGER_FROM_CHARS(uint32_t);
+__TEUTHID_UNSIGNED_INTEGER_FROM_CHARS(uint64_t);
+#ifdef TEUTHID_HAVE_INT_128
+__TEUTHID_UNSIGNED_INTEGER_FROM_CHARS(uint128_t);
+#endif // TEUTHID_HAVE_INT_128
+#undef __TEUTHID_UNSIGNED_INTEGER_FROM_CHARS
+
+#define __TEUTHID_FLOAT_FROM_CHARS(TYPE)                                       \
+  template <>                                                                  \
+  system::from_chars_result system::from_chars(const char *first,              \
+                                               const char *last, TYPE &x) {    \
+    return __parse_float(first, last, x);                                      \
+  }
+__TEUTHID_FLOAT_FROM_CHARS(float);
+__TEUTHID_FLOAT_FROM_CHARS(double);
+__TEUTHID_FLOAT_FROM_CHARS(long double);
+#ifdef TEUTHID_HAVE_QUADMATH
+__TEUTHID_FLOAT_FROM_CHARS(__float128);
+#endif // TEUTHID_HAVE_QUADMATH
+#undef __TEUTHID_FLOAT_FROM_CHARS
+
+template <>
+system::from_chars_result system::from_chars(const char *first,
+                                             const char *last, mpfr_t &x) {
+  return __parse_mpfr(first, last, x, mpfr_get_default_rounding_mode());
+}
+
+template <>
+system::from_chars_result system::from_chars(const char *first,
+                                             const char *last,
+                                             floatmp_base &x) {
+  return __parse_mpfr(first, last, x.value_,
+                      static_cast<mpfr_rnd_t>(floatmp_base::rounding_mode()));
+}
+
+namespace {
+// the operations of the floating point types needed by the comparisons
+template <typename T> struct __float_traits {
+  static constexpr int digits = std::numeric_limits<T>::digits;
+  static constexpr int min_exponent = std::numeric_limits<T>::min_exponent;
+  static T abs(T x) noexcept { return std::fabs(x); }
+  static bool is_finite(T x) noexcept {
+    return (std::fabs(x) <= std::numeric_limits<T>::max());
+  }
+  static int exponent(T x) noexcept {
+    int __e;
+    std::frexp(x, &__e);
+    return __e;
+  }
+  static T scale(T x, int e) noexcept { return std::ldexp(x, e); }
+};
+
+#ifdef TEUTHID_HAVE_QUADMATH
+template <> struct __float_traits<__float128> {
+  static constexpr int digits = FLT128_MANT_DIG;
+  static constexpr int min_exponent = FLT128_MIN_EXP;
+  static __float128 abs(__float128 x) noexcept { return fabsq(x); }
+  static bool is_finite(__float128 x) noexcept { return (finiteq(x) != 0); }
+  static int exponent(__float128 x) noexcept {
+    int __e;
+    frexpq(x, &__e);
+    return __e;
+  }
+  static __float128 scale(__float128 x, int e) noexcept {
+    return ldexpq(x, e);
+  }
+};
+#endif // TEUTHID_HAVE_QUADMATH
+
+// the absolute and relative tests of finite values; they are free of branches,
+// so the loops over arrays can be vectorized
+template <typename T>
+inline bool __close_to(T x, T y, T absolute, T relative) noexcept {
+  typedef __float_traits<T> __traits;
+  T __ax = __traits::abs(x), __ay = __traits::abs(y);
+  T __max = (__ax > __ay) ? __ax : __ay;
+  T __d = __traits::abs(x - y);
+  return __traits::is_finite(__max) &
+         ((__d <= absolute) | (__d <= relative * __max));
+}
+
+// |x - y| <= ulps * 2^(exp - digits), the ulp of the larger value
+template <typename T> bool __close_in_ulps(T x, T y, uint64_t ulps) noexcept {
+  typedef __float_traits<T> __traits;
+  T __max = std::max(__traits::abs(x), __traits::abs(y));
+  if ((ulps == 0) || !__traits::is_finite(__max))
+    return false;
+  int __exp = __traits::exponent(__max);
+  if (__exp < __traits::min_exponent) // subnormal values
+    __exp = __traits::min_exponent;
+  T __d = __traits::scale(__traits::abs(x - y), __traits::digits - __exp);
+  return (__d <= static_cast<T>(ulps));
+}
+
+template <typename T>
+bool __is_close(T x, T y, const system::float_tolerance &tolerance) noexcept {
+  return __close_to(x, y, static_cast<T>(tolerance.absolute),
+                    static_cast<T>(tolerance.relative)) ||
+         __close_in_ulps(x, y, tolerance.ulps);
+}
+
+// the loop of the absolute and relative tests, compiled into each variant of
+// the kernel for its instruction set
+template <typename T>
+inline __attribute__((always_inline)) std::size_t
+__count_close_to(const T *x, const T *y, std::size_t n, T absolute,
+                 T relative) noexcept {
+  std::size_t __count = 0;
+  for (std::size_t __i = 0; __i < n; ++__i)
+    __count += __close_to(x[__i], y[__i], absolute, relative);
+  return __count;
+}
+
+template <typename T>
+std::size_t __count_close_generic(const T *x, const T *y, std::size_t n,
+                                  T absolute, T relative) noexcept {
+  return __count_close_to(x, y, n, absolute, relative);
 }
 
-#define __TEUTHID_FLOAT_LESS_THAN(TYPE)                                        \
+#ifdef TEUTHID_HAVE_FUNCTION_TARGETS
+template <typename T>
+__attribute__((target("avx2,fma"))) std::size_t
+__count_close_avx2(const T *x, const T *y, std::size_t n, T absolute,
+                   T relative) noexcept {
+  return __count_close_to(x, y, n, absolute, relative);
+}
+
+template <typename T>
+__attribute__((target("avx512f,avx512dq"))) std::size_t
+__count_close_avx512(const T *x, const T *y, std::size_t n, T absolute,
+                     T relative) noexcept {
+  return __count_close_to(x, y, n, absolute, relative);
+}
+#endif // TEUTHID_HAVE_FUNCTION_TARGETS
+
+template <typename T>
+using __count_close_kernel = std::size_t (*)(const T *, const T *,
+                                             std::size_t, T, T);
+
+// the best variant for the CPU; the vector variants are used for float and
+// double only
+template <typename T> __count_close_kernel<T> __select_count_close() noexcept {
+#ifdef TEUTHID_HAVE_FUNCTION_TARGETS
+  if (std::is_same<T, float>::value || std::is_same<T, double>::value) {
+    if (system::has_cpu_feature(cpu_feature_t::avx512f) &&
+        system::has_cpu_feature(cpu_feature_t::avx512dq))
+      return __count_close_avx512<T>;
+    if (system::has_cpu_feature(cpu_feature_t::avx2) &&
+        system::has_cpu_feature(cpu_feature_t::fma))
+      return __count_close_avx2<T>;
+  }
+#endif // TEUTHID_HAVE_FUNCTION_TARGETS
+  return __count_close_generic<T>;
+}
+
+template <typename T>
+std::size_t __count_close(const T *x, const T *y, std::size_t n,
+                          const system::float_tolerance &tolerance) noexcept {
+  static const __count_close_kernel<T> __kernel = __select_count_close<T>();
+  T __absolute = static_cast<T>(tolerance.absolute);
+  T __relative = static_cast<T>(tolerance.relative);
+  std::size_t __count = __kernel(x, y, n, __absolute, __relative);
+  if ((tolerance.ulps != 0) && (__count != n))
+    for (std::size_t __i = 0; __i < n; ++__i)
+      if (!__close_to(x[__i], y[__i], __absolute, __relative) &&
+          __close_in_ulps(x[__i], y[__i], tolerance.ulps))
+        ++__count;
+  return __count;
+}
+
+// the arrays are tested in blocks, so a difference stops the test early
+template <typename T>
+bool __all_close(const T *x, const T *y, std::size_t n,
+                 const system::float_tolerance &tolerance) noexcept {
+  constexpr std::size_t __block_size = 256;
+  for (std::size_t __i = 0; __i < n; __i += __block_size) {
+    std::size_t __k = std::min(__block_size, n - __i);
+    if (__count_close(x + __i, y + __i, __k, tolerance) != __k)
+      return false;
+  }
+  return true;
+}
+} // namespace
+
+constexpr long double system::default_comparison_absolute_;
+thread_local system::float_tolerance system::comparison_tolerance_ =
+    system::default_comparison_tolerance();
+
+system::float_tolerance
+system::comparison_tolerance(const float_tolerance &tolerance) {
+  assert((tolerance.absolute >= 0) && (tolerance.relative >= 0));
+  float_tolerance __prev = comparison_tolerance_;
+  comparison_tolerance_ = tolerance;
+  return __prev;
+}
+
+#define __TEUTHID_FLOAT_COMPARISON(TYPE)                                       \
+  template <>                                                                  \
+  bool system::is_close(const TYPE &x, const TYPE &y,                          \
+                        const float_tolerance &tolerance) {                    \
+    return __is_close(x, y, tolerance);                                        \
+  }                                                                            \
+  template <>                                                                  \
+  bool system::all_close(const TYPE *x, const TYPE *y, std::size_t n,          \
+                         const float_tolerance &tolerance) {                   \
+    return __all_close(x, y, n, tolerance);                                    \
+  }                                                                            \
+  template <>                                                                  \
+  std::size_t system::count_equal(const TYPE *x, const TYPE *y, std::size_t n, \
+                                  const float_tolerance &tolerance) {          \
+    return __count_close(x, y, n, tolerance);                                  \
+  }                                                                            \
+  template <> bool system::equal_to(const TYPE &x, const TYPE &y) {            \
+    return (x == y) || __is_close(x, y, system::comparison_tolerance_);        \
+  }                                                                            \
   template <> bool system::less_than(const TYPE &x, const TYPE &y) {           \
-    if (std::isfinite(x) && std::isfinite(y))                                  \
-      if (system::to_string(x).compare(system::to_string(y)) != 0)             \
-        return (x < y);                                                        \
-    return false;                                                              \
+    return (x < y) && __float_traits<TYPE>::is_finite(x) &&                    \
+           __float_traits<TYPE>::is_finite(y) &&                              \
+           !__is_close(x, y, system::comparison_tolerance_);                   \
   }
-__TEUTHID_FLOAT_LESS_THAN(float);
-__TEUTHID_FLOAT_LESS_THAN(double);
-__TEUTHID_FLOAT_LESS_THAN(long double);
-#undef __TEUTHID_FLOAT_LESS_THAN
+__TEUTHID_FLOAT_COMPARISON(float);
+__TEUTHID_FLOAT_COMPARISON(double);
+__TEUTHID_FLOAT_COMPARISON(long double);
+#ifdef TEUTHID_HAVE_QUADMATH
+__TEUTHID_FLOAT_COMPARISON(__float128);
+#endif // TEUTHID_HAVE_QUADMATH
+#undef __TEUTHID_FLOAT_COMPARISON
+
+template <>
+bool system::is_close(const mpfr_t &x, const mpfr_t &y,
+                      const float_tolerance &tolerance) {
+  if ((mpfr_number_p(x) == 0) || (mpfr_number_p(y) == 0))
+    return false;
+  if (mpfr_equal_p(x, y) != 0)
+    return true;
+  // the difference needs only a few bits to be compared with the tolerances
+  MPFR_DECL_INIT(__d, 64);
+  mpfr_sub(__d, x, y, MPFR_RNDN);
+  mpfr_abs(__d, __d, MPFR_RNDN);
+  if (mpfr_cmp_ld(__d, tolerance.absolute) <= 0)
+    return true;
+  mpfr_srcptr __max = (mpfr_cmpabs(x, y) >= 0) ? x : y;
+  MPFR_DECL_INIT(__r, 64);
+  mpfr_set_ld(__r, tolerance.relative, MPFR_RNDN);
+  mpfr_mul(__r, __r, __max, MPFR_RNDN);
+  mpfr_abs(__r, __r, MPFR_RNDN);
+  if (mpfr_cmp(__d, __r) <= 0)
+    return true;
+  if (tolerance.ulps == 0)
+    return false;
+  // |x - y| <= ulps * 2^(exp - prec), the ulp of the larger value
+  mpfr_prec_t __prec = std::min(mpfr_get_prec(x), mpfr_get_prec(y));
+  mpfr_mul_2si(__d, __d, __prec - mpfr_get_exp(__max), MPFR_RNDN);
+  return (mpfr_cmp_ld(__d, static_cast<long double>(tolerance.ulps)) <= 0);
+}
+
+template <> bool system::equal_to(const mpfr_t &x, const mpfr_t &y) {
+  return (mpfr_equal_p(x, y) != 0) ||
+         system::is_close(x, y, system::comparison_tolerance_);
+}
 
 template <> bool system::less_than(const mpfr_t &x, const mpfr_t &y) {
-  if ((mpfr_number_p(x) != 0) && (mpfr_number_p(y) != 0))
-    if (system::to_string(x).compare(system::to_string(y)) != 0)
-      return (mpfr_less_p(x, y) != 0);
-  return false;
+  return (mpfr_less_p(x, y) != 0) && (mpfr_number_p(x) != 0) &&
+         (mpfr_number_p(y) != 0) &&
+         !system::is_close(x, y, system::comparison_tolerance_);
 }
 
 #endif // DOXYGEN_SHOULD_SKIP_THIS
@@ -0,0 +1,114 @@
+/*
+  This file is part of the Teuthid project.
+  Copyright (c) 2016-2017 Mariusz Przygodzki (mariusz.przygodzki@gmail.com)
+
+  The Teuthid is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or (at your
+  option) any later version.
+
+  The Teuthid is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+  FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+  for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with the Teuthid; see the file LICENSE.LGPLv3.  If not, see
+  <http://www.gnu.org/licenses/>.
+*/
+
+#define BOOST_TEST_MODULE teuthid
+#define BOOST_TEST_DYN_LINK
+
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+
+#include <boost/test/unit_test.hpp>
+#include <teuthid/dataset.hpp>
+
+using namespace teuthid;
+
+void __write_file(const char *path, const std::string &text) {
+  std::ofstream __file(path, std::ios::binary);
+  __file << text;
+}
+
+BOOST_AUTO_TEST_CASE(class_teuthid_dataset) {
+  const char *__path = "class_dataset.csv";
+
+  __write_file(__path, "x, y ,z\r\n1,2.5,-3\r\n\r\n 0.1 ,1e3,4\n");
+  dataset_format __format;
+  __format.header = true;
+  dataset<double> __d1(__path, __format);
+  BOOST_TEST((__d1.rows() == 2), "dataset::rows()");
+  BOOST_TEST((__d1.columns() == 3), "dataset::columns()");
+  BOOST_TEST((__d1.names()[1] == "y"), "dataset::names()");
+  BOOST_TEST((__d1.column(0)[1] == 0.1), "dataset::column()");
+  BOOST_TEST((__d1[1][1] == 1000), "dataset::operator[]");
+  BOOST_TEST((__d1[2][0] == -3), "dataset::operator[]");
+  BOOST_TEST((__d1.bytes() == 33), "dataset::bytes()");
+  BOOST_CHECK_THROW(__d1.column(3), std::out_of_range);
+
+  __write_file(__path, "1\t0.5\n2\t0.25");
+  __format.delimiter = '\t';
+  __format.header = false;
+  dataset<floatmp<100>> __d2(__path, __format);
+  BOOST_TEST((__d2.rows() == 2), "dataset::rows()");
+  BOOST_TEST((__d2[1].get(1) == 0.25), "dataset<floatmp>");
+  BOOST_TEST(__d2.names().empty(), "dataset::names()");
+
+  // errors report the row and the column
+  __format.delimiter = ',';
+  __write_file(__path, "1,2\n3,x\n");
+  BOOST_CHECK_THROW(dataset<float>(__path, __format), std::runtime_error);
+  __write_file(__path, "1,2\n3\n");
+  BOOST_CHECK_THROW(dataset<float>(__path, __format), std::runtime_error);
+  __write_file(__path, "1,2\n3,4,\n");
+  BOOST_CHECK_THROW(dataset<float>(__path, __format), std::runtime_error);
+  try {
+    __write_file(__path, "1,2\n3,4\n5,6e999\n");
+    dataset<float> __d3(__path, __format);
+  } catch (const std::runtime_error &e) {
+    BOOST_TEST((std::string(e.what()) == "invalid value in row 2, column 1"),
+               "dataset");
+  }
+
+  // large files are parsed in parallel
+  std::string __text;
+  for (int __i = 0; __i < 200000; ++__i)
+    __text += std::to_string(__i) + "," + std::to_string(__i * 0.5) + "\n";
+  __write_file(__path, __text);
+  __format.threads = 4;
+  dataset<float> __d4(__path, __format);
+  BOOST_TEST((__d4.rows() == 200000), "dataset::rows()");
+  bool __equal = true;
+  for (int __i = 0; __i < 200000; ++__i)
+    __equal = __equal && (__d4[0][__i] == __i) && (__d4[1][__i] == __i * 0.5f);
+  BOOST_TEST(__equal, "dataset");
+  BOOST_TEST((__d4.megabytes_per_second() > 0),
+             "dataset::megabytes_per_second()");
+
+  // the workers (a chunk per 1 MiB) round as the calling thread
+  __text.clear();
+  for (int __i = 0; __i < 800000; ++__i)
+    __text += "0.7\n";
+  __write_file(__path, __text);
+  {
+    floatmp_base::rounding_scope __scope(
+        floatmp_round_t::round_toward_infinity);
+    dataset<floatmp<24>> __d6(__path, __format);
+    floatmp<24> __up;
+    system::from_string("0.7", __up);
+    __equal = (__up > 0.7); // to nearest, 0.7 is rounded down
+    for (std::size_t __i = 0; __i < __d6.rows(); ++__i)
+      __equal = __equal && (__d6[0].get(__i) == __up);
+    BOOST_TEST(__equal, "dataset<floatmp>");
+  }
+
+  __write_file(__path, "");
+  dataset<double> __d5(__path);
+  BOOST_TEST(((__d5.rows() == 0) && (__d5.columns() == 0)), "dataset");
+  std::remove(__path);
+  BOOST_CHECK_THROW(dataset<double>{__path}, std::runtime_error);
+}
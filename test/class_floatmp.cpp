@@ -20,6 +20,11 @@
 #define BOOST_TEST_MODULE teuthid
 #define BOOST_TEST_DYN_LINK
 
+#include <algorithm>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
 #include <boost/test/unit_test.hpp>
 #include <teuthid/floatmp.hpp>
 #include <teuthid/system.hpp>
@@ -32,12 +37,26 @@
 
 using namespace teuthid;
 
+static std::size_t __mp_allocations = 0;
+static void *__mp_alloc(std::size_t n) {
+  ++__mp_allocations;
+  return std::malloc(n);
+}
+static void *__mp_realloc(void *p, std::size_t, std::size_t n) {
+  ++__mp_allocations;
+  return std::realloc(p, n);
+}
+static void __mp_free(void *p, std::size_t) { std::free(p); }
+
 BOOST_AUTO_TEST_CASE(class_teuthid_floatmp) {
   float256_t __x1;
   floatmp<500> __x2;
   floatmp<100> __x3;
   float __x4;
 
+  // values are compared at the print precision of system::to_string()
+  floatmp_base::comparison_scope __comparison(
+      floatmp_comparison_t::decimals, system::default_format_float_precision());
   BOOST_TEST(system::is_floatmp(__x2), "system::is_floatmp()");
   BOOST_TEST(!system::is_floatmp(__x4), "system::is_floatmp()");
   BOOST_TEST(system::is_floating_point(__x2), "system::is_floating_point()");
@@ -135,6 +154,36 @@ BOOST_AUTO_TEST_CASE(class_teuthid_floatmp) {
   BOOST_TEST((float256_t::zero() == 0), "floatmp::zero()");
   BOOST_TEST((float256_t::minus_one() == -1), "floatmp::minus_one()");
   BOOST_TEST((float256_t::plus_one() == 1), "floatmp::plus_one()");
+  BOOST_TEST((&float256_t::plus_one() == &float256_t::plus_one()),
+             "floatmp::plus_one()");
+  float256_t __c;
+  __c = 1, __c.nextabove(__c), __c -= 1;
+  BOOST_TEST(
+      float256_t::epsilon().equal_to(__c, floatmp_comparison_t::exact, 0),
+      "floatmp::epsilon()");
+  __c.nextbelow(float256_t::min());
+  BOOST_TEST(__c.is_zero(), "floatmp::min()");
+  __c.nextabove(float256_t::max());
+  BOOST_TEST(__c.is_infinite(), "floatmp::max()");
+  __c = -1, __c.acos(__c);
+  BOOST_TEST(float256_t::pi().equal_to(__c, floatmp_comparison_t::exact, 0),
+             "floatmp::pi()");
+  __c = 2, __c.log(__c);
+  BOOST_TEST(float256_t::ln2().equal_to(__c, floatmp_comparison_t::exact, 0),
+             "floatmp::ln2()");
+  __c = 1, __c.exp(__c);
+  BOOST_TEST(float256_t::e().equal_to(__c, floatmp_comparison_t::exact, 0),
+             "floatmp::e()");
+  {
+    floatmp_base::rounding_scope __scope(floatmp_round_t::round_toward_zero);
+    floatmp<300> __pi;
+    __pi.acos(floatmp<300>(-1));
+    floatmp_base::rounding_scope __inner(floatmp_round_t::round_to_nearest);
+    floatmp<300> __pi_n;
+    __pi_n.acos(floatmp<300>(-1));
+    BOOST_TEST(((floatmp<300>::pi() == __pi_n) && (__pi <= __pi_n)),
+               "floatmp::pi()");
+  }
 
   __x1 = 1.0, __x2 = 2.0, __x3 = 3.0;
   BOOST_TEST(!__x1.is_zero(), "is_zero()");
@@ -443,7 +492,7 @@ BOOST_AUTO_TEST_CASE(class_teuthid_floatmp) {
   BOOST_TEST((__x3.nextabove(__x1) >= __x1), "nextabove()");
   BOOST_TEST((system::nextabove(__x1) >= __x1), "system::nextabove()");
   BOOST_TEST((__x3.nextbelow(__x1) <= __x1), "nextbelow()");
-  BOOST_TEST((system::nextbelow(__x1) >= __x1), "system::nextbelow()");
+  BOOST_TEST((system::nextbelow(__x1) <= __x1), "system::nextbelow()");
 
 #ifdef TEUTHID_HAVE_INT_128
   __x1 = TO_INT128(INT64_MAX) * 10, __x2 = TO_INT128(INT64_MAX) * 10;
@@ -485,4 +534,499 @@ BOOST_AUTO_TEST_CASE(class_teuthid_floatmp) {
   __x3 += __x2;
   BOOST_TEST(__x2.less_than(__x3), "less_than()");
 #endif // TEUTHID_HAVE_INT_128
-}
\ No newline at end of file
+}
+BOOST_AUTO_TEST_CASE(class_teuthid_floatmp_comparison) {
+  floatmp<200> __x1 = 1, __x2, __x3;
+  floatmp<100> __y1;
+
+  BOOST_TEST((floatmp_base::comparison_mode() == floatmp_comparison_t::exact),
+             "comparison_mode()");
+  __x2 = __x1, __x2.nextabove(__x2);
+  BOOST_TEST(!__x1.equal_to(__x2), "equal_to()");
+  BOOST_TEST(__x1.less_than(__x2), "less_than()");
+  BOOST_TEST(__x1.equal_to(__x2, floatmp_comparison_t::ulps, 1), "ulps");
+  __x3 = __x2, __x3.nextabove(__x3), __x3.nextabove(__x3);
+  BOOST_TEST(!__x1.equal_to(__x3, floatmp_comparison_t::ulps, 2), "ulps");
+  BOOST_TEST(__x1.equal_to(__x3, floatmp_comparison_t::ulps, 3), "ulps");
+  __y1 = __x2; // rounded to 100 bits
+  BOOST_TEST(__y1.equal_to(__x1), "equal_to()");
+  __x2 = 1.00000000004, __x3 = 1.00000000006;
+  BOOST_TEST(__x1.equal_to(__x2, floatmp_comparison_t::decimals, 10),
+             "decimals");
+  BOOST_TEST(!__x1.equal_to(__x3, floatmp_comparison_t::decimals, 10),
+             "decimals");
+  BOOST_TEST(__x1.equal_to(__x3, floatmp_comparison_t::decimals, 9),
+             "decimals");
+
+  BOOST_TEST((floatmp_base::comparison_mode(floatmp_comparison_t::ulps, 4) ==
+              floatmp_comparison_t::exact),
+             "comparison_mode()");
+  BOOST_TEST((floatmp_base::comparison_tolerance() == 4),
+             "comparison_tolerance()");
+  __x2 = __x1, __x2.nextbelow(__x2);
+  BOOST_TEST((__x1 == __x2), "operator==");
+  BOOST_TEST(!(__x2 < __x1), "operator<");
+  floatmp_base::comparison_mode(floatmp_comparison_t::exact);
+  BOOST_TEST((__x1 != __x2), "operator!=");
+  BOOST_TEST((__x2 < __x1), "operator<");
+  {
+    floatmp_base::comparison_scope __scope(floatmp_comparison_t::ulps, 1);
+    BOOST_TEST((__scope.previous() == floatmp_comparison_t::exact),
+               "comparison_scope");
+    BOOST_TEST((__scope.previous_tolerance() == 0), "comparison_scope");
+    BOOST_TEST((__x1 == __x2), "comparison_scope");
+    // the mode and the tolerance are per thread
+    bool __other = false;
+    std::thread __th([&]() {
+      __other = (floatmp_base::comparison_mode() ==
+                 floatmp_comparison_t::exact) &&
+                (floatmp_base::comparison_tolerance() == 0) && (__x1 != __x2);
+    });
+    __th.join();
+    BOOST_TEST(__other, "comparison_scope");
+  }
+  BOOST_TEST(((floatmp_base::comparison_mode() ==
+               floatmp_comparison_t::exact) &&
+              (floatmp_base::comparison_tolerance() == 0)),
+             "comparison_scope");
+  BOOST_TEST((__x1 != __x2), "comparison_scope");
+
+  __x1 = floatmp<200>::nan();
+  BOOST_TEST(!(__x1 == __x1), "NaN");
+  BOOST_TEST((!__x1.is_zero() && !__x1.is_negative() && !__x1.is_positive()),
+             "NaN");
+  __x1 = -floatmp<200>::infinity();
+  BOOST_TEST(((__x1 == __x1) && __x1.is_negative()), "infinity");
+  __x1 = 0, __x1 = -__x1;
+  BOOST_TEST((__x1.is_zero() && !__x1.is_negative() && !__x1.is_positive()),
+             "is_zero()");
+  BOOST_TEST((__x1 == 0), "operator==");
+
+  // comparisons with built-in values are exact
+  floatmp<24> __z1 = 16777216; // 2^24
+  BOOST_TEST((__z1 != 16777217), "operator!=(int)");
+  BOOST_TEST((__z1 < 16777217), "operator<(int)");
+  BOOST_TEST((16777217 > __z1), "operator>(int)");
+  BOOST_TEST((__z1 == 16777216.0f), "operator==(float)");
+  BOOST_TEST((__z1 < 16777216.5L), "operator<(long double)");
+  BOOST_TEST((UINT64_MAX > __z1), "operator>(uint64_t)");
+  BOOST_TEST(!(__z1 == std::numeric_limits<double>::quiet_NaN()), "NaN");
+  BOOST_TEST(!(__z1 < std::numeric_limits<double>::quiet_NaN()), "NaN");
+  BOOST_TEST(!(std::numeric_limits<double>::quiet_NaN() < __z1), "NaN");
+#ifdef TEUTHID_HAVE_INT_128
+  floatmp<128> __z2 = 1;
+  __z2 *= TO_INT128(INT64_MAX), __z2 *= 4, __z2 += 1;
+  BOOST_TEST((__z2 == TO_INT128(INT64_MAX) * 4 + 1), "operator==(int128_t)");
+  BOOST_TEST((__z2 != TO_INT128(INT64_MAX) * 4), "operator!=(int128_t)");
+  BOOST_TEST((__z2 < TO_UINT128(INT64_MAX) * 4 + 2), "operator<(uint128_t)");
+  __z2 = -__z2;
+  BOOST_TEST((__z2 == TO_INT128(INT64_MIN) * 4 + 3), "operator==(int128_t)");
+  BOOST_TEST((TO_INT128(INT64_MIN) * 4 < __z2), "operator<(int128_t)");
+
+  // the conversions and the arithmetic are exact above 64 bits
+  uint128_t __u = (TO_UINT128(UINT64_MAX) << 64) | 1;
+  int128_t __i = -((TO_INT128(1) << 100) + 7);
+  floatmp<200> __z3 = __u, __z4(__i), __z5;
+  __z5 = __z3, __z5 -= TO_UINT128(UINT64_MAX) << 64;
+  BOOST_TEST((__z5 == 1), "floatmp(uint128_t)");
+  __z5 = __z4, __z5 += TO_INT128(1) << 100;
+  BOOST_TEST((__z5 == -7), "floatmp(int128_t)");
+  __z5.assign(__i), __z5 *= __i, __z5 /= __i;
+  BOOST_TEST((__z5 == __i), "mul(int128_t), div(int128_t)");
+  __z5 = __z4 - __i + __u;
+  BOOST_TEST((__z5 == __u), "floatmp_expr");
+  __z5 = 0, __z5 += TO_INT128(0);
+  BOOST_TEST(__z5.is_zero(), "add(int128_t)");
+  // only the final result is rounded
+  floatmp_rounded<64, floatmp_round_t::round_toward_zero> __z6 = __u;
+  floatmp_rounded<64, floatmp_round_t::round_toward_infinity> __z7 = __u;
+  BOOST_TEST((__z6 < __u), "floatmp(uint128_t)");
+  BOOST_TEST((__z7 > __u), "floatmp(uint128_t)");
+  __z6.nextabove(__z6);
+  BOOST_TEST((__z6 == __z7), "floatmp(uint128_t)");
+#endif // TEUTHID_HAVE_INT_128
+}
+
+BOOST_AUTO_TEST_CASE(class_teuthid_floatmp_expr) {
+  floatmp<200> __x1 = 1.25, __x2 = -3.5, __x3 = 0.75, __r;
+  floatmp<100> __y1 = 2.5;
+  floatmp<300> __z1;
+
+  // fused patterns match explicit fma()
+  __r = __x1 * __x2 + __x3;
+  BOOST_TEST((__r == floatmp<200>().fma(__x1, __x2, __x3)), "x*y+z");
+  __r = __x3 + __x1 * __x2;
+  BOOST_TEST((__r == floatmp<200>().fma(__x1, __x2, __x3)), "z+x*y");
+  __r = __x1 * __x2 - __x3;
+  BOOST_TEST((__r == -5.125), "x*y-z");
+  __r = __x3 - __x1 * __x2;
+  BOOST_TEST((__r == 5.125), "z-x*y");
+  __r = __x1 * __x2 + __x3 * __x1;
+  BOOST_TEST((__r == -3.4375), "x*y+z*t");
+  __r = __x1 * __x2 - __x3 * __x1;
+  BOOST_TEST((__r == -5.3125), "x*y-z*t");
+
+  // destination appearing inside the expression
+  __r = 2;
+  __r = __r * __x2 + __r;
+  BOOST_TEST((__r == -5), "aliasing");
+  __r = 2;
+  __r = (__r + __x1) * (__r - __x3);
+  BOOST_TEST((__r == 4.0625), "aliasing");
+  __r = 2;
+  __r += __x1 * __x2;
+  BOOST_TEST((__r == -2.375), "operator+=");
+  __r -= __x1 * __x2;
+  BOOST_TEST((__r == 2), "operator-=");
+  __r *= __x1 + __x3;
+  BOOST_TEST((__r == 4), "operator*=");
+  __r /= __x1 - __x3;
+  BOOST_TEST((__r == 8), "operator/=");
+
+  // mixed operands and precisions
+  __r = 2 * __x1 + 1u - __x2 / 0.5;
+  BOOST_TEST((__r == 10.5), "scalars");
+  __r = 1.0L - __x1 * 4;
+  BOOST_TEST((__r == -4), "long double");
+  BOOST_TEST(((__x1 + __y1).precision() == 200), "precision()");
+  BOOST_TEST(((__y1 * __z1 - 1).precision() == 300), "precision()");
+  BOOST_TEST((decltype(__x1 + __z1)::precision() == 300), "precision()");
+  __z1 = -(__y1 + __x1);
+  BOOST_TEST((__z1 == -3.75), "operator-");
+  BOOST_TEST(((__x1 + __x3) == 2), "operator==");
+  BOOST_TEST((2 < (__x1 + __x3 + __x3)), "operator<");
+  BOOST_TEST((std::sqrt(__x3 * 12) == 3), "std::sqrt()");
+  BOOST_TEST((system::to_string(__x1 + __x3) == system::to_string(__x1 + 0.75)),
+             "system::to_string()");
+}
+
+BOOST_AUTO_TEST_CASE(class_teuthid_floatmp_storage) {
+  void *(*__alloc)(std::size_t);
+  void *(*__realloc)(void *, std::size_t, std::size_t);
+  void (*__free)(void *, std::size_t);
+  std::size_t __allocations;
+
+  mp_get_memory_functions(&__alloc, &__realloc, &__free);
+  mp_set_memory_functions(__mp_alloc, __mp_realloc, __mp_free);
+  {
+    __mp_allocations = 0;
+    std::vector<float256_t> __v(1000, 1.5);
+    float256_t __sum;
+    for (const auto &__x : __v)
+      __sum += __x;
+    __v.push_back(__sum);
+    floatmp<TEUTHID_FLOATMP_MAX_INLINE_PRECISION> __x1(__sum), __x2(__x1);
+    bool __cmp = (__x1 == __x2) && (__sum > 1499) && (1501.0 > __sum) &&
+                 !__sum.is_negative() && (__sum != 1500.5L);
+    __allocations = __mp_allocations;
+    BOOST_TEST(__cmp, "comparisons");
+    BOOST_TEST((__allocations == 0), "inline limbs");
+    BOOST_TEST((__v.back() == 1500), "inline limbs");
+    BOOST_TEST((__x1 == __x2), "inline limbs");
+  }
+  {
+    __mp_allocations = 0;
+    floatmp<TEUTHID_FLOATMP_MAX_INLINE_PRECISION + 1> __x1 = 2.5, __x2(__x1);
+    __allocations = __mp_allocations;
+    BOOST_TEST((__allocations == 2), "heap limbs");
+    BOOST_TEST((__x1 == __x2), "heap limbs");
+  }
+  {
+    typedef floatmp<TEUTHID_FLOATMP_MAX_INLINE_PRECISION + 1> __float_t;
+    std::vector<__float_t> __v;
+    for (int __i = 0; __i < 100; __i++)
+      __v.emplace_back((__i * 37) % 100);
+    __float_t __x1 = 1, __x2 = 2;
+    __v.reserve(__v.capacity() + 1);
+    std::sort(__v.begin(), __v.end(),
+              [](const __float_t &__a, const __float_t &__b) {
+                return (mpfr_less_p(__a.c_mpfr(), __b.c_mpfr()) != 0);
+              });
+    __mp_allocations = 0;
+    __x1.swap(__x2);
+    std::swap(__x1, __x2);
+    __float_t __x3(std::move(__x1));
+    __x1 = std::move(__x2);
+    __allocations = __mp_allocations;
+    BOOST_TEST((__allocations == 0), "move semantics");
+    BOOST_TEST(std::is_sorted(__v.begin(), __v.end()), "std::sort()");
+    BOOST_TEST(((__v.front() == 0) && (__v.back() == 99)), "std::sort()");
+    BOOST_TEST(((__x1 == 2) && (__x3 == 1)), "operator=(&&)");
+    // a moved-from value may only be assigned to or destroyed
+    __x2 = 3;
+    BOOST_TEST((__x2 == 3), "operator=()");
+    __float_t __x4(std::move(__x2));
+    __x2.assign(__x4 / 2);
+    BOOST_TEST((__x2 == 1.5), "assign()");
+    // the results of the mathematical functions are not copied
+    __mp_allocations = 0;
+    __x4 = std::abs(__x3);
+    __allocations = __mp_allocations;
+    BOOST_TEST((__allocations == 1), "std::abs()");
+    __mp_allocations = 0;
+    __float_t __x5 = std::fmax(__x3, __x4);
+    __allocations = __mp_allocations;
+    BOOST_TEST(((__allocations == 1) && (__x5 == 1)), "std::fmax()");
+  }
+  {
+    float256_t __x1 = 1, __x2 = 2;
+    __x1.swap(__x2);
+    BOOST_TEST(((__x1 == 2) && (__x2 == 1)), "swap()");
+    float256_t __x3(std::move(__x1));
+    __x2 = std::move(__x3);
+    BOOST_TEST((__x2 == 2), "operator=(&&)");
+  }
+  mp_set_memory_functions(__alloc, __realloc, __free);
+}
+
+BOOST_AUTO_TEST_CASE(class_teuthid_floatmp_scratch_pool) {
+  typedef floatmp<TEUTHID_FLOATMP_MAX_PRECISION> __float_t;
+  void *(*__alloc)(std::size_t);
+  void *(*__realloc)(void *, std::size_t, std::size_t);
+  void (*__free)(void *, std::size_t);
+  std::size_t __allocations, __size;
+
+  floatmp_scratch_pool::clear();
+  BOOST_TEST((floatmp_scratch_pool::size() == 0), "clear()");
+  {
+    floatmp_scratch_pool::lease __r1(100), __r2(100), __r3(200);
+    BOOST_TEST((mpfr_get_prec(__r1) == 100), "lease");
+    BOOST_TEST((mpfr_get_prec(__r3.c_mpfr()) == 200), "lease");
+    BOOST_TEST((mpfr_zero_p(__r2) != 0), "lease");
+    BOOST_TEST((static_cast<mpfr_ptr>(__r1) != __r2), "lease");
+    BOOST_TEST((floatmp_scratch_pool::size() == 0), "size()");
+  }
+  BOOST_TEST((floatmp_scratch_pool::size() == 3), "size()");
+  {
+    floatmp_scratch_pool::lease __r1(100);
+    BOOST_TEST((floatmp_scratch_pool::size() == 2), "size()");
+  }
+  floatmp_scratch_pool::clear();
+  BOOST_TEST((floatmp_scratch_pool::size() == 0), "clear()");
+
+  mp_get_memory_functions(&__alloc, &__realloc, &__free);
+  mp_set_memory_functions(__mp_alloc, __mp_realloc, __mp_free);
+  {
+    __float_t __x1 = 1, __x2 = 0, __x3 = 0;
+    float256_t __y1 = 2;
+    std::size_t __parser;
+    // the parser of MPFR allocates a copy of the digits by itself
+    MPFR_DECL_INIT(__r, TEUTHID_FLOATMP_MAX_PRECISION);
+    __mp_allocations = 0;
+    mpfr_set_str(__r, "1.25", 10, MPFR_RNDN);
+    __parser = __mp_allocations;
+    // the first pass fills the pool of the calling thread
+    for (int __i = 0; __i < 2; __i++) {
+      __mp_allocations = 0;
+      system::from_string("1.25", __x2);
+      __allocations = __mp_allocations - __parser;
+      __mp_allocations = 0;
+      __x1.swap(__y1);
+      __x1.swap(__y1);
+      __x3 = __x1 * 3 + __x2 / 2.0L - 0.5L;
+      __x3 -= 1.0L;
+      __x3 *= 2;
+      __allocations += __mp_allocations;
+    }
+    __size = floatmp_scratch_pool::size();
+    BOOST_TEST((__allocations == 0), "steady state");
+    BOOST_TEST((__size > 0), "steady state");
+    BOOST_TEST((__x2 == 1.25), "system::from_string()");
+    BOOST_TEST(((__x1 == 1) && (__y1 == 2)), "swap()");
+    BOOST_TEST((__x3 == 4.25), "arithmetic");
+    BOOST_CHECK_THROW(system::from_string("1.2.3", __x2),
+                      std::invalid_argument);
+    BOOST_TEST((floatmp_scratch_pool::size() == __size), "exceptions");
+  }
+  floatmp_scratch_pool::clear();
+  mp_set_memory_functions(__alloc, __realloc, __free);
+}
+
+BOOST_AUTO_TEST_CASE(class_teuthid_floatmp_rounding) {
+  typedef floatmp_rounded<100, floatmp_round_t::round_toward_zero> __rz_t;
+  typedef floatmp_rounded<100, floatmp_round_t::round_toward_infinity> __ru_t;
+  floatmp<100> __x1 = 1, __x2, __x3, __x4, __x5;
+  __rz_t __z1 = 1, __z2;
+  __ru_t __u1 = 1, __u2;
+  floatmp_round_t __mode = floatmp_round_t::round_away_from_zero;
+
+  BOOST_TEST((floatmp_base::rounding_mode() ==
+              floatmp_round_t::round_to_nearest),
+             "rounding_mode()");
+  {
+    floatmp_base::rounding_scope __scope(floatmp_round_t::round_toward_zero);
+    BOOST_TEST((floatmp_base::rounding_mode() ==
+                floatmp_round_t::round_toward_zero),
+               "rounding_scope");
+    BOOST_TEST((__scope.previous() == floatmp_round_t::round_to_nearest),
+               "rounding_scope::previous()");
+    __x2 = __x1 / 3;
+    {
+      floatmp_base::rounding_scope __inner(
+          floatmp_round_t::round_toward_infinity);
+      __x3 = __x1 / 3;
+    }
+    BOOST_TEST((floatmp_base::rounding_mode() ==
+                floatmp_round_t::round_toward_zero),
+               "rounding_scope");
+  }
+  BOOST_TEST((floatmp_base::rounding_mode() ==
+              floatmp_round_t::round_to_nearest),
+             "rounding_scope");
+  BOOST_TEST((__x2 < __x3), "rounding_scope");
+  __x4.nextabove(__x2);
+  BOOST_TEST((__x4 == __x3), "rounding_scope");
+
+  // the rounding of a policy type does not depend on the rounding scope
+  {
+    floatmp_base::rounding_scope __scope(
+        floatmp_round_t::round_toward_infinity);
+    __z2 = __z1 / 3;
+  }
+  __u2 = __u1 / 3;
+  BOOST_TEST((__z2 == __x2), "floatmp_rounded");
+  BOOST_TEST((__u2 == __x3), "floatmp_rounded");
+  __z2 = __z1, __z2 /= 3;
+  BOOST_TEST((__z2 == __x2), "floatmp_rounded");
+  BOOST_TEST((static_cast<float>(__rz_t(__x3)) <
+              static_cast<float>(__ru_t(__x3))),
+             "floatmp_rounded");
+  BOOST_TEST((std::numeric_limits<__rz_t>::round_style ==
+              std::round_toward_zero),
+             "numeric_limits::round_style");
+  BOOST_TEST((std::numeric_limits<floatmp<64>>::round_style ==
+              std::round_indeterminate),
+             "numeric_limits::round_style");
+  // halfway cases are rounded away from zero, like std::lround(double)
+  {
+    floatmp_base::rounding_scope __scope(floatmp_round_t::round_toward_zero);
+    __x5 = 2.5;
+    BOOST_TEST(((std::lround(__x5) == 3) && (std::lround(-__x5) == -3)),
+               "std::lround()");
+    __x5 = 2.7;
+    BOOST_TEST((std::llround(__x5) == std::llround(2.7)), "std::llround()");
+    __z2 = 2.5;
+    BOOST_TEST((std::lround(__z2) == std::lround(2.5)), "std::lround()");
+  }
+
+  // each thread has its own rounding mode
+  {
+    floatmp_base::rounding_scope __scope(
+        floatmp_round_t::round_toward_infinity);
+    std::thread __t1([&]() {
+      __mode = floatmp_base::rounding_mode();
+      floatmp_base::rounding_scope __s(floatmp_round_t::round_toward_zero);
+      __x4 = __x1 / 3;
+    });
+    std::thread __t2([&]() { __x5 = __x1 / 3; });
+    __t1.join();
+    __t2.join();
+    BOOST_TEST((floatmp_base::rounding_mode() ==
+                floatmp_round_t::round_toward_infinity),
+               "rounding_mode()");
+  }
+  BOOST_TEST((__mode == floatmp_round_t::round_to_nearest), "rounding_mode()");
+  BOOST_TEST((__x4 == __x2), "rounding_scope");
+  BOOST_TEST((__x5 == (__x1 / 3)), "rounding_scope");
+}
+
+BOOST_AUTO_TEST_CASE(class_teuthid_floatmp_checking) {
+  typedef floatmp<100, floatmp_policy<floatmp_dynamic_rounding,
+                                      floatmp_unchecked>>
+      __unchecked_t;
+  typedef floatmp<100, floatmp_policy<floatmp_dynamic_rounding,
+                                      floatmp_propagate_nan>>
+      __nan_t;
+  floatmp<100> __c1 = -1, __c2 = 0, __c3;
+  __unchecked_t __u1 = -1, __u2 = 0, __u3;
+  __nan_t __n1 = -1, __n2 = 0, __n3;
+
+  BOOST_CHECK_THROW(__c3.log(__c1), std::domain_error);
+  BOOST_CHECK_THROW(__c3.sqrt(__c1), std::domain_error);
+  BOOST_CHECK_THROW(__c3.fmod(__c1, __c2), std::domain_error);
+  BOOST_CHECK_THROW(__c3.pow(__c2, __c1), std::domain_error);
+  BOOST_CHECK_THROW(__c3.tgamma(__c1), std::domain_error);
+  BOOST_CHECK_THROW(__c3.acosh(__c2), std::domain_error);
+  __c3.nextabove(__c1);
+  BOOST_TEST((__c3 > -1), "checked");
+
+  // MPFR gives NaN for invalid arguments and infinities for poles
+  BOOST_TEST(__u3.log(__u1).is_nan(), "unchecked");
+  BOOST_TEST(__u3.sqrt(__u1).is_nan(), "unchecked");
+  BOOST_TEST(__u3.fmod(__u1, __u2).is_nan(), "unchecked");
+  BOOST_TEST((__u3.log(__u2) == -__unchecked_t::infinity()), "unchecked");
+  BOOST_TEST((__u3.pow(__u2, __u1) == __unchecked_t::infinity()),
+             "unchecked");
+  BOOST_TEST(__u3.tgamma(__u1).is_nan(), "unchecked");
+  BOOST_TEST(__u3.nextabove(__unchecked_t::infinity()).is_infinite(),
+             "unchecked");
+  __u3 = 4;
+  BOOST_TEST((std::sqrt(__u3) == 2), "unchecked");
+
+  // every domain or pole error gives NaN
+  BOOST_TEST(__n3.log(__n1).is_nan(), "propagate_nan");
+  BOOST_TEST(__n3.log(__n2).is_nan(), "propagate_nan");
+  BOOST_TEST(__n3.pow(__n2, __n1).is_nan(), "propagate_nan");
+  BOOST_TEST(__n3.tgamma(__n2).is_nan(), "propagate_nan");
+  BOOST_TEST(__n3.acosh(__n2).is_nan(), "propagate_nan");
+  BOOST_TEST(__n3.nextabove(__nan_t::infinity()).is_nan(), "propagate_nan");
+  __n3 = std::sqrt(__n1);
+  BOOST_TEST(std::isnan(std::log(__n3)), "propagate_nan");
+  __n3 = 8;
+  BOOST_TEST((std::log2(__n3) == 3), "propagate_nan");
+}
+
+#ifdef TEUTHID_HAVE_QUADMATH
+BOOST_AUTO_TEST_CASE(class_teuthid_floatmp_float128) {
+  typedef floatmp<float128_prec> __fmp_t;
+  std::srand(13);
+  for (int __i = 0; __i < 1000; ++__i) {
+    __float128 __a = static_cast<__float128>(std::rand() - RAND_MAX / 2) /
+                     static_cast<__float128>(std::rand() + 1);
+    __float128 __b = std::sqrt(static_cast<__float128>(std::rand() + 1));
+    __a = std::ldexp(__a, std::rand() % 4001 - 2000);
+    __fmp_t __fa(__a), __fb(__b);
+    BOOST_TEST((static_cast<__float128>(__fa) == __a), "operator __float128()");
+    BOOST_TEST((__fa == __a), "operator==(__float128)");
+    BOOST_TEST((static_cast<__float128>(__fmp_t(__fa + __fb)) == __a + __b),
+               "__float128: operator+");
+    BOOST_TEST((static_cast<__float128>(__fmp_t(__fa - __fb)) == __a - __b),
+               "__float128: operator-");
+    BOOST_TEST((static_cast<__float128>(__fmp_t(__fa * __fb)) == __a * __b),
+               "__float128: operator*");
+    BOOST_TEST((static_cast<__float128>(__fmp_t(__fa / __fb)) == __a / __b),
+               "__float128: operator/");
+    // sqrtq() is faithfully (not correctly) rounded
+    BOOST_TEST(__fmp_t(std::sqrt(__b))
+                   .equal_to(std::sqrt(__fb), floatmp_comparison_t::ulps, 1),
+               "__float128: sqrt()");
+    BOOST_TEST((static_cast<__float128>(__fmp_t(__fa + __b)) == __a + __b),
+               "__float128: operator+(__float128)");
+    __fa += __b;
+    BOOST_TEST((__fa == __a + __b), "__float128: operator+=(__float128)");
+  }
+
+  __fmp_t __fx(2);
+  __fx = std::sqrt(__fx);
+  float128_t __x = static_cast<float128_t>(__fx), __y;
+  system::format_float_output(35, true);
+  BOOST_TEST((system::to_string(__x) == system::to_string(__fx)),
+             "system::to_string(float128_t)");
+  BOOST_TEST((system::from_string(system::to_string(__x), __y) == __x),
+             "system::from_string(float128_t)");
+  BOOST_TEST(system::equal_to(__x, __y), "system::equal_to(float128_t)");
+  system::format_float_output();
+  BOOST_TEST(system::is_floating_point(__x), "system::is_floating_point()");
+  BOOST_TEST(system::is_finite(__x), "system::is_finite(float128_t)");
+  BOOST_TEST(system::is_positive(__x), "system::is_positive(float128_t)");
+  BOOST_TEST(!system::is_zero(__x), "system::is_zero(float128_t)");
+  BOOST_TEST(((__x < system::nextabove(__x)) &&
+              (system::nextbelow(__x) < __x)),
+             "system::nextabove(float128_t)");
+  BOOST_TEST(std::isnan(std::sqrt(static_cast<float128_t>(-1))),
+             "std::sqrt(float128_t)");
+  BOOST_TEST(std::isnan(static_cast<float128_t>(__fmp_t::nan())),
+             "operator __float128()");
+  BOOST_CHECK_THROW(system::from_string("x", __y), std::invalid_argument);
+}
+#endif // TEUTHID_HAVE_QUADMATH
@@ -0,0 +1,87 @@
+/*
+  This file is part of the Teuthid project.
+  Copyright (c) 2016-2017 Mariusz Przygodzki (mariusz.przygodzki@gmail.com)
+
+  The Teuthid is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or (at your
+  option) any later version.
+
+  The Teuthid is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+  FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+  for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with the Teuthid; see the file LICENSE.LGPLv3.  If not, see
+  <http://www.gnu.org/licenses/>.
+*/
+
+#define BOOST_TEST_MODULE teuthid
+#define BOOST_TEST_DYN_LINK
+
+#include <thread>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+#include <teuthid/floatmp_accumulator.hpp>
+
+using namespace teuthid;
+
+BOOST_AUTO_TEST_CASE(class_teuthid_floatmp_accumulator) {
+  typedef floatmp<100> __float_t;
+  typedef floatmp_accumulator<100> __accumulator_t;
+  __accumulator_t __acc;
+
+  BOOST_TEST((__acc.result() == 0), "floatmp_accumulator()");
+  __acc.accumulate(1e100).accumulate(1).accumulate(-1e100);
+  BOOST_TEST((__acc.result() == 1), "accumulate()");
+  __acc += 1e-100;
+  __acc += -1;
+  BOOST_TEST((__acc.result() == 1e-100), "operator+=()");
+  __acc.clear();
+  BOOST_TEST((__acc.result() == 0), "clear()");
+
+  // the result is rounded only once
+  __float_t __third = 1, __x;
+  __third /= 3;
+  for (int __i = 0; __i < 3000; ++__i)
+    __acc.accumulate(__third);
+  __x = 1000;
+  __x.nextbelow(__x); // 3000 * (1/3 - ulp/3) rounds down
+  BOOST_TEST(((__acc.result() == __x) || (__acc.result() == 1000)),
+             "accumulate(floatmp)");
+  floatmp<400> __exact = __third;
+  __exact *= 3000;
+  BOOST_TEST((__acc.result() == __float_t(__exact)), "result()");
+
+  // exact products
+  __accumulator_t __dot;
+  __dot.accumulate_product(__third, __third);
+  __dot.accumulate(-floatmp<200>(__third * floatmp<200>(__third)));
+  BOOST_TEST((__dot.result() == 0), "accumulate_product()");
+  BOOST_TEST(mpfr_zero_p(__dot.c_mpfr()), "c_mpfr()");
+
+  // parallel reduction
+  const int __n = 1000;
+  std::vector<__accumulator_t> __partial(4);
+  std::vector<std::thread> __threads;
+  for (int __t = 0; __t < 4; ++__t)
+    __threads.emplace_back([&__partial, __t, __n]() {
+      for (int __i = __t; __i < __n; __i += 4) {
+        __float_t __y = __i + 1;
+        __y.sqrt(__y);
+        __partial[__t].accumulate_product(__y, __y);
+      }
+    });
+  for (auto &__th : __threads)
+    __th.join();
+  __accumulator_t __total;
+  for (const auto &__p : __partial)
+    __total.merge(__p);
+  BOOST_TEST(__total.result().equal_to(__float_t(__n * (__n + 1) / 2),
+                                       floatmp_comparison_t::ulps, 1),
+             "merge()");
+  __accumulator_t __copy(__total), __moved(std::move(__copy));
+  BOOST_TEST((__moved.result() == __total.result()), "floatmp_accumulator(&&)");
+}
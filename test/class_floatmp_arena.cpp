@@ -0,0 +1,122 @@
+/*
+  This file is part of the Teuthid project.
+  Copyright (c) 2016-2017 Mariusz Przygodzki (mariusz.przygodzki@gmail.com)
+
+  The Teuthid is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or (at your
+  option) any later version.
+
+  The Teuthid is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+  FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+  for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with the Teuthid; see the file LICENSE.LGPLv3.  If not, see
+  <http://www.gnu.org/licenses/>.
+*/
+
+#define BOOST_TEST_MODULE teuthid
+#define BOOST_TEST_DYN_LINK
+
+#include <stdexcept>
+#include <thread>
+
+#include <boost/test/unit_test.hpp>
+#include <teuthid/floatmp.hpp>
+#include <teuthid/floatmp_arena.hpp>
+#include <teuthid/system.hpp>
+
+using namespace teuthid;
+
+typedef floatmp<TEUTHID_FLOATMP_MAX_PRECISION> __float_t;
+
+BOOST_AUTO_TEST_CASE(class_teuthid_floatmp_arena) {
+  __float_t __x1 = 2; // allocated by the heap before the arena is installed
+
+  BOOST_TEST(!floatmp_arena::is_installed(), "is_installed()");
+  BOOST_CHECK_THROW(floatmp_arena::scope(), std::logic_error);
+  floatmp_arena::install(1 << 16);
+  BOOST_TEST(floatmp_arena::is_installed(), "install()");
+  BOOST_TEST(!floatmp_arena::is_active(), "is_active()");
+  BOOST_TEST((floatmp_arena::bytes_in_use() == 0), "bytes_in_use()");
+  {
+    floatmp_arena::scope __scope;
+    BOOST_TEST(floatmp_arena::is_active(), "scope");
+    __float_t __x2 = 1, __x3 = 3;
+    __x2 /= __x3;
+    std::size_t __bytes = floatmp_arena::bytes_in_use();
+    BOOST_TEST((__bytes > 0), "bytes_in_use()");
+    BOOST_TEST((floatmp_arena::bytes_reserved() >= (1 << 16)),
+               "bytes_reserved()");
+    {
+      floatmp_arena::scope __inner;
+      __float_t __x4 = __x2 * 3;
+      BOOST_TEST((__x4 == 1), "scope");
+      BOOST_TEST((floatmp_arena::bytes_in_use() > __bytes), "scope");
+    }
+    BOOST_TEST((floatmp_arena::bytes_in_use() == __bytes), "scope");
+    {
+      floatmp_arena::suspend __suspend;
+      BOOST_TEST(!floatmp_arena::is_active(), "suspend");
+      __float_t __x5 = 5;
+      BOOST_TEST((floatmp_arena::bytes_in_use() == __bytes), "suspend");
+    }
+    BOOST_TEST(floatmp_arena::is_active(), "suspend");
+    // the constants must survive the end of the scope
+    BOOST_TEST(__float_t::pi().is_positive(), "floatmp::pi()");
+    __x1 += __x2 * 3;
+    BOOST_CHECK_THROW(floatmp_arena::uninstall(), std::logic_error);
+    BOOST_CHECK_THROW(floatmp_arena::release(), std::logic_error);
+  }
+  BOOST_TEST(!floatmp_arena::is_active(), "scope");
+  BOOST_TEST((floatmp_arena::bytes_in_use() == 0), "scope");
+  BOOST_TEST((__x1 == 3), "heap values");
+  MPFR_DECL_INIT(__pi, TEUTHID_FLOATMP_MAX_PRECISION);
+  mpfr_const_pi(__pi, MPFR_RNDN);
+  BOOST_TEST((mpfr_equal_p(__float_t::pi().c_mpfr(), __pi) != 0),
+             "floatmp::pi()");
+
+  // the caches of MPFR filled inside a nested scope must not outlive it
+  MPFR_DECL_INIT(__pi1, 300);
+  MPFR_DECL_INIT(__pi2, 300);
+  mpfr_free_cache2(MPFR_FREE_LOCAL_CACHE);
+  {
+    floatmp_arena::scope __scope;
+    {
+      floatmp_arena::scope __inner;
+      mpfr_const_pi(__pi1, MPFR_RNDN);
+    }
+    __float_t __x2 = 1, __x3 = 7;
+    __x2 /= __x3;
+    __x2.sqrt(__x2);
+    mpfr_const_pi(__pi2, MPFR_RNDN);
+  }
+  BOOST_TEST((mpfr_equal_p(__pi1, __pi2) != 0), "nested scope");
+  BOOST_TEST((mpfr_cmp_d(__pi2, 3.14159265358979) > 0), "nested scope");
+  BOOST_TEST((mpfr_cmp_d(__pi2, 3.1415926535898) < 0), "nested scope");
+
+  // the arena of each thread is separate
+  std::size_t __bytes = 0;
+  {
+    floatmp_arena::scope __scope;
+    __float_t __x2 = 1;
+    std::thread __th([&__bytes]() {
+      floatmp_arena::scope __scope;
+      __float_t __y1 = 1, __y2 = 2, __y3 = 3;
+      __y1 += __y2 * __y3;
+      __bytes = floatmp_arena::bytes_in_use();
+    });
+    __th.join();
+    BOOST_TEST((__bytes > floatmp_arena::bytes_in_use()), "threads");
+  }
+
+  BOOST_TEST((floatmp_arena::bytes_reserved() > 0), "bytes_reserved()");
+  floatmp_arena::release();
+  BOOST_TEST((floatmp_arena::bytes_reserved() == 0), "release()");
+  floatmp_arena::uninstall();
+  BOOST_TEST(!floatmp_arena::is_installed(), "uninstall()");
+  __x1 = 4;
+  BOOST_TEST((__x1 == 4), "uninstall()");
+}
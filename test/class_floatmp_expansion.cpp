@@ -0,0 +1,124 @@
+/*
+  This file is part of the Teuthid project.
+  Copyright (c) 2016-2017 Mariusz Przygodzki (mariusz.przygodzki@gmail.com)
+
+  The Teuthid is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or (at your
+  option) any later version.
+
+  The Teuthid is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+  FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+  for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with the Teuthid; see the file LICENSE.LGPLv3.  If not, see
+  <http://www.gnu.org/licenses/>.
+*/
+
+#define BOOST_TEST_MODULE teuthid
+#define BOOST_TEST_DYN_LINK
+
+#include <type_traits>
+
+#include <boost/test/unit_test.hpp>
+#include <teuthid/floatmp_expansion.hpp>
+
+using namespace teuthid;
+
+template <typename E> static void __check_arithmetic(std::size_t ulps) {
+  typedef floatmp<E::precision()> __float_t;
+  const double __values[] = {1.0, -3.0, 0.1, 7.5e-12, -1234567.890123, 1e100};
+
+  for (double __a : __values)
+    for (double __b : __values) {
+      __float_t __fa = __a, __fb = __b, __fc = 3;
+      E __ea = __a, __eb = __b, __ec = 3;
+      // operands with all terms in use
+      __fa /= __fc, __ea /= __ec;
+      __fb.sqrt(__float_t(__fb).abs(__fb)), __eb.sqrt(E(__eb).abs(__eb));
+      BOOST_TEST(__float_t(__ea).equal_to(__fa, floatmp_comparison_t::ulps, 1),
+                 "div()");
+      BOOST_TEST(__float_t(__eb).equal_to(__fb, floatmp_comparison_t::ulps, 2),
+                 "sqrt()");
+      __ea = __fa, __eb = __fb; // the same operands as for floatmp
+      BOOST_TEST((__float_t(__ea) == __fa), "assign()");
+      __fc = __fa + __fb;
+      BOOST_TEST(__float_t(__ea + __eb)
+                     .equal_to(__fc, floatmp_comparison_t::ulps, ulps),
+                 "operator+");
+      __fc = __fa - __fb;
+      BOOST_TEST(__float_t(__ea - __eb)
+                     .equal_to(__fc, floatmp_comparison_t::ulps, ulps),
+                 "operator-");
+      __fc = __fa * __fb;
+      BOOST_TEST(__float_t(__ea * __eb)
+                     .equal_to(__fc, floatmp_comparison_t::ulps, ulps),
+                 "operator*");
+      __fc = __fa / __fb;
+      BOOST_TEST(__float_t(__ea / __eb)
+                     .equal_to(__fc, floatmp_comparison_t::ulps, ulps),
+                 "operator/");
+    }
+}
+
+BOOST_AUTO_TEST_CASE(class_teuthid_floatmp_expansion) {
+  BOOST_TEST((floatdd_t::precision() == 106), "precision()");
+  BOOST_TEST((floatqd_t::precision() == 212), "precision()");
+  BOOST_TEST((std::is_same<floatmp_fast<64>, floatdd_t>::value),
+             "floatmp_fast");
+  BOOST_TEST((std::is_same<floatmp_fast<106>, floatdd_t>::value),
+             "floatmp_fast");
+  BOOST_TEST((std::is_same<floatmp_fast<200>, floatqd_t>::value),
+             "floatmp_fast");
+  BOOST_TEST((std::is_same<floatmp_fast<256>, floatmp<256>>::value),
+             "floatmp_fast");
+
+  __check_arithmetic<floatdd_t>(4);
+  __check_arithmetic<floatqd_t>(16);
+
+  floatdd_t __x1 = 1, __x2 = 3, __x3;
+  floatqd_t __y1 = INT64_MIN, __y2;
+  __x3 = __x1 / __x2;
+  BOOST_TEST((__x3[1] != 0), "operator[]");
+  BOOST_TEST((__x3 != __x1), "operator!=");
+  BOOST_TEST((__x1 < __x2), "operator<");
+  BOOST_TEST((__x2 >= __x1), "operator>=");
+  BOOST_TEST((__x3 <= __x3), "operator<=");
+  BOOST_TEST((floatmp<64>(__y1) == INT64_MIN), "floatmp_expansion(int64_t)");
+  __y1 = UINT64_MAX;
+  BOOST_TEST((floatmp<64>(__y1) == UINT64_MAX), "floatmp_expansion(uint64_t)");
+  __y2 = floatmp<200>(1) / 7;
+  BOOST_TEST((floatmp<200>(__y2) == (floatmp<200>(1) / 7)), "floatmp");
+  __y2.exp(__y1.log(floatqd_t(2)));
+  BOOST_TEST(floatmp<200>(__y2).equal_to(floatmp<200>(2),
+                                          floatmp_comparison_t::ulps, 4),
+             "exp(), log()");
+  __x1 = std::ldexp(1.0, -80);
+  BOOST_TEST((((__x3 + __x1) - __x3) == __x1), "add(), sub()");
+  __y1 = floatqd_t(1) / 3, __y2 = std::ldexp(1.0, -180);
+  BOOST_TEST((((__y1 + __y2) - __y1) == __y2), "add(), sub()");
+  __x1 = 1, __x3 = 0;
+  BOOST_TEST((__x1 / __x3).is_infinite(), "operator/");
+  BOOST_TEST((__x3 / __x3).is_nan(), "operator/");
+  BOOST_TEST(floatdd_t().sqrt(floatdd_t(-1)).is_nan(), "sqrt()");
+
+  // mixed with floatmp, the expansions are converted exactly
+  floatmp<300> __z1 = 1, __z2;
+  __x1 = 1, __x1 += std::ldexp(1.0, -200);
+  BOOST_TEST((!(__x1 == __z1) && (__z1 != __x1)), "operator==(floatmp)");
+  BOOST_TEST(((__z1 < __x1) && (__x1 > __z1)), "operator<(floatmp)");
+  __z2 = __x1 - __z1;
+  BOOST_TEST((__z2 == std::ldexp(1.0, -200)), "operator-(floatmp)");
+  __z2 = __z1 + __x1;
+  __z2 -= __x1, __z2 *= __x1;
+  BOOST_TEST((__z2 == __x1), "operator+=(floatdd_t)");
+  BOOST_TEST(!(__z1 == floatdd_t(std::nan(""))), "NaN");
+  __x3 = floatdd_t(__z1 / 3);
+  BOOST_TEST((__x3 == floatdd_t(1) / 3), "floatmp_expansion(floatmp_expr)");
+  BOOST_TEST((!std::is_convertible<floatmp<300>, floatdd_t>::value),
+             "explicit floatmp_expansion(floatmp)");
+  BOOST_TEST((std::is_convertible<int, floatdd_t>::value),
+             "floatmp_expansion(int)");
+}
@@ -0,0 +1,125 @@
+/*
+  This file is part of the Teuthid project.
+  Copyright (c) 2016-2017 Mariusz Przygodzki (mariusz.przygodzki@gmail.com)
+
+  The Teuthid is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or (at your
+  option) any later version.
+
+  The Teuthid is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+  FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+  for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with the Teuthid; see the file LICENSE.LGPLv3.  If not, see
+  <http://www.gnu.org/licenses/>.
+*/
+
+#define BOOST_TEST_MODULE teuthid
+#define BOOST_TEST_DYN_LINK
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+#include <boost/test/unit_test.hpp>
+#include <teuthid/floatmp_io.hpp>
+
+using namespace teuthid;
+
+typedef floatmp<100> __float_t;
+
+BOOST_AUTO_TEST_CASE(class_teuthid_floatmp_io) {
+  // single values
+  __float_t __x1 = 1, __x2;
+  __x1 /= 3;
+  std::stringstream __ss;
+  floatmp_io::save(__ss, __x1);
+  BOOST_TEST((__ss.str().size() ==
+              floatmp_io::header_size + floatmp_io::record_size(100)),
+             "save()");
+  floatmp_io::load(__ss, __x2);
+  BOOST_TEST((__x1 == __x2), "load()");
+
+  // arrays with special values
+  __float_t __a1[6] = {0, -0.0, 1, -2.5, __float_t::nan(),
+                       -__float_t::infinity()};
+  __ss.str("");
+  floatmp_io::save(__ss, __a1, 6);
+  __float_t __a2[6];
+  floatmp_io::load(__ss, __a2, 6);
+  for (std::size_t __i = 0; __i < 4; ++__i)
+    BOOST_TEST((__a1[__i] == __a2[__i]), "load()");
+  BOOST_TEST((mpfr_signbit(__a2[1].c_mpfr()) != 0), "load()");
+  BOOST_TEST(__a2[4].is_nan(), "load()");
+  BOOST_TEST((__a2[5].is_infinite() && __a2[5].is_negative()), "load()");
+  __ss.clear();
+  __ss.seekg(0);
+  BOOST_CHECK_THROW(floatmp_io::load(__ss, __a2, 5), std::invalid_argument);
+
+  // other precisions are rounded while loading
+  __ss.str("");
+  floatmp_io::save(__ss, __x1);
+  floatmp<24> __y1;
+  floatmp_io::load(__ss, __y1);
+  BOOST_TEST((__y1 == floatmp<24>(__x1)), "load()");
+
+  // vectors (larger than a chunk)
+  floatmp_vector<100> __v1(10000), __v2;
+  for (std::size_t __i = 0; __i < __v1.size(); ++__i)
+    __v1.set(__i, __float_t(__i) / 7);
+  __ss.str("");
+  floatmp_io::save(__ss, __v1);
+  floatmp_io::load(__ss, __v2);
+  BOOST_TEST((__v2.size() == __v1.size()), "load()");
+  bool __equal = true;
+  for (std::size_t __i = 0; __i < __v1.size(); ++__i)
+    __equal = __equal && (__v1.get(__i) == __v2.get(__i));
+  BOOST_TEST(__equal, "load()");
+
+  // invalid data
+  std::stringstream __bad("TEUTHIDX");
+  BOOST_CHECK_THROW(floatmp_io::load(__bad, __x2), std::runtime_error);
+  __ss.str("");
+  floatmp_io::save(__ss, __x1);
+  std::string __data = __ss.str();
+  __data[floatmp_io::header_size + 8] = 7; // an invalid kind
+  __bad.str(__data);
+  BOOST_CHECK_THROW(floatmp_io::load(__bad, __x2), std::runtime_error);
+  __bad.str(__data.substr(0, floatmp_io::header_size + 1));
+  BOOST_CHECK_THROW(floatmp_io::load(__bad, __x2), std::runtime_error);
+
+  // mapped views
+  const char *__path = "class_floatmp_io.bin";
+  {
+    std::ofstream __file(__path, std::ios::binary);
+    floatmp_io::save(__file, __v1);
+  }
+  {
+    floatmp_mapped<100> __m(__path);
+    BOOST_TEST((__m.size() == __v1.size()), "floatmp_mapped::size()");
+    BOOST_TEST((__m[1] == __v1.get(1)), "floatmp_mapped::operator[]");
+    BOOST_TEST((__m.at(9999) == __v1.get(9999)), "floatmp_mapped::at()");
+    BOOST_CHECK_THROW(__m.at(10000), std::out_of_range);
+    mpfr_t __v;
+    __m.view(7, __v);
+    BOOST_TEST((mpfr_cmp_ui(__v, 1) == 0), "floatmp_mapped::view()");
+    __float_t __sum = 0;
+    for (std::size_t __i = 0; __i < __m.size(); ++__i) {
+      __m.view(__i, __v);
+      __sum += __v;
+    }
+    BOOST_TEST(__sum.is_positive(), "floatmp_mapped::view()");
+  }
+  BOOST_CHECK_THROW(floatmp_mapped<24>{__path}, std::invalid_argument);
+  {
+    std::ofstream __file(__path, std::ios::binary);
+    __file << "TEUTHIDF";
+  }
+  BOOST_CHECK_THROW(floatmp_mapped<100>{__path}, std::runtime_error);
+  std::remove(__path);
+  BOOST_CHECK_THROW(floatmp_mapped<100>{__path}, std::runtime_error);
+}
@@ -0,0 +1,104 @@
+/*
+  This file is part of the Teuthid project.
+  Copyright (c) 2016-2017 Mariusz Przygodzki (mariusz.przygodzki@gmail.com)
+
+  The Teuthid is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or (at your
+  option) any later version.
+
+  The Teuthid is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+  FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+  for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with the Teuthid; see the file LICENSE.LGPLv3.  If not, see
+  <http://www.gnu.org/licenses/>.
+*/
+
+#define BOOST_TEST_MODULE teuthid
+#define BOOST_TEST_DYN_LINK
+
+#include <stdexcept>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+#include <teuthid/floatmp_vector.hpp>
+
+using namespace teuthid;
+
+BOOST_AUTO_TEST_CASE(class_teuthid_floatmp_vector) {
+  typedef floatmp<200> __float_t;
+  typedef floatmp_vector<200> __vector_t;
+  const std::size_t __n = 100;
+  std::vector<__float_t> __x(__n), __y(__n);
+  __vector_t __vx(__n), __vy(__n, 2);
+
+  BOOST_TEST((__vx.size() == __n), "size()");
+  BOOST_TEST(!__vx.empty(), "empty()");
+  BOOST_TEST(__vector_t().empty(), "empty()");
+  BOOST_TEST((__vx[0] == 0), "floatmp_vector(n)");
+  BOOST_TEST((__vy[__n - 1] == 2), "floatmp_vector(n, x)");
+  for (std::size_t __i = 0; __i < __n; ++__i) {
+    __x[__i] = 1, __x[__i] /= static_cast<int>(__i) - 33;
+    __y[__i] = __i, __y[__i].sqrt(__y[__i]);
+    __vx.set(__i, __x[__i]);
+    __vy.set(__i, __y[__i]);
+  }
+  for (std::size_t __i = 0; __i < __n; ++__i)
+    BOOST_TEST(((__vx[__i] == __x[__i]) && (__vy.at(__i) == __y[__i])),
+               "set(), get()");
+  BOOST_CHECK_THROW(__vx.at(__n), std::out_of_range);
+
+  // kernels against the naive loops of floatmp (within 1 ulp)
+  floatmp<400> __dot = 0, __nrm2 = 0, __asum = 0, __sum = 0;
+  for (std::size_t __i = 0; __i < __n; ++__i) {
+    __dot += floatmp<400>(__x[__i]) * floatmp<400>(__y[__i]);
+    __nrm2 += floatmp<400>(__x[__i]) * floatmp<400>(__x[__i]);
+    __asum += std::abs(floatmp<400>(__x[__i]));
+    __sum += __x[__i];
+  }
+  __nrm2.sqrt(__nrm2);
+  BOOST_TEST(__vx.dot(__vy).equal_to(__float_t(__dot),
+                                     floatmp_comparison_t::ulps, 1),
+             "dot()");
+  BOOST_TEST(__vx.nrm2().equal_to(__float_t(__nrm2),
+                                  floatmp_comparison_t::ulps, 1),
+             "nrm2()");
+  BOOST_TEST(__vx.asum().equal_to(__float_t(__asum),
+                                  floatmp_comparison_t::ulps, 1),
+             "asum()");
+  BOOST_TEST(__vx.sum().equal_to(__float_t(__sum),
+                                 floatmp_comparison_t::ulps, 1),
+             "sum()");
+
+  // element-wise kernels are correctly rounded
+  __float_t __a = 3;
+  __a.sqrt(__a);
+  __vector_t __vz(__vy);
+  __vz.axpy(__a, __vx);
+  __vy.scal(__a);
+  for (std::size_t __i = 0; __i < __n; ++__i) {
+    __float_t __z;
+    __z.fma(__a, __x[__i], __y[__i]);
+    BOOST_TEST((__vz[__i] == __z), "axpy()");
+    __z = __y[__i] * __a;
+    BOOST_TEST((__vy[__i] == __z), "scal()");
+  }
+  BOOST_CHECK_THROW(__vz.dot(__vector_t(1)), std::invalid_argument);
+
+  __float_t __z9 = __vz[9];
+  __vector_t __vw;
+  __vw = std::move(__vz);
+  BOOST_TEST((__vz.empty() && (__vw.size() == __n)), "operator=(&&)");
+  __vw.resize(10);
+  BOOST_TEST(((__vw.size() == 10) && (__vw[9] == __z9)),
+             "resize()");
+  __vw.resize(20);
+  BOOST_TEST((__vw[19] == 0), "resize()");
+  __vw.fill(-1);
+  BOOST_TEST((__vw.sum() == -20), "fill()");
+  std::swap(__vw, __vx);
+  BOOST_TEST(((__vw.size() == __n) && (__vx.size() == 20)), "swap()");
+}
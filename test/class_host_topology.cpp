@@ -0,0 +1,131 @@
+/*
+  This file is part of the Teuthid project.
+  Copyright (c) 2016-2017 Mariusz Przygodzki (mariusz.przygodzki@gmail.com)
+
+  The Teuthid is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or (at your
+  option) any later version.
+
+  The Teuthid is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+  FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+  for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with the Teuthid; see the file LICENSE.LGPLv3.  If not, see
+  <http://www.gnu.org/licenses/>.
+*/
+
+#define BOOST_TEST_MODULE teuthid
+#define BOOST_TEST_DYN_LINK
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <sys/stat.h>
+
+#include <boost/test/unit_test.hpp>
+#include <teuthid/host_topology.hpp>
+#include <teuthid/system.hpp>
+
+using namespace teuthid;
+
+namespace {
+// a fake tree of /sys/devices/system; it is removed by the destructor
+class __sysfs {
+public:
+  explicit __sysfs(const std::string &root) : root_(root) { mkdir_(""); }
+  ~__sysfs() {
+    for (auto __p = paths_.rbegin(); __p != paths_.rend(); ++__p)
+      std::remove(__p->c_str());
+  }
+  void write(const std::string &path, const std::string &text) {
+    std::string::size_type __pos = 0;
+    while ((__pos = path.find('/', __pos + 1)) != std::string::npos)
+      mkdir_(path.substr(0, __pos));
+    std::ofstream(root_ + path) << text << '\n';
+    paths_.push_back(root_ + path);
+  }
+
+private:
+  std::string root_;
+  std::vector<std::string> paths_;
+
+  void mkdir_(const std::string &path) {
+    if (::mkdir((root_ + path).c_str(), 0755) == 0)
+      paths_.push_back(root_ + path);
+  }
+};
+} // namespace
+
+BOOST_AUTO_TEST_CASE(class_teuthid_host_topology) {
+  // 2 cores with 2 threads each, in 2 NUMA nodes
+  __sysfs __fs("class_host_topology.sys");
+  __fs.write("/cpu/online", "0-3");
+  const char *__siblings[] = {"0,2", "1,3", "0,2", "1,3"};
+  for (int __i = 0; __i < 4; ++__i) {
+    std::string __cpu = "/cpu/cpu" + std::to_string(__i);
+    __fs.write(__cpu + "/topology/thread_siblings_list", __siblings[__i]);
+    __fs.write(__cpu + "/topology/physical_package_id", "0");
+    const char *__types[] = {"Data", "Instruction", "Unified", "Unified"};
+    const char *__sizes[] = {"48K", "32K", "2048K", "32M"};
+    for (int __j = 0; __j < 4; ++__j) {
+      std::string __index = __cpu + "/cache/index" + std::to_string(__j);
+      __fs.write(__index + "/level", std::to_string(__j < 2 ? 1 : __j));
+      __fs.write(__index + "/type", __types[__j]);
+      __fs.write(__index + "/size", __sizes[__j]);
+      __fs.write(__index + "/coherency_line_size", "64");
+      __fs.write(__index + "/ways_of_associativity", "12");
+      __fs.write(__index + "/shared_cpu_list",
+                 (__j == 3) ? "0-3" : __siblings[__i]);
+    }
+  }
+  __fs.write("/node/online", "0-1");
+  __fs.write("/node/node0/cpulist", "0,2");
+  __fs.write("/node/node0/meminfo", "Node 0 MemTotal:     1024 kB");
+  __fs.write("/node/node1/cpulist", "1,3");
+  __fs.write("/node/node1/meminfo", "Node 1 MemTotal:     2048 kB");
+
+  host_topology __t("class_host_topology.sys");
+  BOOST_TEST((__t.logical_cpus() == 4), "logical_cpus()");
+  BOOST_TEST((__t.physical_cores() == 2), "physical_cores()");
+  BOOST_TEST((__t.packages() == 1), "packages()");
+  BOOST_TEST((__t.threads_per_core() == 2), "threads_per_core()");
+  BOOST_TEST((__t.cpus()[2].core == __t.cpus()[0].core), "cpus()");
+  BOOST_TEST((__t.cpus()[1].core != __t.cpus()[0].core), "cpus()");
+  BOOST_TEST((__t.caches().size() == 7), "caches()"); // 3 per core, 1 L3
+  BOOST_TEST((__t.cache_size(1) == 48 * 1024), "cache_size()");
+  BOOST_TEST((__t.cache_size(2) == 2048 * 1024), "cache_size()");
+  BOOST_TEST((__t.cache_size(3) == 32 * 1024 * 1024), "cache_size()");
+  BOOST_TEST((__t.cache_size(4) == 0), "cache_size()");
+  BOOST_TEST((__t.cache_line_size() == 64), "cache_line_size()");
+  BOOST_TEST((__t.caches()[3].cpus.size() == 4), "caches()");
+  BOOST_TEST((__t.caches()[1].type == cpu_cache_t::instruction), "caches()");
+  BOOST_TEST((__t.nodes().size() == 2), "nodes()");
+  BOOST_TEST((__t.nodes()[1].memory == 2048 * 1024), "nodes()");
+  BOOST_TEST((__t.cpus()[3].node == 1), "cpus()");
+  BOOST_TEST((__t.cpus()[2].node == 0), "cpus()");
+
+  // without the tree, every CPU is a core of a single node
+  host_topology __flat("class_host_topology.none");
+  BOOST_TEST((__flat.logical_cpus() >= 1), "logical_cpus()");
+  BOOST_TEST((__flat.physical_cores() == __flat.logical_cpus()),
+             "physical_cores()");
+  BOOST_TEST((__flat.nodes().size() == 1), "nodes()");
+  BOOST_TEST(__flat.caches().empty(), "caches()");
+
+  // the host
+  const host_topology &__host = system::topology();
+  BOOST_TEST((&__host == &system::topology()), "system::topology()");
+  BOOST_TEST((__host.logical_cpus() >= 1), "system::topology()");
+  BOOST_TEST((__host.physical_cores() <= __host.logical_cpus()),
+             "system::topology()");
+  bool __valid = true;
+  for (const host_topology::logical_cpu &__cpu : __host.cpus())
+    __valid = __valid && (__cpu.core < __host.physical_cores()) &&
+              (__cpu.node < __host.nodes().size());
+  BOOST_TEST(__valid, "system::topology()");
+}
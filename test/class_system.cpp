@@ -20,6 +20,13 @@
 #define BOOST_TEST_MODULE teuthid
 #define BOOST_TEST_DYN_LINK
 
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <thread>
+#include <vector>
+
 #include <boost/test/unit_test.hpp>
 #include <teuthid/system.hpp>
 
@@ -54,6 +61,7 @@ BOOST_AUTO_TEST_CASE(class_teuthid_system) {
   BOOST_TEST(system::check_version(major_ver, minor_ver - 1),
              "check_version()");
 
+  system::probe_cl_backend(); // does not wait for the detection
 #if defined(TEUTHID_WITH_OPENCL)
   BOOST_TEST(system::has_cl_backend(), "has_cl_backend()");
   BOOST_TEST(system::uses_cl_backend(), "uses_cl_backend()");
@@ -116,6 +124,36 @@ BOOST_AUTO_TEST_CASE(class_teuthid_system) {
   BOOST_TEST(!__s.empty(), "system::to_string(uint128_t)");
   system::from_string(__s, __uint_128_x);
   BOOST_TEST((__uint_128 == __uint_128_x), "system::from_string(uint128_t)");
+
+  // the extremes span three blocks of 19 digits
+  const std::string __uint128_max = "340282366920938463463374607431768211455";
+  const std::string __int128_min = "-170141183460469231731687303715884105728";
+  __uint_128 = ~TO_UINT128(0);
+  BOOST_TEST((system::to_string(__uint_128) == __uint128_max),
+             "system::to_string(uint128_t)");
+  BOOST_TEST((system::from_string(__uint128_max, __uint_128_x) == __uint_128),
+             "system::from_string(uint128_t)");
+  __int_128 = -TO_INT128(__uint_128 >> 1) - 1;
+  BOOST_TEST((system::to_string(__int_128) == __int128_min),
+             "system::to_string(int128_t)");
+  BOOST_TEST((system::from_string(__int128_min, __int_128_x) == __int_128),
+             "system::from_string(int128_t)");
+  __uint_128 = TO_UINT128(10000000000000000000ULL) * 10000000000000000000ULL;
+  BOOST_TEST((system::to_string(__uint_128) ==
+              "100000000000000000000000000000000000000"),
+             "system::to_string(uint128_t)");
+  BOOST_TEST((system::to_string(TO_INT128(-7)) == "-7"),
+             "system::to_string(int128_t)");
+  BOOST_TEST((system::from_string("+0000000000000000000000000042",
+                                  __uint_128_x) == 42),
+             "system::from_string(uint128_t)");
+  BOOST_CHECK_THROW(system::from_string(__uint128_max.substr(0, 38) + "6",
+                                        __uint_128_x),
+                    std::out_of_range);
+  BOOST_CHECK_THROW(system::from_string(__int128_min.substr(1), __int_128_x),
+                    std::out_of_range);
+  BOOST_CHECK_THROW(system::from_string("12345678901234567890x", __int_128_x),
+                    std::invalid_argument);
 #endif // TEUTHID_HAVE_INT_128
 
   bool __false = false;
@@ -408,18 +446,24 @@ BOOST_AUTO_TEST_CASE(class_teuthid_system) {
 
   floatmp<200> __floatmp1;
   floatmp<300> __floatmp2;
-  BOOST_TEST((system::from_string("1.2345", __floatmp1) ==
-              (system::from_string("1.2345", __floatmp2))),
-             "system::from_string(floatmp)");
-  BOOST_TEST((system::from_string("1.2345", __floatmp1) !=
-              (system::from_string("1.2346", __floatmp2))),
-             "system::from_string(floatmp)");
-  BOOST_TEST(system::is_finite(__floatmp1), "system::is_finite(floatmp)");
-  BOOST_TEST(!system::is_infinite(__floatmp1), "system::is_infinite(floatmp)");
-  BOOST_TEST(!system::is_nan(__floatmp1), "system::is_nan(floatmp)");
-  BOOST_TEST(!system::is_zero(__floatmp1), "system::is_zero(floatmp)");
-  system::swap(__floatmp1, __floatmp2);
-  BOOST_TEST((__floatmp1 == 1.2346), "system::swap(floatmp)");
+  {
+    floatmp_base::comparison_scope __comparison(
+        floatmp_comparison_t::decimals,
+        system::default_format_float_precision());
+    BOOST_TEST((system::from_string("1.2345", __floatmp1) ==
+                (system::from_string("1.2345", __floatmp2))),
+               "system::from_string(floatmp)");
+    BOOST_TEST((system::from_string("1.2345", __floatmp1) !=
+                (system::from_string("1.2346", __floatmp2))),
+               "system::from_string(floatmp)");
+    BOOST_TEST(system::is_finite(__floatmp1), "system::is_finite(floatmp)");
+    BOOST_TEST(!system::is_infinite(__floatmp1),
+               "system::is_infinite(floatmp)");
+    BOOST_TEST(!system::is_nan(__floatmp1), "system::is_nan(floatmp)");
+    BOOST_TEST(!system::is_zero(__floatmp1), "system::is_zero(floatmp)");
+    system::swap(__floatmp1, __floatmp2);
+    BOOST_TEST((__floatmp1 == 1.2346), "system::swap(floatmp)");
+  }
 
   std::string __text = "";
   std::vector<std::string> __strvector;
@@ -454,3 +498,431 @@ BOOST_AUTO_TEST_CASE(class_teuthid_system) {
   mpfr_clear(__mpfr);
   mpfr_clear(__mpfr2);
 }
+
+template <typename T> std::string __to_chars(const T &x) {
+  char __buf[64];
+  system::to_chars_result __r = system::to_chars(__buf, __buf + 64, x);
+  BOOST_TEST((__r.ec == std::errc()), "system::to_chars()");
+  return std::string(__buf, __r.ptr);
+}
+
+BOOST_AUTO_TEST_CASE(class_teuthid_system_to_chars) {
+  BOOST_TEST((__to_chars(int8_t(-128)) == "-128"), "to_chars(int8_t)");
+  BOOST_TEST((__to_chars(uint64_t(18446744073709551615ull)) ==
+              "18446744073709551615"),
+             "to_chars(uint64_t)");
+#ifdef TEUTHID_HAVE_INT_128
+  BOOST_TEST((__to_chars(-TO_INT128(~TO_UINT128(0) >> 1) - 1) ==
+              "-170141183460469231731687303715884105728"),
+             "to_chars(int128_t)");
+#endif // TEUTHID_HAVE_INT_128
+
+  // the shortest digits which are read back as the same value
+  BOOST_TEST((__to_chars(TO_FLT(0.1)) == "0.1"), "to_chars(float)");
+  BOOST_TEST((__to_chars(TO_FLT(1e-45)) == "1e-45"), "to_chars(float)");
+  BOOST_TEST((__to_chars(TO_FLT(3.4028235e38)) == "3.4028235e+38"),
+             "to_chars(float)");
+  BOOST_TEST((__to_chars(TO_DBL(0.3)) == "0.3"), "to_chars(double)");
+  BOOST_TEST((__to_chars(TO_DBL(-1234.5)) == "-1234.5"), "to_chars(double)");
+  BOOST_TEST((__to_chars(TO_DBL(1e22)) == "1e+22"), "to_chars(double)");
+  BOOST_TEST((__to_chars(TO_DBL(5e-324)) == "5e-324"), "to_chars(double)");
+  BOOST_TEST((__to_chars(TO_DBL(0.000125)) == "0.000125"),
+             "to_chars(double)");
+  BOOST_TEST((__to_chars(TO_DBL(1.7976931348623157e308)) ==
+              "1.7976931348623157e+308"),
+             "to_chars(double)");
+  BOOST_TEST((__to_chars(TO_DBL(-0.0)) == "-0"), "to_chars(double)");
+  BOOST_TEST((__to_chars(std::numeric_limits<double>::infinity()) == "inf"),
+             "to_chars(double)");
+  BOOST_TEST((__to_chars(std::numeric_limits<double>::quiet_NaN()) == "nan"),
+             "to_chars(double)");
+  BOOST_TEST((__to_chars(TO_LDBL(0.1L)) == "0.1"), "to_chars(long double)");
+  double __x = 1;
+  for (int __i = 0; __i < 1000; ++__i, __x *= -1.37) {
+    double __y = 0;
+    system::from_string(__to_chars(__x), __y);
+    BOOST_TEST((__x == __y), "to_chars(double)");
+  }
+
+  char __buf[8];
+  system::to_chars_result __r = system::to_chars(__buf, __buf + 8, 0.125);
+  BOOST_TEST((std::string(__buf, __r.ptr) == "0.125"), "to_chars(double)");
+  __r = system::to_chars(__buf, __buf + 8, 1.0 / 3);
+  BOOST_TEST((__r.ec == std::errc::value_too_large), "to_chars(double)");
+  BOOST_TEST((__r.ptr == __buf + 8), "to_chars(double)");
+
+  // MPFR values are not truncated at the highest precision
+  floatmp<TEUTHID_FLOATMP_MAX_PRECISION> __f1 = 1, __f2;
+  __f1 /= 3;
+  std::vector<char> __chars(1024);
+  __r = system::to_chars(__chars.data(), __chars.data() + __chars.size(), __f1);
+  BOOST_TEST((__r.ec == std::errc()), "to_chars(floatmp)");
+  system::from_string(std::string(__chars.data(), __r.ptr), __f2);
+  BOOST_TEST((mpfr_equal_p(__f1.c_mpfr(), __f2.c_mpfr()) != 0),
+             "to_chars(floatmp)");
+  system::format_float_output(700, false);
+  BOOST_TEST((system::to_string(__f1).size() == 702), "to_string(floatmp)");
+  system::format_float_output();
+  floatmp<100> __f3 = 2.5;
+  BOOST_TEST((__to_chars(__f3) == "2.5"), "to_chars(floatmp)");
+  __f3 = -0.0009765625;
+  BOOST_TEST((__to_chars(__f3) == "-0.0009765625"), "to_chars(floatmp)");
+}
+
+template <typename T>
+bool __from_chars(const char *s, T &x, std::errc ec = std::errc(),
+                  std::size_t n = std::string::npos) {
+  std::size_t __size = std::strlen(s);
+  system::from_chars_result __r = system::from_chars(s, s + __size, x);
+  return (__r.ec == ec) &&
+         (__r.ptr == s + ((n == std::string::npos) ? __size : n));
+}
+
+BOOST_AUTO_TEST_CASE(class_teuthid_system_from_chars) {
+  bool __b = false;
+  BOOST_TEST((__from_chars("true", __b) && __b), "from_chars(bool)");
+  BOOST_TEST((__from_chars("0,1", __b, std::errc(), 1) && !__b),
+             "from_chars(bool)");
+  BOOST_TEST(__from_chars("yes", __b, std::errc::invalid_argument, 0),
+             "from_chars(bool)");
+  BOOST_TEST((__from_chars("false;", __b, std::errc(), 5) && !__b),
+             "from_chars(bool)");
+  BOOST_TEST((__from_chars("TRUE", __b) && __b), "from_chars(bool)");
+  BOOST_TEST((__from_chars("False", __b) && !__b), "from_chars(bool)");
+  bool __bs = false;
+  system::from_string("TRUE", __bs);
+  BOOST_TEST((__from_chars("TRUE", __b) && (__b == __bs)), "from_chars(bool)");
+  const char *__word = "true";
+  system::from_chars_result __rb =
+      system::from_chars(__word, __word + 3, __b); // "tru"
+  BOOST_TEST(
+      ((__rb.ec == std::errc::invalid_argument) && (__rb.ptr == __word)),
+      "from_chars(bool)");
+
+  int8_t __i8 = 0;
+  BOOST_TEST((__from_chars("-128", __i8) && (__i8 == -128)),
+             "from_chars(int8_t)");
+  BOOST_TEST((__from_chars("128", __i8, std::errc::result_out_of_range) &&
+              (__i8 == -128)),
+             "from_chars(int8_t)");
+  BOOST_TEST(__from_chars("-", __i8, std::errc::invalid_argument, 0),
+             "from_chars(int8_t)");
+  BOOST_TEST(__from_chars(" 1", __i8, std::errc::invalid_argument, 0),
+             "from_chars(int8_t)");
+  uint16_t __u16 = 0;
+  BOOST_TEST((__from_chars("65535;", __u16, std::errc(), 5) &&
+              (__u16 == 65535)),
+             "from_chars(uint16_t)");
+  BOOST_TEST(__from_chars("-1", __u16, std::errc::invalid_argument, 0),
+             "from_chars(uint16_t)");
+  int64_t __i64 = 0;
+  BOOST_TEST((__from_chars("-9223372036854775808", __i64) &&
+              (__i64 == INT64_MIN)),
+             "from_chars(int64_t)");
+  BOOST_TEST(__from_chars("9223372036854775808", __i64,
+                          std::errc::result_out_of_range),
+             "from_chars(int64_t)");
+#ifdef TEUTHID_HAVE_INT_128
+  int128_t __i128 = 0;
+  BOOST_TEST((__from_chars("-170141183460469231731687303715884105728",
+                           __i128) &&
+              (__i128 == -TO_INT128(~TO_UINT128(0) >> 1) - 1)),
+             "from_chars(int128_t)");
+  uint128_t __u128 = 0;
+  BOOST_TEST((__from_chars("340282366920938463463374607431768211455",
+                           __u128) &&
+              (__u128 == ~TO_UINT128(0))),
+             "from_chars(uint128_t)");
+  BOOST_TEST(__from_chars("340282366920938463463374607431768211456", __u128,
+                          std::errc::result_out_of_range),
+             "from_chars(uint128_t)");
+#endif // TEUTHID_HAVE_INT_128
+
+  float __f = 0;
+  BOOST_TEST((__from_chars("0.1", __f) && (__f == 0.1f)), "from_chars(float)");
+  BOOST_TEST(__from_chars("1e39", __f, std::errc::result_out_of_range),
+             "from_chars(float)");
+  double __d = 0;
+  BOOST_TEST((__from_chars("-1.25e-3,", __d, std::errc(), 8) &&
+              (__d == -1.25e-3)),
+             "from_chars(double)");
+  BOOST_TEST((__from_chars("2.2250738585072014e-308", __d) &&
+              (__d == 2.2250738585072014e-308)),
+             "from_chars(double)");
+  BOOST_TEST((__from_chars("123456789012345678901234567890", __d) &&
+              (__d == 123456789012345678901234567890.0)),
+             "from_chars(double)");
+  BOOST_TEST((__from_chars(".5e", __d, std::errc(), 2) && (__d == 0.5)),
+             "from_chars(double)");
+  BOOST_TEST((__from_chars("-Infinity", __d) && std::isinf(__d) && (__d < 0)),
+             "from_chars(double)");
+  BOOST_TEST((__from_chars("nan(1)", __d) && std::isnan(__d)),
+             "from_chars(double)");
+  BOOST_TEST(__from_chars("1e400", __d, std::errc::result_out_of_range),
+             "from_chars(double)");
+  BOOST_TEST(__from_chars("e5", __d, std::errc::invalid_argument, 0),
+             "from_chars(double)");
+  BOOST_TEST(__from_chars("0x10", __d, std::errc(), 1), "from_chars(double)");
+  double __x = 1;
+  for (int __i = 0; __i < 1000; ++__i, __x *= -1.37) {
+    double __y = 0;
+    BOOST_TEST((__from_chars(__to_chars(__x).c_str(), __y) && (__x == __y)),
+               "from_chars(double)");
+  }
+  long double __ld = 0;
+  BOOST_TEST((__from_chars("0.1", __ld) && (__ld == 0.1L)),
+             "from_chars(long double)");
+
+  // the range is not required to be terminated
+  const char __chars[] = {'4', '2', '.', '5'};
+  BOOST_TEST(((system::from_chars(__chars, __chars + 2, __d).ptr ==
+               __chars + 2) &&
+              (__d == 42)),
+             "from_chars(double)");
+
+  floatmp<TEUTHID_FLOATMP_MAX_PRECISION> __f1 = 1, __f2;
+  __f1 /= 3;
+  std::vector<char> __buf(1024);
+  system::to_chars_result __r =
+      system::to_chars(__buf.data(), __buf.data() + __buf.size(), __f1);
+  BOOST_TEST(((system::from_chars(__buf.data(), __r.ptr, __f2).ptr ==
+               __r.ptr) &&
+              (mpfr_equal_p(__f1.c_mpfr(), __f2.c_mpfr()) != 0)),
+             "from_chars(floatmp)");
+  BOOST_TEST(__from_chars("1e99999999999999999999", __f2,
+                          std::errc::result_out_of_range),
+             "from_chars(floatmp)");
+  mpfr_t __mpfr;
+  mpfr_init2(__mpfr, 64);
+  BOOST_TEST((__from_chars("-2.5", __mpfr) && (mpfr_cmp_d(__mpfr, -2.5) == 0)),
+             "from_chars(mpfr_t)");
+  BOOST_TEST(__from_chars("+1", __mpfr, std::errc::invalid_argument, 0),
+             "from_chars(mpfr_t)");
+  mpfr_clear(__mpfr);
+}
+
+BOOST_AUTO_TEST_CASE(class_teuthid_system_comparison) {
+  typedef system::float_tolerance __tolerance_t;
+  // the default tolerance compares to 10 decimal places
+  BOOST_TEST(system::equal_to(1.0, 1.0 + 1e-11), "equal_to(double)");
+  BOOST_TEST(!system::equal_to(1.0, 1.0 + 1e-9), "equal_to(double)");
+  BOOST_TEST(system::is_zero(1e-12f), "is_zero(float)");
+  BOOST_TEST(!system::is_positive(TO_LDBL(1e-12)), "is_positive(long double)");
+  BOOST_TEST(system::is_negative(-1e-9), "is_negative(double)");
+  BOOST_TEST(!system::less_than(1.0, 1.0 + 1e-11), "less_than(double)");
+  BOOST_TEST(system::less_than(1.0, 1.0 + 1e-9), "less_than(double)");
+  double __inf = std::numeric_limits<double>::infinity();
+  double __nan = std::numeric_limits<double>::quiet_NaN();
+  BOOST_TEST(system::equal_to(__inf, __inf), "equal_to(double)");
+  BOOST_TEST(!system::equal_to(__inf, -__inf), "equal_to(double)");
+  BOOST_TEST(!system::equal_to(__nan, __nan), "equal_to(double)");
+  BOOST_TEST(!system::less_than(1.0, __inf), "less_than(double)");
+
+  // explicit tolerances
+  const __tolerance_t __exact = {0, 0, 0};
+  BOOST_TEST(system::is_close(0.1, 0.1, __exact), "is_close(double)");
+  BOOST_TEST(!system::is_close(1.0, std::nextafter(1.0, 2.0), __exact),
+             "is_close(double)");
+  const __tolerance_t __relative = {0, 1e-3, 0};
+  BOOST_TEST(system::is_close(1000.0f, 1000.5f, __relative), "is_close(float)");
+  BOOST_TEST(!system::is_close(1.0f, 1.5f, __relative), "is_close(float)");
+  const __tolerance_t __ulps = {0, 0, 4};
+  double __x = 1e300, __y = __x;
+  for (int __i = 0; __i < 4; ++__i)
+    __y = std::nextafter(__y, 2 * __x);
+  BOOST_TEST(system::is_close(__x, __y, __ulps), "is_close(double)");
+  BOOST_TEST(!system::is_close(__x, std::nextafter(__y, 2 * __x), __ulps),
+             "is_close(double)");
+  float __tiny = std::numeric_limits<float>::denorm_min();
+  BOOST_TEST(system::is_close(__tiny, 3 * __tiny, __ulps), "is_close(float)");
+  BOOST_TEST(system::is_close(__tiny, -__tiny, __ulps), "is_close(float)");
+  BOOST_TEST(!system::is_close(__inf, __inf, __ulps), "is_close(double)");
+#ifdef TEUTHID_HAVE_QUADMATH
+  BOOST_TEST(system::is_close(static_cast<__float128>(1),
+                              static_cast<__float128>(1) + 1e-20, __relative),
+             "is_close(__float128)");
+#endif // TEUTHID_HAVE_QUADMATH
+
+  // the current tolerance
+  __tolerance_t __prev = system::comparison_tolerance(__exact);
+  BOOST_TEST(!system::equal_to(1.0, 1.0 + 1e-11), "comparison_tolerance()");
+  BOOST_TEST(!system::is_zero(1e-12f), "comparison_tolerance()");
+  BOOST_TEST(!system::is_close(1.0, 1.0 + 1e-11), "comparison_tolerance()");
+  system::comparison_tolerance(__prev);
+  BOOST_TEST((system::comparison_tolerance().absolute ==
+              system::default_comparison_tolerance().absolute),
+             "comparison_tolerance()");
+
+  // arrays
+  std::vector<double> __a(1000), __b(1000);
+  for (std::size_t __i = 0; __i < __a.size(); ++__i)
+    __a[__i] = __b[__i] = static_cast<double>(__i) / 7;
+  BOOST_TEST(system::all_close(__a.data(), __b.data(), __a.size()),
+             "all_close(double)");
+  BOOST_TEST((system::count_equal(__a.data(), __b.data(), __a.size()) == 1000),
+             "count_equal(double)");
+  __b[999] = std::nextafter(__b[999], 1000.0);
+  __b[500] = __nan;
+  __b[3] += 1;
+  BOOST_TEST(!system::all_close(__a.data(), __b.data(), __a.size(), __exact),
+             "all_close(double)");
+  BOOST_TEST(
+      (system::count_equal(__a.data(), __b.data(), __a.size(), __exact) == 997),
+      "count_equal(double)");
+  BOOST_TEST((system::count_equal(__a.data(), __b.data(), __a.size(),
+                                  {0, 0, 1}) == 998),
+             "count_equal(double)");
+  BOOST_TEST(system::all_close(__a.data(), __b.data(), 500, {0, 0, 1}) ==
+                 false,
+             "all_close(double)");
+  BOOST_TEST(system::all_close(__a.data() + 4, __b.data() + 4, 496),
+             "all_close(double)");
+  BOOST_TEST(system::all_close(__a.data(), __b.data(), 0), "all_close()");
+
+  // mpfr_t
+  mpfr_t __m1, __m2;
+  mpfr_init2(__m1, 100);
+  mpfr_init2(__m2, 100);
+  mpfr_set_ui(__m1, 1, MPFR_RNDN);
+  mpfr_set_ui(__m2, 1, MPFR_RNDN);
+  mpfr_nextabove(__m2);
+  BOOST_TEST(system::equal_to(__m1, __m2), "equal_to(mpfr_t)");
+  BOOST_TEST(!system::less_than(__m1, __m2), "less_than(mpfr_t)");
+  BOOST_TEST(!system::is_close(__m1, __m2, __exact), "is_close(mpfr_t)");
+  BOOST_TEST(system::is_close(__m1, __m2, __ulps), "is_close(mpfr_t)");
+  mpfr_set_ui(__m2, 1001, MPFR_RNDN);
+  BOOST_TEST(system::is_close(__m2, __m1, {1000, 0, 0}), "is_close(mpfr_t)");
+  BOOST_TEST(system::is_close(__m2, __m1, {0, 0.9991L, 0}),
+             "is_close(mpfr_t)");
+  BOOST_TEST(!system::is_close(__m2, __m1, {0, 0.99L, 0}), "is_close(mpfr_t)");
+  BOOST_TEST(system::less_than(__m1, __m2), "less_than(mpfr_t)");
+
+  // floatmp as mpfr_t (operator== of floatmp stays exact)
+  floatmp<100> __f1(__m1), __f2 = 1;
+  __f2.nextabove(__f2);
+  mpfr_set_ui(__m2, 1, MPFR_RNDN);
+  mpfr_nextabove(__m2);
+  BOOST_TEST((system::equal_to(__f1, __f2) == system::equal_to(__m1, __m2)),
+             "equal_to(floatmp)");
+  BOOST_TEST(system::equal_to(__f1, __f2), "equal_to(floatmp)");
+  BOOST_TEST((__f1 != __f2), "operator!=(floatmp)");
+  BOOST_TEST(!system::less_than(__f1, __f2), "less_than(floatmp)");
+  BOOST_TEST(!system::is_close(__f1, __f2, __exact), "is_close(floatmp)");
+  BOOST_TEST(system::is_close(__f1, __f2), "is_close(floatmp)");
+  __f1 = 1e-12;
+  BOOST_TEST(system::is_zero(__f1), "is_zero(floatmp)");
+  BOOST_TEST(!system::is_positive(__f1), "is_positive(floatmp)");
+  BOOST_TEST(!system::is_negative(-__f1), "is_negative(floatmp)");
+  __f1 = -1e-9;
+  BOOST_TEST((!system::is_zero(__f1) && system::is_negative(__f1)),
+             "is_negative(floatmp)");
+  BOOST_TEST(system::less_than(__f1, __f2), "less_than(floatmp)");
+
+  // infinities are equal, but never close
+  mpfr_set_inf(__m1, 1);
+  mpfr_set_inf(__m2, 1);
+  BOOST_TEST(system::equal_to(__m1, __m2), "equal_to(mpfr_t)");
+  BOOST_TEST(!system::is_close(__m1, __m2, __ulps), "is_close(mpfr_t)");
+  __f1 = floatmp<100>::infinity();
+  __f2 = floatmp<100>::infinity();
+  BOOST_TEST((system::equal_to(__f1, __f2) == (__f1 == __f2)),
+             "equal_to(floatmp)");
+  BOOST_TEST(system::equal_to(__f1, __f2), "equal_to(floatmp)");
+  BOOST_TEST(!system::is_close(__f1, __f2), "is_close(floatmp)");
+  mpfr_clear(__m1);
+  mpfr_clear(__m2);
+}
+
+BOOST_AUTO_TEST_CASE(class_teuthid_system_float_format) {
+  typedef system::float_format __format_t;
+  double __x = 1.25;
+  floatmp<100> __f = 1.25;
+  system::format_float_output();
+  BOOST_TEST((system::to_string(__x, __format_t{3, true}) == "1.250e+00"),
+             "to_string(double, float_format)");
+  BOOST_TEST((system::to_string(__f, {1, false}) == "1.2"),
+             "to_string(floatmp, float_format)");
+  BOOST_TEST((system::to_string(__f * 2, {0, false}) == "2"),
+             "to_string(floatmp_expr, float_format)");
+  BOOST_TEST((system::to_string(__x) == "1.2500000000"), "to_string(double)");
+
+  {
+    system::float_format_scope __scope(2, true);
+    BOOST_TEST((__scope.previous().precision ==
+                system::default_format_float_precision()),
+               "float_format_scope::previous()");
+    BOOST_TEST((system::to_string(__x) == "1.25e+00"), "float_format_scope");
+    BOOST_TEST((system::to_string(1.25f) == "1.25e+00"), "float_format_scope");
+    BOOST_TEST((system::to_string(__f) == "1.25e+00"), "float_format_scope");
+    {
+      system::float_format_scope __inner(__format_t{1, false});
+      BOOST_TEST((system::to_string(__x) == "1.2"), "float_format_scope");
+    }
+    BOOST_TEST(system::float_output().scientific, "float_format_scope");
+    BOOST_TEST((system::float_output().precision == 2), "float_format_scope");
+  }
+  BOOST_TEST(!system::float_output().scientific, "float_format_scope");
+  BOOST_TEST((system::to_string(__x) == "1.2500000000"), "float_format_scope");
+
+  // the format belongs to the calling thread
+  std::string __other;
+  std::thread __th([&__x, &__other]() {
+    system::format_float_output(1, true);
+    __other = system::to_string(__x);
+  });
+  __th.join();
+  BOOST_TEST((__other == "1.2e+00"), "format_float_output()");
+  BOOST_TEST((system::to_string(__x) == "1.2500000000"),
+             "format_float_output()");
+}
+
+BOOST_AUTO_TEST_CASE(class_teuthid_system_cpu_features) {
+  const cpu_feature_t __features[] = {
+      cpu_feature_t::sse4_2,   cpu_feature_t::avx,      cpu_feature_t::avx2,
+      cpu_feature_t::fma,      cpu_feature_t::f16c,     cpu_feature_t::avx512f,
+      cpu_feature_t::avx512dq, cpu_feature_t::avx512cd, cpu_feature_t::avx512bw,
+      cpu_feature_t::avx512vl};
+  const char *__names[] = {"sse4.2",   "avx",      "avx2",     "fma",
+                           "f16c",     "avx512f",  "avx512dq", "avx512cd",
+                           "avx512bw", "avx512vl"};
+  std::vector<std::string> __list;
+  system::split_string(system::cpu_features(), __list);
+  for (std::size_t __i = 0; __i < 10; ++__i) {
+    bool __listed = std::find(__list.begin(), __list.end(), __names[__i]) !=
+                    __list.end();
+    BOOST_TEST((system::has_cpu_feature(__features[__i]) == __listed),
+               "cpu_features()");
+  }
+  if (system::has_cpu_feature(cpu_feature_t::avx2))
+    BOOST_TEST(system::has_cpu_feature(cpu_feature_t::avx), "has_cpu_feature()");
+  if (system::has_cpu_feature(cpu_feature_t::avx512vl))
+    BOOST_TEST(system::has_cpu_feature(cpu_feature_t::avx512f),
+               "has_cpu_feature()");
+#if defined(TEUTHID_HAVE_CPUID) && defined(__GNUC__)
+  __builtin_cpu_init();
+  BOOST_TEST((system::has_cpu_feature(cpu_feature_t::sse4_2) ==
+              (__builtin_cpu_supports("sse4.2") != 0)),
+             "has_cpu_feature(sse4_2)");
+  BOOST_TEST((system::has_cpu_feature(cpu_feature_t::avx2) ==
+              (__builtin_cpu_supports("avx2") != 0)),
+             "has_cpu_feature(avx2)");
+  BOOST_TEST((system::has_cpu_feature(cpu_feature_t::avx512f) ==
+              (__builtin_cpu_supports("avx512f") != 0)),
+             "has_cpu_feature(avx512f)");
+#endif
+
+  // the kernels selected for the CPU agree with a scalar loop
+  std::vector<float> __a(1027), __b(1027);
+  std::size_t __expected = 0;
+  for (std::size_t __i = 0; __i < __a.size(); ++__i) {
+    __a[__i] = static_cast<float>(__i) / 3;
+    __b[__i] = (__i % 5 == 0) ? __a[__i] + 1e-3f : __a[__i];
+    __expected += (__a[__i] == __b[__i]);
+  }
+  BOOST_TEST((system::count_equal(__a.data(), __b.data(), __a.size(),
+                                  {0, 0, 0}) == __expected),
+             "count_equal(float)");
+  BOOST_TEST((system::count_equal(__a.data(), __b.data(), __a.size(),
+                                  {1e-2L, 0, 0}) == __a.size()),
+             "count_equal(float)");
+}